@@ -45,6 +45,7 @@ enum {
     ERR_EDM_DEL_SUPER_ADMIN_FAILED,
     ERR_EDM_GET_ENTINFO_FAILED,
     ERR_EDM_SET_ENTINFO_FAILED,
+    ERR_EDM_SUBSCRIBE_ADMIN_CHANGE_FAILED,
 };
 
 // Error code for ADMINMGR: 0x2020000,value:33685504
@@ -56,6 +57,7 @@ enum {
     ERR_EDM_DENY_ADMIN = EDM_ADMINMGR_ERR_OFFSET + 0x0003,
     ERR_EDM_DENY_PERMISSION = EDM_ADMINMGR_ERR_OFFSET + 0x0004,
     ERR_EDM_UNKNOWN_ADMIN = EDM_ADMINMGR_ERR_OFFSET + 0x0005,
+    ERR_EDM_WRITE_ADMIN_RECORD_FAILED = EDM_ADMINMGR_ERR_OFFSET + 0x0006,
 };
 
 // Error code for POLICYMGR: 0x2030000,value:33751040
@@ -68,6 +70,8 @@ enum {
     ERR_EDM_POLICY_SET_FAILED = EDM_POLICYMGR_ERR_OFFSET + 5,
     ERR_EDM_POLICY_NOT_FOUND = EDM_POLICYMGR_ERR_OFFSET + 6,
     ERR_EDM_POLICY_DEL_FAILED = EDM_POLICYMGR_ERR_OFFSET + 7,
+    ERR_EDM_POLICY_WRITE_JOURNAL_FAILED = EDM_POLICYMGR_ERR_OFFSET + 8,
+    ERR_EDM_POLICY_NOT_MODIFIED = EDM_POLICYMGR_ERR_OFFSET + 9,
 };
 
 // Error code for POLICYMGR: 0x2040000,value:33816576
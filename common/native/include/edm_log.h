@@ -42,6 +42,11 @@ static constexpr OHOS::HiviewDFX::HiLogLabel EDM_LABEL = { LOG_CORE, LOG_DOMAIN_
 #ifndef EDMLOGW
 #define EDMLOGW(...) (void)OHOS::HiviewDFX::HiLog::Warn(EDM_LABEL, __VA_ARGS__)
 #endif
+
+/* guards the debug output which is expensive to format, EDMLOGD alone only skips the write */
+#ifndef EDMLOG_DEBUG_ENABLED
+#define EDMLOG_DEBUG_ENABLED() HiLogIsLoggable(LOG_DOMAIN_ID_EDM, EDM_LABEL.tag, LOG_DEBUG)
+#endif
 } // namespace EDM
 } // namespace OHOS
 #endif // COMMON_NATIVE_INCLUDE_EDM_LOG_H_
@@ -44,6 +44,7 @@ enum class FuncOperateType {
     GET = 0,
     SET = 1,
     REMOVE = 2,
+    GET_IF_MODIFIED = 3,
     UNKNOWN = 0xF,
 };
 
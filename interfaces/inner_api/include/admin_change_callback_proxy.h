@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INTERFACES_INNER_API_INCLUDE_ADMIN_CHANGE_CALLBACK_PROXY_H_
+#define INTERFACES_INNER_API_INCLUDE_ADMIN_CHANGE_CALLBACK_PROXY_H_
+#include "iadmin_change_callback.h"
+#include "iremote_proxy.h"
+
+namespace OHOS {
+namespace EDM {
+class AdminChangeCallbackProxy : public IRemoteProxy<IAdminChangeCallback> {
+public:
+    explicit AdminChangeCallbackProxy(const sptr<IRemoteObject> &impl);
+    ~AdminChangeCallbackProxy() override = default;
+    void OnAdminChanged(const std::vector<AdminChangeEvent> &events) override;
+
+private:
+    static inline BrokerDelegator<AdminChangeCallbackProxy> delegator_;
+};
+} // namespace EDM
+} // namespace OHOS
+#endif // INTERFACES_INNER_API_INCLUDE_ADMIN_CHANGE_CALLBACK_PROXY_H_
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INTERFACES_INNER_API_INCLUDE_ADMIN_CHANGE_EVENT_H_
+#define INTERFACES_INNER_API_INCLUDE_ADMIN_CHANGE_EVENT_H_
+
+#include <string>
+#include "admin_type.h"
+#include "parcel.h"
+
+namespace OHOS {
+namespace EDM {
+enum AdminChangeType : uint32_t {
+    ADMIN_ACTIVATED = 0,
+    ADMIN_DEACTIVATED,
+    ADMIN_ENT_INFO_CHANGED,
+    ADMIN_CHANGE_UNKNOWN,
+};
+
+/*
+ * The change of one admin sent to the subscribers of IEnterpriseDeviceMgr::SubscribeAdminChange.
+ */
+struct AdminChangeEvent : public Parcelable {
+    AdminChangeEvent();
+    ~AdminChangeEvent();
+
+    AdminChangeType changeType = AdminChangeType::ADMIN_CHANGE_UNKNOWN;
+    std::string bundleName;
+    std::string abilityName;
+    AdminType adminType = AdminType::UNKNOWN;
+    int32_t userId = 0;
+    bool ReadFromParcel(Parcel &parcel);
+    virtual bool Marshalling(Parcel &parcel) const override;
+    static AdminChangeEvent *Unmarshalling(Parcel &parcel);
+};
+} // namespace EDM
+} // namespace OHOS
+
+#endif // INTERFACES_INNER_API_INCLUDE_ADMIN_CHANGE_EVENT_H_
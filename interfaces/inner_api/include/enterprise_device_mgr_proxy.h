@@ -21,6 +21,7 @@
 #include <mutex>
 #include <string>
 #include <vector>
+#include "iadmin_change_callback.h"
 #include "ienterprise_device_mgr.h"
 
 namespace OHOS {
@@ -41,6 +42,8 @@ public:
     bool IsSuperAdmin(std::string bundleName);
     bool IsAdminActive(AppExecFwk::ElementName &admin);
     bool HandleDevicePolicy(int32_t policyCode, MessageParcel &data);
+    ErrCode SubscribeAdminChange(const sptr<IAdminChangeCallback> &callback);
+    ErrCode UnsubscribeAdminChange(const sptr<IAdminChangeCallback> &callback);
 
     void GetActiveSuperAdmin(std::string &activeAdmin);
     bool IsSuperAdminExist();
@@ -51,12 +54,26 @@ public:
     bool GetPolicyConfig(int policyCode, std::map<std::string, std::string> &policyData);
 
 private:
+    /*
+     * The last reply of a policy and its generation, the service only sends the policy again
+     * when its generation changed.
+     */
+    struct PolicyCacheEntry {
+        std::uint64_t generation = 0;
+        bool found = false;
+        std::vector<std::uint8_t> payload;
+    };
+
     static std::shared_ptr<EnterpriseDeviceMgrProxy> instance_;
     static std::mutex mutexLock_;
+    std::map<int, PolicyCacheEntry> policyCache_;
+    std::mutex policyCacheLock_;
 
     void GetActiveAdmins(std::uint32_t type, std::vector<std::string> &activeAdminList);
     sptr<IRemoteObject> GetRemoteObject();
     bool GetPolicy(int policyCode, MessageParcel &reply);
+    bool ReadCachedPolicy(int policyCode, MessageParcel &reply);
+    void SaveCachedPolicy(int policyCode, std::uint64_t generation, bool found, MessageParcel &reply);
 };
 } // namespace EDM
 } // namespace OHOS
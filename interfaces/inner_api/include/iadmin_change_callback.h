@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INTERFACES_INNER_API_INCLUDE_IADMIN_CHANGE_CALLBACK_H_
+#define INTERFACES_INNER_API_INCLUDE_IADMIN_CHANGE_CALLBACK_H_
+#include <vector>
+#include "admin_change_event.h"
+#include "iremote_broker.h"
+
+namespace OHOS {
+namespace EDM {
+/*
+ * Callback registered through IEnterpriseDeviceMgr::SubscribeAdminChange, the service delivers the
+ * admin changes in coalesced batches.
+ */
+class IAdminChangeCallback : public IRemoteBroker {
+public:
+    DECLARE_INTERFACE_DESCRIPTOR(u"ohos.edm.IAdminChangeCallback");
+    virtual void OnAdminChanged(const std::vector<AdminChangeEvent> &events) = 0;
+    enum {
+        ON_ADMIN_CHANGED = 1,
+    };
+};
+} // namespace EDM
+} // namespace OHOS
+#endif // INTERFACES_INNER_API_INCLUDE_IADMIN_CHANGE_CALLBACK_H_
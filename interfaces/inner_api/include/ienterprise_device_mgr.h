@@ -36,11 +36,15 @@ public:
     virtual ErrCode DeactiveSuperAdmin(std::string &bundleName) = 0;
     virtual ErrCode HandleDevicePolicy(uint32_t code, AppExecFwk::ElementName &admin, MessageParcel &data) = 0;
     virtual ErrCode GetDevicePolicy(uint32_t code, AppExecFwk::ElementName *admin, MessageParcel &reply) = 0;
-    virtual ErrCode GetActiveAdmin(AdminType type, std::vector<std::string> &activeAdminList) = 0;
+    virtual ErrCode GetDevicePolicyIfModified(uint32_t code, AppExecFwk::ElementName *admin,
+        std::uint64_t generation, MessageParcel &reply) = 0;
+    virtual ErrCode GetActiveAdmin(AdminType type, std::vector<std::u16string> &activeAdminList) = 0;
     virtual ErrCode GetEnterpriseInfo(AppExecFwk::ElementName &admin, MessageParcel &reply) = 0;
     virtual ErrCode SetEnterpriseInfo(AppExecFwk::ElementName &admin, EntInfo &entInfo) = 0;
     virtual bool IsSuperAdmin(std::string &bundleName) = 0;
     virtual bool IsAdminActive(AppExecFwk::ElementName &admin) = 0;
+    virtual ErrCode SubscribeAdminChange(const sptr<IRemoteObject> &callback) = 0;
+    virtual ErrCode UnsubscribeAdminChange(const sptr<IRemoteObject> &callback) = 0;
     enum {
         ADD_DEVICE_ADMIN = 1,
         REMOVE_DEVICE_ADMIN = 2,
@@ -51,6 +55,8 @@ public:
         SET_ENT_INFO = 7,
         IS_SUPER_ADMIN = 8,
         IS_ADMIN_ACTIVE = 9,
+        SUBSCRIBE_ADMIN_CHANGE = 10,
+        UNSUBSCRIBE_ADMIN_CHANGE = 11,
     };
 };
 } // namespace EDM
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "admin_change_callback_proxy.h"
+#include "edm_log.h"
+#include "message_parcel.h"
+
+namespace OHOS {
+namespace EDM {
+AdminChangeCallbackProxy::AdminChangeCallbackProxy(const sptr<IRemoteObject> &impl)
+    : IRemoteProxy<IAdminChangeCallback>(impl)
+{}
+
+void AdminChangeCallbackProxy::OnAdminChanged(const std::vector<AdminChangeEvent> &events)
+{
+    sptr<IRemoteObject> remote = Remote();
+    if (!remote) {
+        EDMLOGE("AdminChangeCallbackProxy::OnAdminChanged remote is null");
+        return;
+    }
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option(MessageOption::TF_ASYNC);
+    if (!data.WriteInterfaceToken(GetDescriptor()) || !data.WriteUint32(events.size())) {
+        EDMLOGE("AdminChangeCallbackProxy::OnAdminChanged write parcel fail");
+        return;
+    }
+    for (const auto &event : events) {
+        if (!data.WriteParcelable(&event)) {
+            EDMLOGE("AdminChangeCallbackProxy::OnAdminChanged write event fail");
+            return;
+        }
+    }
+    ErrCode res = remote->SendRequest(ON_ADMIN_CHANGED, data, reply, option);
+    if (FAILED(res)) {
+        EDMLOGW("AdminChangeCallbackProxy::OnAdminChanged send request fail. %{public}d", res);
+    }
+}
+} // namespace EDM
+} // namespace OHOS
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "admin_change_callback_stub.h"
+#include <memory>
+#include "edm_errors.h"
+#include "edm_log.h"
+#include "message_parcel.h"
+
+namespace OHOS {
+namespace EDM {
+namespace {
+constexpr uint32_t MAX_EVENT_COUNT = 1000;
+}
+
+int32_t AdminChangeCallbackStub::OnRemoteRequest(uint32_t code, MessageParcel &data, MessageParcel &reply,
+    MessageOption &option)
+{
+    if (data.ReadInterfaceToken() != GetDescriptor()) {
+        EDMLOGE("AdminChangeCallbackStub code %{public}u descriptors are inconsistent", code);
+        return ERR_EDM_PARAM_ERROR;
+    }
+    if (code != ON_ADMIN_CHANGED) {
+        return IPCObjectStub::OnRemoteRequest(code, data, reply, option);
+    }
+    uint32_t count = data.ReadUint32();
+    if (count > MAX_EVENT_COUNT) {
+        EDMLOGE("AdminChangeCallbackStub too many events %{public}u", count);
+        return ERR_EDM_PARAM_ERROR;
+    }
+    std::vector<AdminChangeEvent> events;
+    events.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        std::unique_ptr<AdminChangeEvent> event(data.ReadParcelable<AdminChangeEvent>());
+        if (!event) {
+            EDMLOGE("AdminChangeCallbackStub read event fail");
+            return ERR_EDM_PARAM_ERROR;
+        }
+        events.push_back(*event);
+    }
+    OnAdminChanged(events);
+    return ERR_OK;
+}
+} // namespace EDM
+} // namespace OHOS
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "admin_change_event.h"
+#include "edm_log.h"
+#include "parcel_macro.h"
+
+namespace OHOS {
+namespace EDM {
+AdminChangeEvent::AdminChangeEvent() {}
+
+AdminChangeEvent::~AdminChangeEvent() {}
+
+bool AdminChangeEvent::Marshalling(Parcel &parcel) const
+{
+    WRITE_PARCEL_AND_RETURN_FALSE_IF_FAIL(Uint32, parcel, changeType);
+    WRITE_PARCEL_AND_RETURN_FALSE_IF_FAIL(String, parcel, bundleName);
+    WRITE_PARCEL_AND_RETURN_FALSE_IF_FAIL(String, parcel, abilityName);
+    WRITE_PARCEL_AND_RETURN_FALSE_IF_FAIL(Uint32, parcel, adminType);
+    WRITE_PARCEL_AND_RETURN_FALSE_IF_FAIL(Int32, parcel, userId);
+    return true;
+}
+
+AdminChangeEvent *AdminChangeEvent::Unmarshalling(Parcel &parcel)
+{
+    auto *event = new (std::nothrow) AdminChangeEvent();
+    if (event && !event->ReadFromParcel(parcel)) {
+        EDMLOGW("read from parcel failed");
+        delete event;
+        event = nullptr;
+    }
+    return event;
+}
+
+bool AdminChangeEvent::ReadFromParcel(Parcel &parcel)
+{
+    uint32_t type = 0;
+    READ_PARCEL_AND_RETURN_FALSE_IF_FAIL(Uint32, parcel, type);
+    if (type >= AdminChangeType::ADMIN_CHANGE_UNKNOWN) {
+        EDMLOGW("AdminChangeEvent unknown change type %{public}u", type);
+        return false;
+    }
+    changeType = static_cast<AdminChangeType>(type);
+    READ_PARCEL_AND_RETURN_FALSE_IF_FAIL(String, parcel, bundleName);
+    READ_PARCEL_AND_RETURN_FALSE_IF_FAIL(String, parcel, abilityName);
+    READ_PARCEL_AND_RETURN_FALSE_IF_FAIL(Uint32, parcel, type);
+    adminType = (type < AdminType::UNKNOWN) ? static_cast<AdminType>(type) : AdminType::UNKNOWN;
+    READ_PARCEL_AND_RETURN_FALSE_IF_FAIL(Int32, parcel, userId);
+    return true;
+}
+} // namespace EDM
+} // namespace OHOS
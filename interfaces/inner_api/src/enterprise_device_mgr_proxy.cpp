@@ -260,6 +260,62 @@ bool EnterpriseDeviceMgrProxy::IsAdminActive(AppExecFwk::ElementName &admin)
     return ret;
 }
 
+ErrCode EnterpriseDeviceMgrProxy::SubscribeAdminChange(const sptr<IAdminChangeCallback> &callback)
+{
+    EDMLOGD("EnterpriseDeviceMgrProxy::SubscribeAdminChange");
+    if (callback == nullptr) {
+        return ERR_EDM_PARAM_ERROR;
+    }
+    sptr<IRemoteObject> remote = GetRemoteObject();
+    if (!remote) {
+        return ERR_EDM_SERVICE_NOT_READY;
+    }
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    data.WriteInterfaceToken(DESCRIPTOR);
+    data.WriteRemoteObject(callback->AsObject());
+    ErrCode res = remote->SendRequest(IEnterpriseDeviceMgr::SUBSCRIBE_ADMIN_CHANGE, data, reply, option);
+    if (FAILED(res)) {
+        EDMLOGE("EnterpriseDeviceMgrProxy:SubscribeAdminChange send request fail. %{public}d", res);
+        return ERR_EDM_SERVICE_NOT_READY;
+    }
+    int32_t resCode = ERR_EDM_SUBSCRIBE_ADMIN_CHANGE_FAILED;
+    if (!reply.ReadInt32(resCode) || FAILED(resCode)) {
+        EDMLOGW("EnterpriseDeviceMgrProxy:SubscribeAdminChange get result code fail. %{public}d", resCode);
+        return resCode;
+    }
+    return ERR_OK;
+}
+
+ErrCode EnterpriseDeviceMgrProxy::UnsubscribeAdminChange(const sptr<IAdminChangeCallback> &callback)
+{
+    EDMLOGD("EnterpriseDeviceMgrProxy::UnsubscribeAdminChange");
+    if (callback == nullptr) {
+        return ERR_EDM_PARAM_ERROR;
+    }
+    sptr<IRemoteObject> remote = GetRemoteObject();
+    if (!remote) {
+        return ERR_EDM_SERVICE_NOT_READY;
+    }
+    MessageParcel data;
+    MessageParcel reply;
+    MessageOption option;
+    data.WriteInterfaceToken(DESCRIPTOR);
+    data.WriteRemoteObject(callback->AsObject());
+    ErrCode res = remote->SendRequest(IEnterpriseDeviceMgr::UNSUBSCRIBE_ADMIN_CHANGE, data, reply, option);
+    if (FAILED(res)) {
+        EDMLOGE("EnterpriseDeviceMgrProxy:UnsubscribeAdminChange send request fail. %{public}d", res);
+        return ERR_EDM_SERVICE_NOT_READY;
+    }
+    int32_t resCode = ERR_EDM_PARAM_ERROR;
+    if (!reply.ReadInt32(resCode) || FAILED(resCode)) {
+        EDMLOGW("EnterpriseDeviceMgrProxy:UnsubscribeAdminChange get result code fail. %{public}d", resCode);
+        return resCode;
+    }
+    return ERR_OK;
+}
+
 bool EnterpriseDeviceMgrProxy::IsPolicyDisable(int policyCode, bool &isDisabled)
 {
     MessageParcel reply;
@@ -366,13 +422,24 @@ bool EnterpriseDeviceMgrProxy::GetPolicy(int policyCode, MessageParcel &reply)
         EDMLOGE("EnterpriseDeviceMgrProxy:GetPolicy invalid policyCode:%{public}d", policyCode);
         return false;
     }
-    std::uint32_t funcCode = POLICY_FUNC_CODE((std::uint32_t)FuncOperateType::GET, (std::uint32_t)policyCode);
+    std::uint32_t funcCode = POLICY_FUNC_CODE((std::uint32_t)FuncOperateType::GET_IF_MODIFIED,
+        (std::uint32_t)policyCode);
     sptr<IRemoteObject> remote = GetRemoteObject();
     if (!remote) {
         return false;
     }
+    std::uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(policyCacheLock_);
+        auto iter = policyCache_.find(policyCode);
+        if (iter != policyCache_.end()) {
+            generation = iter->second.generation;
+        }
+    }
     MessageParcel data;
     data.WriteInterfaceToken(DESCRIPTOR);
+    data.WriteInt32(ERR_OK);
+    data.WriteUint64(generation);
     MessageOption option;
     ErrCode res = remote->SendRequest(funcCode, data, reply, option);
     if (FAILED(res)) {
@@ -380,11 +447,51 @@ bool EnterpriseDeviceMgrProxy::GetPolicy(int policyCode, MessageParcel &reply)
         return false;
     }
     std::int32_t requestRes = ERR_INVALID_VALUE;
-    bool blRes = reply.ReadInt32(requestRes) && (requestRes == ERR_OK);
-    if (!blRes) {
+    std::uint64_t replyGeneration = 0;
+    if (!reply.ReadInt32(requestRes) || !reply.ReadUint64(replyGeneration)) {
+        EDMLOGW("EnterpriseDeviceMgrProxy:GetPolicy read reply fail.");
+        return false;
+    }
+    if (requestRes == ERR_EDM_POLICY_NOT_MODIFIED) {
+        return ReadCachedPolicy(policyCode, reply);
+    }
+    SaveCachedPolicy(policyCode, replyGeneration, requestRes == ERR_OK, reply);
+    if (requestRes != ERR_OK) {
         EDMLOGW("EnterpriseDeviceMgrProxy:GetPolicy fail. %{public}d", requestRes);
+        return false;
     }
-    return blRes;
+    return true;
+}
+
+bool EnterpriseDeviceMgrProxy::ReadCachedPolicy(int policyCode, MessageParcel &reply)
+{
+    std::lock_guard<std::mutex> lock(policyCacheLock_);
+    auto iter = policyCache_.find(policyCode);
+    if (iter == policyCache_.end()) {
+        EDMLOGW("EnterpriseDeviceMgrProxy:GetPolicy cached policy not found.");
+        return false;
+    }
+    /* another thread may have saved a newer reply in between, it is as good as the confirmed one */
+    if (!iter->second.found) {
+        return false;
+    }
+    /* the policy is appended after the header already read, the caller reads it from the same parcel */
+    return reply.WriteBuffer(iter->second.payload.data(), iter->second.payload.size());
+}
+
+void EnterpriseDeviceMgrProxy::SaveCachedPolicy(int policyCode, std::uint64_t generation, bool found,
+    MessageParcel &reply)
+{
+    PolicyCacheEntry entry;
+    entry.generation = generation;
+    entry.found = found;
+    if (found) {
+        const std::uint8_t *data = reinterpret_cast<const std::uint8_t *>(reply.GetData());
+        entry.payload.assign(data + reply.GetReadPosition(), data + reply.GetDataSize());
+    }
+    /* an older reply saved last only costs one more transfer, the service compares the generations for equality */
+    std::lock_guard<std::mutex> lock(policyCacheLock_);
+    policyCache_[policyCode] = std::move(entry);
 }
 
 void EnterpriseDeviceMgrProxy::GetActiveAdmins(std::vector<std::string> &activeAdminList)
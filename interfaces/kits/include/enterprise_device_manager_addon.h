@@ -16,6 +16,8 @@
 #ifndef INTERFACES_KITS_INCLUDE_ENTERPRISE_DEVICE_MANAGER_ADDON_H_
 #define INTERFACES_KITS_INCLUDE_ENTERPRISE_DEVICE_MANAGER_ADDON_H_
 
+#include <vector>
+#include "admin_change_callback_stub.h"
 #include "admin_type.h"
 #include "device_settings_manager.h"
 #include "edm_errors.h"
@@ -27,6 +29,7 @@
 #include "napi/native_node_api.h"
 #include "napi/native_api.h"
 #include "ohos/aafwk/content/want.h"
+#include "uv.h"
 
 namespace OHOS {
 namespace EDM {
@@ -84,6 +87,32 @@ struct AsyncGetDeviceSettingsManagerCallbackInfo : AsyncCallbackInfo {
     napi_ref callback = 0;
 };
 
+/*
+ * The admin change callback of the js listeners registered by on('adminChange'), the events received on
+ * the ipc thread are passed to the js thread of env through the uv loop.
+ */
+class NapiAdminChangeCallback : public AdminChangeCallbackStub {
+public:
+    explicit NapiAdminChangeCallback(napi_env env) : env_(env) {}
+    ~NapiAdminChangeCallback() = default;
+    void OnAdminChanged(const std::vector<AdminChangeEvent> &events) override;
+    void AddListener(napi_value listener);
+    void RemoveListener(napi_value listener);
+    void ClearListeners();
+    bool HasListener();
+
+private:
+    struct AdminChangeWork {
+        sptr<NapiAdminChangeCallback> callback;
+        std::vector<AdminChangeEvent> events;
+    };
+
+    static void CallListeners(uv_work_t *work, int status);
+    napi_value CreateEventArray(const std::vector<AdminChangeEvent> &events);
+    napi_env env_;
+    std::vector<napi_ref> listeners_;
+};
+
 class EnterpriseDeviceManagerAddon {
 public:
     EnterpriseDeviceManagerAddon();
@@ -104,6 +133,8 @@ public:
     static std::string GetStringFromNAPI(napi_env env, napi_value value);
     static napi_value GetDeviceSettingsManager(napi_env env, napi_callback_info info);
     static napi_value SetDateTime(napi_env env, napi_callback_info info);
+    static napi_value On(napi_env env, napi_callback_info info);
+    static napi_value Off(napi_env env, napi_callback_info info);
 
     static void NativeActivateAdmin(napi_env env, void *data);
     static void NativeDeactivateSuperAdmin(napi_env env, void *data);
@@ -125,6 +156,7 @@ public:
     static napi_value ParseStringArray(napi_env env, std::vector<std::string> &hapFiles, napi_value args);
     static bool MatchValueType(napi_env env, napi_value value, napi_valuetype targetType);
     static void CreateAdminTypeObject(napi_env env, napi_value value);
+    static void CreateAdminChangeTypeObject(napi_env env, napi_value value);
     static napi_value CreateUndefined(napi_env env);
     static napi_value ParseInt(napi_env env, int32_t &param, napi_value args);
     static napi_value ParseLong(napi_env env, int64_t &param, napi_value args);
@@ -134,6 +166,7 @@ public:
 private:
     static std::shared_ptr<EnterpriseDeviceMgrProxy> proxy_;
     static std::shared_ptr<DeviceSettingsManager> deviceSettingsManager_;
+    static thread_local sptr<NapiAdminChangeCallback> adminChangeCallback_;
 };
 } // namespace EDM
 } // namespace OHOS
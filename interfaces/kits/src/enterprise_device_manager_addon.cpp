@@ -39,11 +39,14 @@ constexpr int32_t NAPI_RETURN_ZERO = 0;
 constexpr int32_t NAPI_RETURN_ONE = 1;
 
 constexpr int32_t DEFAULT_USER_ID = 100;
+
+const std::string ADMIN_CHANGE_EVENT_TYPE = "adminChange";
 }
 
 std::shared_ptr<EnterpriseDeviceMgrProxy> EnterpriseDeviceManagerAddon::proxy_ = nullptr;
 std::shared_ptr<DeviceSettingsManager> EnterpriseDeviceManagerAddon::deviceSettingsManager_ = nullptr;
 thread_local napi_ref EnterpriseDeviceManagerAddon::g_classDeviceSettingsManager;
+thread_local sptr<NapiAdminChangeCallback> EnterpriseDeviceManagerAddon::adminChangeCallback_ = nullptr;
 
 napi_value EnterpriseDeviceManagerAddon::ActivateAdmin(napi_env env, napi_callback_info info)
 {
@@ -772,11 +775,200 @@ napi_value EnterpriseDeviceManagerAddon::GetDeviceSettingsManager(napi_env env,
     }
 }
 
+void NapiAdminChangeCallback::OnAdminChanged(const std::vector<AdminChangeEvent> &events)
+{
+    uv_loop_s *loop = nullptr;
+    napi_get_uv_event_loop(env_, &loop);
+    if (loop == nullptr) {
+        EDMLOGE("OnAdminChanged: can not get uv loop");
+        return;
+    }
+    auto work = std::make_unique<uv_work_t>();
+    work->data = new (std::nothrow) AdminChangeWork {this, events};
+    if (work->data == nullptr) {
+        return;
+    }
+    int ret = uv_queue_work(loop, work.get(), [](uv_work_t *work) {}, CallListeners);
+    if (ret != 0) {
+        EDMLOGE("OnAdminChanged: uv_queue_work failed %{public}d", ret);
+        delete static_cast<AdminChangeWork *>(work->data);
+        return;
+    }
+    work.release();
+}
+
+void NapiAdminChangeCallback::CallListeners(uv_work_t *work, int status)
+{
+    std::unique_ptr<uv_work_t> workPtr(work);
+    std::unique_ptr<AdminChangeWork> data(static_cast<AdminChangeWork *>(work->data));
+    NapiAdminChangeCallback *callback = data->callback.GetRefPtr();
+    napi_handle_scope scope = nullptr;
+    napi_open_handle_scope(callback->env_, &scope);
+    if (scope == nullptr) {
+        return;
+    }
+    napi_value events = callback->CreateEventArray(data->events);
+    napi_value undefined = EnterpriseDeviceManagerAddon::CreateUndefined(callback->env_);
+    // a listener may call off() from inside, so call the listeners registered before the dispatch
+    std::vector<napi_ref> listeners = callback->listeners_;
+    for (napi_ref ref : listeners) {
+        napi_value listener = nullptr;
+        napi_value callResult = nullptr;
+        napi_get_reference_value(callback->env_, ref, &listener);
+        if (listener != nullptr) {
+            napi_call_function(callback->env_, undefined, listener, ARGS_SIZE_ONE, &events, &callResult);
+        }
+    }
+    napi_close_handle_scope(callback->env_, scope);
+}
+
+napi_value NapiAdminChangeCallback::CreateEventArray(const std::vector<AdminChangeEvent> &events)
+{
+    napi_value result = nullptr;
+    napi_create_array_with_length(env_, events.size(), &result);
+    for (size_t i = 0; i < events.size(); ++i) {
+        napi_value object = nullptr;
+        napi_value value = nullptr;
+        napi_create_object(env_, &object);
+        napi_create_int32(env_, static_cast<int32_t>(events[i].changeType), &value);
+        napi_set_named_property(env_, object, "type", value);
+        napi_create_string_utf8(env_, events[i].bundleName.c_str(), NAPI_AUTO_LENGTH, &value);
+        napi_set_named_property(env_, object, "bundleName", value);
+        napi_create_string_utf8(env_, events[i].abilityName.c_str(), NAPI_AUTO_LENGTH, &value);
+        napi_set_named_property(env_, object, "abilityName", value);
+        napi_create_int32(env_, static_cast<int32_t>(events[i].adminType), &value);
+        napi_set_named_property(env_, object, "adminType", value);
+        napi_create_int32(env_, events[i].userId, &value);
+        napi_set_named_property(env_, object, "userId", value);
+        napi_set_element(env_, result, i, object);
+    }
+    return result;
+}
+
+void NapiAdminChangeCallback::AddListener(napi_value listener)
+{
+    for (napi_ref ref : listeners_) {
+        napi_value item = nullptr;
+        bool isEqual = false;
+        napi_get_reference_value(env_, ref, &item);
+        napi_strict_equals(env_, item, listener, &isEqual);
+        if (isEqual) {
+            return;
+        }
+    }
+    napi_ref ref = nullptr;
+    napi_create_reference(env_, listener, NAPI_RETURN_ONE, &ref);
+    listeners_.push_back(ref);
+}
+
+void NapiAdminChangeCallback::RemoveListener(napi_value listener)
+{
+    for (auto iter = listeners_.begin(); iter != listeners_.end(); ++iter) {
+        napi_value item = nullptr;
+        bool isEqual = false;
+        napi_get_reference_value(env_, *iter, &item);
+        napi_strict_equals(env_, item, listener, &isEqual);
+        if (isEqual) {
+            napi_delete_reference(env_, *iter);
+            listeners_.erase(iter);
+            return;
+        }
+    }
+}
+
+void NapiAdminChangeCallback::ClearListeners()
+{
+    for (napi_ref ref : listeners_) {
+        napi_delete_reference(env_, ref);
+    }
+    listeners_.clear();
+}
+
+bool NapiAdminChangeCallback::HasListener()
+{
+    return !listeners_.empty();
+}
+
+napi_value EnterpriseDeviceManagerAddon::On(napi_env env, napi_callback_info info)
+{
+    EDMLOGI("NAPI_On called");
+    size_t argc = ARGS_SIZE_TWO;
+    napi_value argv[ARGS_SIZE_TWO] = {nullptr};
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr));
+    NAPI_ASSERT(env, argc == ARGS_SIZE_TWO, "parameter count error");
+    std::string type;
+    ParseString(env, type, argv[ARR_INDEX_ZERO]);
+    NAPI_ASSERT(env, type == ADMIN_CHANGE_EVENT_TYPE, "event type error");
+    NAPI_ASSERT(env, MatchValueType(env, argv[ARR_INDEX_ONE], napi_function), "parameter type error");
+    if (adminChangeCallback_ == nullptr) {
+        adminChangeCallback_ = new (std::nothrow) NapiAdminChangeCallback(env);
+        NAPI_ASSERT(env, adminChangeCallback_ != nullptr, "create callback failed");
+    }
+    bool subscribed = adminChangeCallback_->HasListener();
+    adminChangeCallback_->AddListener(argv[ARR_INDEX_ONE]);
+    if (!subscribed) {
+        auto proxy = EnterpriseDeviceMgrProxy::GetInstance();
+        ErrCode ret = (proxy == nullptr) ? ERR_EDM_SERVICE_NOT_READY :
+            proxy->SubscribeAdminChange(adminChangeCallback_);
+        if (FAILED(ret)) {
+            EDMLOGE("NAPI_On SubscribeAdminChange failed %{public}d", ret);
+            adminChangeCallback_->ClearListeners();
+            napi_throw(env, CreateErrorMessage(env, "subscribe admin change failed"));
+            return nullptr;
+        }
+    }
+    return CreateUndefined(env);
+}
+
+napi_value EnterpriseDeviceManagerAddon::Off(napi_env env, napi_callback_info info)
+{
+    EDMLOGI("NAPI_Off called");
+    size_t argc = ARGS_SIZE_TWO;
+    napi_value argv[ARGS_SIZE_TWO] = {nullptr};
+    NAPI_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr));
+    NAPI_ASSERT(env, argc == ARGS_SIZE_ONE || argc == ARGS_SIZE_TWO, "parameter count error");
+    std::string type;
+    ParseString(env, type, argv[ARR_INDEX_ZERO]);
+    NAPI_ASSERT(env, type == ADMIN_CHANGE_EVENT_TYPE, "event type error");
+    if (adminChangeCallback_ == nullptr || !adminChangeCallback_->HasListener()) {
+        return CreateUndefined(env);
+    }
+    if (argc == ARGS_SIZE_TWO) {
+        NAPI_ASSERT(env, MatchValueType(env, argv[ARR_INDEX_ONE], napi_function), "parameter type error");
+        adminChangeCallback_->RemoveListener(argv[ARR_INDEX_ONE]);
+    } else {
+        adminChangeCallback_->ClearListeners();
+    }
+    if (!adminChangeCallback_->HasListener()) {
+        auto proxy = EnterpriseDeviceMgrProxy::GetInstance();
+        if (proxy != nullptr) {
+            proxy->UnsubscribeAdminChange(adminChangeCallback_);
+        }
+    }
+    return CreateUndefined(env);
+}
+
+void EnterpriseDeviceManagerAddon::CreateAdminChangeTypeObject(napi_env env, napi_value value)
+{
+    napi_value nActivated;
+    NAPI_CALL_RETURN_VOID(env, napi_create_int32(env, AdminChangeType::ADMIN_ACTIVATED, &nActivated));
+    NAPI_CALL_RETURN_VOID(env, napi_set_named_property(env, value, "ADMIN_ACTIVATED", nActivated));
+    napi_value nDeactivated;
+    NAPI_CALL_RETURN_VOID(env, napi_create_int32(env, AdminChangeType::ADMIN_DEACTIVATED, &nDeactivated));
+    NAPI_CALL_RETURN_VOID(env, napi_set_named_property(env, value, "ADMIN_DEACTIVATED", nDeactivated));
+    napi_value nEntInfoChanged;
+    NAPI_CALL_RETURN_VOID(env, napi_create_int32(env, AdminChangeType::ADMIN_ENT_INFO_CHANGED, &nEntInfoChanged));
+    NAPI_CALL_RETURN_VOID(env, napi_set_named_property(env, value, "ADMIN_ENT_INFO_CHANGED", nEntInfoChanged));
+}
+
 napi_value EnterpriseDeviceManagerAddon::Init(napi_env env, napi_value exports)
 {
     napi_value nAdminType = nullptr;
     NAPI_CALL(env, napi_create_object(env, &nAdminType));
     CreateAdminTypeObject(env, nAdminType);
+    napi_value nAdminChangeType = nullptr;
+    NAPI_CALL(env, napi_create_object(env, &nAdminChangeType));
+    CreateAdminChangeTypeObject(env, nAdminChangeType);
 
     napi_property_descriptor property[] = {
         DECLARE_NAPI_FUNCTION("activateAdmin", ActivateAdmin),
@@ -787,8 +979,11 @@ napi_value EnterpriseDeviceManagerAddon::Init(napi_env env, napi_value exports)
         DECLARE_NAPI_FUNCTION("setEnterpriseInfo", SetEnterpriseInfo),
         DECLARE_NAPI_FUNCTION("isSuperAdmin", IsSuperAdmin),
         DECLARE_NAPI_FUNCTION("getDeviceSettingsManager", GetDeviceSettingsManager),
+        DECLARE_NAPI_FUNCTION("on", On),
+        DECLARE_NAPI_FUNCTION("off", Off),
 
         DECLARE_NAPI_PROPERTY("AdminType", nAdminType),
+        DECLARE_NAPI_PROPERTY("AdminChangeType", nAdminChangeType),
     };
     NAPI_CALL(env, napi_define_properties(env, exports, sizeof(property) / sizeof(property[0]), property));
 
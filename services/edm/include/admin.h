@@ -21,6 +21,7 @@
 #include "ability_info.h"
 #include "admin_type.h"
 #include "edm_errors.h"
+#include "edm_permission.h"
 #include "ent_info.h"
 #include "parcel_macro.h"
 
@@ -32,11 +33,14 @@ struct AdminInfo {
     std::string className_;
     EntInfo entInfo_;
     std::vector<std::string> permission_;
+    /* the ids of permission_ used by the permission checks, the names are kept to be saved and dumped */
+    PermissionBits permissionBits_;
 };
 
 class Admin {
 public:
     virtual bool CheckPermission(const std::string &permission);
+    bool CheckPermissionId(std::uint32_t permissionId);
     virtual AdminType GetAdminType();
     virtual ~Admin() = default;
     AdminInfo adminInfo_;
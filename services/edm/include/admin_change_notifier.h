@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SERVICES_EDM_INCLUDE_ADMIN_CHANGE_NOTIFIER_H_
+#define SERVICES_EDM_INCLUDE_ADMIN_CHANGE_NOTIFIER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "admin_change_event.h"
+#include "edm_errors.h"
+#include "iremote_object.h"
+
+namespace OHOS {
+namespace EDM {
+/*
+ * Delivers the admin changes to the callbacks subscribed through IEnterpriseDeviceMgr::SubscribeAdminChange.
+ *
+ * Notify only queues the event, a worker thread sends the queued events in one batch once no event was
+ * queued for the quiet window, or at the latest the max delay after the first queued event. The events
+ * of the same admin are merged in the queue, so a burst of changes costs one oneway call per subscriber.
+ * A subscriber receives the changes of the admins of its own user and of the super admins. Subscribers
+ * whose process died are removed by their death recipient.
+ */
+class AdminChangeNotifier {
+public:
+    AdminChangeNotifier();
+    ~AdminChangeNotifier();
+
+    /*
+     * Subscribe the admin changes, subscribing the same callback again only updates its user.
+     *
+     * @param callback the remote object of an IAdminChangeCallback
+     * @param userId the user of the subscriber
+     * @return return thr ErrCode of this function
+     */
+    ErrCode Subscribe(const sptr<IRemoteObject> &callback, int32_t userId);
+
+    /*
+     * Unsubscribe the admin changes.
+     *
+     * @param callback the remote object passed to Subscribe
+     * @return return thr ErrCode of this function
+     */
+    ErrCode Unsubscribe(const sptr<IRemoteObject> &callback);
+
+    /*
+     * Queue the change of an admin, dropped if there is no subscriber.
+     *
+     * @param event the change of the admin
+     */
+    void Notify(const AdminChangeEvent &event);
+
+    /*
+     * Set how long the events are held back before delivery.
+     *
+     * @param quietWindowMs the events are sent when no event was queued for this long
+     * @param maxDelayMs the events are sent at the latest this long after the first one was queued
+     */
+    void SetCoalescing(uint32_t quietWindowMs, uint32_t maxDelayMs);
+
+    size_t GetSubscriberCount();
+
+private:
+    class SubscriberDeathRecipient : public IRemoteObject::DeathRecipient {
+    public:
+        explicit SubscriberDeathRecipient(AdminChangeNotifier &notifier) : notifier_(notifier) {}
+        void OnRemoteDied(const wptr<IRemoteObject> &remote) override;
+
+    private:
+        AdminChangeNotifier &notifier_;
+    };
+
+    struct Subscriber {
+        sptr<IRemoteObject> callback;
+        int32_t userId = 0;
+    };
+
+    void Run();
+    void Deliver(const std::vector<AdminChangeEvent> &events, const std::vector<Subscriber> &subscribers);
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::vector<Subscriber> subscribers_;
+    std::vector<AdminChangeEvent> pending_;
+    std::chrono::steady_clock::time_point firstPendingTime_;
+    std::chrono::steady_clock::time_point lastPendingTime_;
+    std::chrono::milliseconds quietWindow_;
+    std::chrono::milliseconds maxDelay_;
+    sptr<SubscriberDeathRecipient> deathRecipient_;
+    std::thread worker_;
+    bool stopped_ = false;
+};
+} // namespace EDM
+} // namespace OHOS
+
+#endif // SERVICES_EDM_INCLUDE_ADMIN_CHANGE_NOTIFIER_H_
@@ -16,9 +16,16 @@
 #ifndef SERVICES_EDM_INCLUDE_ADMIN_MANAGER_H_
 #define SERVICES_EDM_INCLUDE_ADMIN_MANAGER_H_
 
+#include <array>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "admin.h"
+#include "admin_record_store.h"
 #include "ent_info.h"
 #include "edm_permission.h"
 #include "json/json.h"
@@ -26,35 +33,132 @@
 
 namespace OHOS {
 namespace EDM {
+using AdminList = std::vector<std::shared_ptr<Admin>>;
+/* the "package/class" names of the admins of one type, in the form written to the ipc reply */
+using ActiveAdminList = std::vector<std::u16string>;
+/* the user of the super admin, the admins of a request without a user belong to it too */
+constexpr int32_t DEFAULT_USER_ID = 100;
+
+/*
+ * The admins published by AdminManager. The list keeps the activation order, the index maps the package
+ * name to the position in the list and the count of the super admins is kept up to date on every change.
+ */
+struct AdminTable {
+    AdminList admins;
+    std::unordered_map<std::string, std::size_t> index;
+    std::size_t superAdminCount = 0;
+    /* the active admin list of every admin type, rebuilt only when the admin set changes */
+    std::array<std::shared_ptr<const ActiveAdminList>, AdminType::UNKNOWN> activeAdmins;
+};
+
+/* user id and the admin table of the user, only the users in use are loaded */
+using AdminTableMap = std::unordered_map<int32_t, std::shared_ptr<const AdminTable>>;
+
+/*
+ * The admins are partitioned by user, every user has its own admin table and record file. The table of
+ * a user is loaded on its first use and unloaded when the user is stopped, a user without a record file
+ * has no admins and is only loaded when its first admin is activated. DEFAULT_USER_ID is never unloaded,
+ * it has the super admin, the admins activated by the kit which passes no user of its own and the admins
+ * saved before the partitioning. Its admins are admins of every user, a lookup of another user falls back
+ * to them.
+ * The published admin tables are immutable, the query api reads them without any lock and a change is
+ * made on a copy of the table and of the changed admin under adminsMutex_, then published atomically.
+ * Every change appends the record of the changed admin to the AdminRecordStore of the user, the record
+ * file is compacted once most of its records are replaced or removed.
+ */
 class AdminManager : public std::enable_shared_from_this<AdminManager> {
 public:
     static std::shared_ptr<AdminManager> GetInstance();
     ErrCode GetReqPermission(const std::vector<std::string> &permissions, std::vector<EdmPermission> &edmPermissions);
-    void GetAllAdmin(std::vector<std::shared_ptr<Admin>> &allAdmin);
-    std::shared_ptr<Admin> GetAdminByPkgName(const std::string &packageName);
-    ErrCode DeleteAdmin(const std::string &packageName);
-    ErrCode UpdateAdmin(AppExecFwk::AbilityInfo &abilityInfo, const std::vector<std::string> &permissions);
+    void GetAllAdmin(std::vector<std::shared_ptr<Admin>> &allAdmin, int32_t userId = DEFAULT_USER_ID);
+    std::shared_ptr<Admin> GetAdminByPkgName(const std::string &packageName, int32_t userId = DEFAULT_USER_ID);
+    ErrCode DeleteAdmin(const std::string &packageName, int32_t userId = DEFAULT_USER_ID);
+    ErrCode UpdateAdmin(AppExecFwk::AbilityInfo &abilityInfo, const std::vector<std::string> &permissions,
+        int32_t userId = DEFAULT_USER_ID);
     ErrCode GetGrantedPermission(AppExecFwk::AbilityInfo &abilityInfo, std::vector<std::string> &permissions,
         AdminType type);
     bool IsSuperAdminExist();
-    void GetActiveAdmin(AdminType role, std::vector<std::string> &packageNameList);
+
+    /*
+     * Check if the package is an admin of a user other than userId, the record files of the users not
+     * loaded are read without loading the users.
+     *
+     * @param packageName the package name of the admin
+     * @param role the admin type the package is activated as
+     * @param userId the id of the user the package is activated for
+     * @return return true if another user has the package as its admin
+     */
+    bool IsAdminOfOtherUser(const std::string &packageName, AdminType role, int32_t userId);
+    void GetActiveAdmin(AdminType role, std::vector<std::string> &packageNameList, int32_t userId = DEFAULT_USER_ID);
+
+    /*
+     * Get the cached active admin list of the admin type, the super admins are those of DEFAULT_USER_ID and
+     * the normal admins of another user are listed after the normal admins of DEFAULT_USER_ID.
+     *
+     * @param role the admin type
+     * @param userId the id of the user
+     * @return return the active admin list, it is never changed once returned
+     */
+    std::shared_ptr<const ActiveAdminList> GetActiveAdminList(AdminType role, int32_t userId = DEFAULT_USER_ID);
     void Init();
     void RestoreAdminFromFile();
     ErrCode SetAdminValue(AppExecFwk::AbilityInfo &abilityInfo, EntInfo &entInfo, AdminType role,
-        std::vector<std::string> &permissions);
-    ErrCode GetEntInfo(const std::string &packageName, EntInfo &entInfo);
-    ErrCode SetEntInfo(const std::string &packageName, EntInfo &entInfo);
+        std::vector<std::string> &permissions, int32_t userId = DEFAULT_USER_ID);
+    ErrCode GetEntInfo(const std::string &packageName, EntInfo &entInfo, int32_t userId = DEFAULT_USER_ID);
+    ErrCode SetEntInfo(const std::string &packageName, EntInfo &entInfo, int32_t userId = DEFAULT_USER_ID);
+
+    /*
+     * Load the admins of the user if they are not loaded yet, it is called when the user is switched to.
+     *
+     * @param userId the id of the user
+     */
+    void LoadUser(int32_t userId);
+
+    /*
+     * Release the admins of the stopped user, they are loaded again from the file on the next use.
+     * The admins of DEFAULT_USER_ID are never released.
+     *
+     * @param userId the id of the user
+     */
+    void UnloadUser(int32_t userId);
+
+    /*
+     * Get the users whose admins are loaded.
+     *
+     * @param userIds the ids of the loaded users
+     */
+    void GetLoadedUsers(std::vector<int32_t> &userIds);
+    std::uint64_t GetPersistedBytes();
     virtual ~AdminManager();
     
 private:
     AdminManager();
-    void SaveAdmin();
-    void ReadJsonAdminType(Json::Value &admin);
-    void ReadJsonAdmin(const std::string &filePath);
-    void WriteJsonAdminType(std::shared_ptr<Admin> &activeAdmin, Json::Value &tree);
-    void WriteJsonAdmin(const std::string &filePath);
+    static std::shared_ptr<Admin> CreateAdmin(AdminType role);
+    static void PutAdmin(AdminTable &table, std::shared_ptr<Admin> admin);
+    static bool EraseAdmin(AdminTable &table, const std::string &packageName);
+    static void BuildActiveAdmins(AdminTable &table);
+    static std::string GetRecordPath(int32_t userId);
+    static void GetRecordUsers(std::vector<int32_t> &userIds);
+    AdminType ReadAdminRole(int32_t userId, const std::string &packageName);
+    std::shared_ptr<const AdminTable> LoadAdmins(int32_t userId);
+    std::shared_ptr<const AdminTable> FindUserLocked(int32_t userId);
+    std::shared_ptr<const AdminTable> LoadUserLocked(int32_t userId);
+    int32_t FindAdminUserLocked(const std::string &packageName, int32_t userId);
+    void PublishAdmins(int32_t userId, std::shared_ptr<const AdminTable> admins);
+    ErrCode UpdateAdminInfo(const std::string &packageName, int32_t userId,
+        const std::function<void(AdminInfo &)> &update);
+    ErrCode SaveAdmin(int32_t userId, const AdminTable &admins, const std::string &packageName);
+    ErrCode CompactAdmin(int32_t userId, const AdminTable &admins);
+    std::shared_ptr<Admin> ReadJsonAdminType(Json::Value &admin);
+    void ReadJsonAdmin(const std::string &filePath, AdminTable &admins);
+    void ReadAdminRecord(const AdminRecord &record, AdminTable &admins);
+    void WriteJsonAdminType(const std::shared_ptr<Admin> &activeAdmin, Json::Value &tree);
+    std::string WriteAdminRecord(const std::shared_ptr<Admin> &activeAdmin);
 
-    std::vector<std::shared_ptr<Admin>> admins_;
+    std::shared_ptr<const AdminTableMap> admins_;
+    std::mutex adminsMutex_;
+    /* user id and the record file of the loaded users, they are only used while holding adminsMutex_ */
+    std::unordered_map<int32_t, std::unique_ptr<AdminRecordStore>> recordStores_;
     static std::mutex mutexLock_;
     static std::shared_ptr<AdminManager> instance_;
 };
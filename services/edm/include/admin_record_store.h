@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SERVICES_EDM_INCLUDE_EDM_ADMIN_RECORD_STORE_H_
+#define SERVICES_EDM_INCLUDE_EDM_ADMIN_RECORD_STORE_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "edm_errors.h"
+
+namespace OHOS {
+namespace EDM {
+/*
+ * One admin saved by AdminRecordStore, an empty data is the tombstone of a removed admin.
+ */
+struct AdminRecord {
+    std::string packageName;
+    std::string data;
+};
+
+/*
+ * This class is the append-only record file of AdminManager. Adding, changing or removing an admin
+ * appends one record, so the io of a change only depends on the size of the admin. The records are
+ * stored as [length][crc32][payload] like PolicyJournal, a torn record at the end of the file is
+ * dropped when it is loaded. Compact replaces the file with the live admins atomically, the file is
+ * written aside and renamed over the old one.
+ */
+class AdminRecordStore {
+public:
+    explicit AdminRecordStore(const std::string &path);
+    ~AdminRecordStore();
+
+    /*
+     * Check if the record file exists.
+     *
+     * @return return true if the record file exists
+     */
+    bool IsCreated();
+
+    /*
+     * Replay the records in the order they were appended and open the file for appending.
+     *
+     * @param apply the function called for every record
+     * @return return thr ErrCode of this function
+     */
+    ErrCode Load(const std::function<void(const AdminRecord &)> &apply);
+
+    /*
+     * Replay the complete records without changing the file, a torn record at the end is skipped.
+     *
+     * @param apply the function called for every record
+     * @return return thr ErrCode of this function
+     */
+    ErrCode Read(const std::function<void(const AdminRecord &)> &apply) const;
+
+    /*
+     * Append one record and flush it to the storage device.
+     *
+     * @param record the record to append, a record with an empty data removes the admin
+     * @return return thr ErrCode of this function
+     */
+    ErrCode Put(const AdminRecord &record);
+
+    /*
+     * Replace the record file with one record per live admin.
+     *
+     * @param records the records of the live admins in their order
+     * @return return thr ErrCode of this function
+     */
+    ErrCode Compact(const std::vector<AdminRecord> &records);
+
+    /*
+     * Get the count of the records in the file, including the replaced records and the tombstones.
+     *
+     * @return return the count of the records
+     */
+    std::uint64_t GetRecordCount();
+
+    /*
+     * Get the bytes written to the record file, including the compactions.
+     *
+     * @return return the total bytes written since the store is created
+     */
+    std::uint64_t GetWrittenBytes();
+
+private:
+    ErrCode Open();
+    void Close();
+    ErrCode Replay(const std::function<void(const AdminRecord &)> &apply, std::uint64_t &recordCount,
+        std::size_t &tornPos) const;
+
+    std::string path_;
+    int fd_ = -1;
+    std::uint64_t recordCount_ = 0;
+    std::uint64_t writtenBytes_ = 0;
+};
+} // namespace EDM
+} // namespace OHOS
+
+#endif // SERVICES_EDM_INCLUDE_EDM_ADMIN_RECORD_STORE_H_
@@ -16,12 +16,20 @@
 #ifndef SERVICES_EDM_INCLUDE_EDM_PERMISSION_H_
 #define SERVICES_EDM_INCLUDE_EDM_PERMISSION_H_
 
+#include <bitset>
+#include <cstdint>
 #include <string>
 #include "admin_type.h"
 #include "parcel.h"
 
 namespace OHOS {
 namespace EDM {
+/* the max count of the permissions known by PermissionManager, a permission id is smaller than it */
+constexpr std::size_t EDM_MAX_PERMISSION_NUM = 64;
+constexpr std::uint32_t EDM_INVALID_PERMISSION_ID = static_cast<std::uint32_t>(EDM_MAX_PERMISSION_NUM);
+/* the permissions granted to an admin, the bit of a permission is its id */
+using PermissionBits = std::bitset<EDM_MAX_PERMISSION_NUM>;
+
 class EdmPermission : public Parcelable {
 public:
     EdmPermission();
@@ -16,17 +16,55 @@
 #ifndef SERVICES_EDM_INCLUDE_EDM_ENTERPRISE_DEVICE_MGR_ABILITY_H_
 #define SERVICES_EDM_INCLUDE_EDM_ENTERPRISE_DEVICE_MGR_ABILITY_H_
 
+#include <array>
 #include <bundle_mgr_interface.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "admin_change_notifier.h"
 #include "admin_manager.h"
+#include "common_event_manager.h"
+#include "common_event_support.h"
 #include "enterprise_device_mgr_stub.h"
 #include "hilog/log.h"
+#include "lock_stats.h"
 #include "plugin_manager.h"
 #include "policy_manager.h"
+#include "policy_reply_cache.h"
 #include "system_ability.h"
 
 namespace OHOS {
 namespace EDM {
+/*
+ * Receives the user events, the admins of a user are loaded when the user is switched to and released
+ * when the user is stopped.
+ */
+class EnterpriseDeviceEventSubscriber : public EventFwk::CommonEventSubscriber {
+public:
+    EnterpriseDeviceEventSubscriber(const EventFwk::CommonEventSubscribeInfo &subscribeInfo,
+        std::shared_ptr<AdminManager> adminMgr);
+    ~EnterpriseDeviceEventSubscriber() = default;
+    void OnReceiveEvent(const EventFwk::CommonEventData &data) override;
+
+private:
+    std::shared_ptr<AdminManager> adminMgr_;
+};
+
+/*
+ * Lock domains of the ability, always taken in this order:
+ * 1. adminLock_: exclusive while an admin is activated, deactivated or its enterprise info is set,
+ *    shared while a policy of an admin is handled, so the admin can't be removed halfway.
+ * 2. policyLocks_: the lock of one policy code, serializes the read-modify-write of that policy.
+ *    A thread holds at most one policy lock.
+ * 3. the locks inside PolicyManager and AdminManager.
+ * The query api (IsSuperAdmin, IsAdminActive, GetDevicePolicy, ...) takes none of them and reads
+ * the lists published by PolicyManager and AdminManager.
+ */
 class EnterpriseDeviceMgrAbility : public SystemAbility, public EnterpriseDeviceMgrStub {
     DECLARE_SYSTEM_ABILITY(EnterpriseDeviceMgrAbility);
 
@@ -42,35 +80,86 @@ public:
     ErrCode DeactiveSuperAdmin(std::string &bundleName) override;
     ErrCode HandleDevicePolicy(uint32_t code, AppExecFwk::ElementName &admin, MessageParcel &data) override;
     ErrCode GetDevicePolicy(uint32_t code, AppExecFwk::ElementName *admin, MessageParcel &reply) override;
-    ErrCode GetActiveAdmin(AdminType type, std::vector<std::string> &activeAdminList) override;
+    ErrCode GetDevicePolicyIfModified(uint32_t code, AppExecFwk::ElementName *admin, std::uint64_t generation,
+        MessageParcel &reply) override;
+    ErrCode GetActiveAdmin(AdminType type, std::vector<std::u16string> &activeAdminList) override;
     ErrCode GetEnterpriseInfo(AppExecFwk::ElementName &admin, MessageParcel &reply) override;
     ErrCode SetEnterpriseInfo(AppExecFwk::ElementName &admin, EntInfo &entInfo) override;
     bool IsSuperAdmin(std::string &bundleName) override;
     bool IsAdminActive(AppExecFwk::ElementName &admin) override;
+    ErrCode SubscribeAdminChange(const sptr<IRemoteObject> &callback) override;
+    ErrCode UnsubscribeAdminChange(const sptr<IRemoteObject> &callback) override;
+    int32_t OnRemoteRequest(uint32_t code, MessageParcel &data, MessageParcel &reply,
+        MessageOption &option) override;
+    int Dump(int fd, const std::vector<std::u16string> &args) override;
 
 protected:
     void OnDump() override;
     void OnStart() override;
     void OnStop() override;
+    void OnAddSystemAbility(int32_t systemAbilityId, const std::string &deviceId) override;
 
 private:
     bool IsHdc();
     ErrCode CheckPermission();
     ErrCode CheckCallingUid(std::string &bundleName);
-    ErrCode RemoveAdminItem(std::string adminName, std::string policyName, std::string policyValue);
-    ErrCode RemoveAdmin(const std::string &adminName);
+    ErrCode RemoveAdminItem(std::string adminName, std::string policyName, std::string policyValue,
+        PolicyTransaction &transaction);
+    ErrCode RemoveAdmin(const std::string &adminName, int32_t userId);
     ErrCode GetAllPermissionsByAdmin(const std::string& bundleInfoName,
         std::vector<std::string> &permissionList, int32_t userId);
     ErrCode UpdateDeviceAdmin(AppExecFwk::ElementName &admin);
-    ErrCode VerifyActiveAdminCondition(AppExecFwk::ElementName &admin, AdminType type);
+    ErrCode VerifyActiveAdminCondition(AppExecFwk::ElementName &admin, AdminType type, int32_t userId);
+    int32_t GetCallingUserId();
+    void NotifyAdminChange(AdminChangeType changeType, const std::string &bundleName, const std::string &abilityName,
+        AdminType adminType, int32_t userId);
+    void SubscribeUserEvent();
     bool VerifyCallingPermission(const std::string &permissionName);
     sptr<OHOS::AppExecFwk::IBundleMgr> GetBundleMgr();
+    std::mutex &GetPolicyLock(uint32_t policyCode);
+    ErrCode GetCombinedPolicy(const std::shared_ptr<IPlugin> &plugin, MessageParcel &reply);
+    ErrCode GetEncodedCombinedPolicy(const std::shared_ptr<IPlugin> &plugin, PolicyReply &encodedPolicy,
+        std::uint64_t &policyGeneration);
+    void InitManagers();
+    void RecordStartupStage(const std::string &stage, std::chrono::steady_clock::time_point begin);
+    void WaitReady();
+    static constexpr size_t POLICY_LOCK_NUM = 32;
     static std::mutex mutexLock_;
     static sptr<EnterpriseDeviceMgrAbility> instance_;
     std::shared_ptr<PolicyManager> policyMgr_;
     std::shared_ptr<AdminManager> adminMgr_;
     std::shared_ptr<PluginManager> pluginMgr_;
     bool registerToService_ = false;
+    std::shared_ptr<EnterpriseDeviceEventSubscriber> userEventSubscriber_;
+    std::shared_mutex adminLock_;
+    std::array<std::mutex, POLICY_LOCK_NUM> policyLocks_;
+    LockStats adminLockStats_ {"admin"};
+    LockStats policyLockStats_ {"policy"};
+    PolicyReplyCache replyCache_;
+    AdminChangeNotifier adminChangeNotifier_;
+
+    /*
+     * The readiness latch, requests received before the managers are initialized wait on readyCond_
+     */
+    std::mutex readyMutex_;
+    std::condition_variable readyCond_;
+    bool ready_ = false;
+    bool firstRequestRecorded_ = false;
+
+    /*
+     * The thread initializing the managers, started by the first OnStart after the service is published
+     */
+    std::thread startupThread_;
+
+    /*
+     * The startup stage name and wall time in milliseconds pairs, protected by readyMutex_
+     */
+    std::vector<std::pair<std::string, int64_t>> startupStages_;
+
+    /*
+     * The resident set size when the service became ready, protected by readyMutex_
+     */
+    int64_t readyRssKb_ = -1;
 };
 } // namespace EDM
 } // namespace OHOS
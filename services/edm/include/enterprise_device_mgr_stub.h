@@ -38,12 +38,15 @@ private:
     ErrCode DeactiveSuperAdminInner(MessageParcel &data, MessageParcel &reply);
     ErrCode HandleDevicePolicyInner(uint32_t code, MessageParcel &data, MessageParcel &reply);
     ErrCode GetDevicePolicyInner(uint32_t code, MessageParcel &data, MessageParcel &reply);
+    ErrCode GetDevicePolicyIfModifiedInner(uint32_t code, MessageParcel &data, MessageParcel &reply);
     ErrCode GetReqEdmPermissionsInner(MessageParcel &data, MessageParcel &reply);
     ErrCode GetActiveAdminInner(MessageParcel &data, MessageParcel &reply);
     ErrCode GetEnterpriseInfoInner(MessageParcel &data, MessageParcel &reply);
     ErrCode SetEnterpriseInfoInner(MessageParcel &data, MessageParcel &reply);
     ErrCode IsSuperAdminInner(MessageParcel &data, MessageParcel &reply);
     ErrCode IsAdminActiveInner(MessageParcel &data, MessageParcel &reply);
+    ErrCode SubscribeAdminChangeInner(MessageParcel &data, MessageParcel &reply);
+    ErrCode UnsubscribeAdminChangeInner(MessageParcel &data, MessageParcel &reply);
 };
 } // namespace EDM
 } // namespace OHOS
@@ -20,6 +20,7 @@
 #include <map>
 #include <string>
 #include "edm_errors.h"
+#include "edm_permission.h"
 #include "func_code_utils.h"
 #include "message_parcel.h"
 
@@ -56,12 +57,16 @@ public:
     bool NeedSavePolicy();
     bool IsGlobalPolicy();
     std::string GetPermission();
+    std::uint32_t GetPermissionId();
+    void SetPermissionId(std::uint32_t permissionId);
     virtual ~IPlugin();
 
 protected:
     std::uint32_t policyCode_;
     std::string policyName_;
     std::string permission_;
+    /* the id of permission_ assigned by PermissionManager when the plugin is added */
+    std::uint32_t permissionId_ = EDM_INVALID_PERMISSION_ID;
     bool needSave_ = true;
     bool isGlobal_ = true;
 };
@@ -464,7 +464,7 @@ void IPluginTemplate<CT, DT>::SetOnHandlePolicyListener(BiFunction &&listener, F
 template<class CT, class DT>
 ErrCode IPluginTemplate<CT, DT>::MergePolicyData(const std::string &adminName, std::string &policyData)
 {
-    AdminValueItemsMap adminValues;
+    AdminValueViewMap adminValues;
     PolicyManager::GetInstance()->GetAdminByPolicyName(GetPolicyName(), adminValues);
     EDMLOGD("IPluginTemplate::MergePolicyData %{public}s value size %{public}d.",
         GetPolicyName().c_str(), (uint32_t)adminValues.size());
@@ -483,8 +483,8 @@ ErrCode IPluginTemplate<CT, DT>::MergePolicyData(const std::string &adminName, s
     std::vector<DT> data;
     for (const auto &item : adminValues) {
         DT dataItem;
-        if (!item.second.empty()) {
-            if (!serializer_->Deserialize(item.second, dataItem)) {
+        if (!item.second->empty()) {
+            if (!serializer_->Deserialize(*item.second, dataItem)) {
                 return ERR_EDM_OPERATE_JSON;
             }
             data.push_back(dataItem);
@@ -670,14 +670,14 @@ ErrCode IPluginTemplate<CT, DT>::WritePolicyToParcel(const std::string &policyDa
 template<class CT, class DT>
 bool IPluginTemplate<CT, DT>::GetMergePolicyData(DT &policyData)
 {
-    AdminValueItemsMap adminValues;
+    AdminValueViewMap adminValues;
     PolicyManager::GetInstance()->GetAdminByPolicyName(GetPolicyName(), adminValues);
     if (adminValues.empty()) {
         return true;
     }
     if (adminValues.size() == 1) {
         for (const auto &item : adminValues) {
-            if (!serializer_->Deserialize(item.second, policyData)) {
+            if (!serializer_->Deserialize(*item.second, policyData)) {
                 return false;
             } else {
                 return true;
@@ -687,7 +687,7 @@ bool IPluginTemplate<CT, DT>::GetMergePolicyData(DT &policyData)
         std::vector<DT> adminValueArray;
         for (const auto &item : adminValues) {
             DT dataItem;
-            if (!serializer_->Deserialize(item.second, dataItem)) {
+            if (!serializer_->Deserialize(*item.second, dataItem)) {
                 return false;
             }
             adminValueArray.push_back(dataItem);
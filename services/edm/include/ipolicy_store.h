@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SERVICES_EDM_INCLUDE_EDM_IPOLICY_STORE_H_
+#define SERVICES_EDM_INCLUDE_EDM_IPOLICY_STORE_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "edm_errors.h"
+#include "policy_journal.h"
+#include "policy_value.h"
+
+namespace OHOS {
+namespace EDM {
+using PolicyDeltaHandler = std::function<void(const PolicyJournalRecord &record)>;
+
+/*
+ * This class is the storage backend of PolicyManager. A store keeps a base version of the policies
+ * and the changes applied after it, Flush replaces the base version and drops the changes.
+ * PolicyManager calls a store from one thread at a time, a store writing in the background
+ * synchronizes its background work with its own calls.
+ */
+class IPolicyStore {
+public:
+    virtual ~IPolicyStore() = default;
+
+    /*
+     * Load the base version of the policies, the admin index of the table is built by the caller.
+     *
+     * @param table the table to add the policies to, the admins of the table may be left lazy
+     * @param sequence the sequence of the last change contained in the base version
+     * @param needFlush set to true if the policies must be flushed to complete the load
+     * @return return thr ErrCode of this function
+     */
+    virtual ErrCode Load(PolicyTable &table, std::uint64_t &sequence, bool &needFlush) = 0;
+
+    /*
+     * Replay the changes applied after the base version, it is called once after Load.
+     *
+     * @param sequence the sequence of the base version, the older changes are skipped
+     * @param handler the function applying one change, called in the order of the changes
+     * @return return the sequence of the last change, or sequence if there is no newer change
+     */
+    virtual std::uint64_t ReplayDelta(std::uint64_t sequence, const PolicyDeltaHandler &handler) = 0;
+
+    /*
+     * Append changes after the base version.
+     *
+     * @param records the changes in order, may be empty to only wait for the changes appended before
+     * @param sync true to return after the changes are written to the storage device
+     * @return return thr ErrCode of this function, the caller flushes the whole table if it fails
+     */
+    virtual ErrCode ApplyDelta(const std::vector<PolicyJournalRecord> &records, bool sync) = 0;
+
+    /*
+     * Replace the base version with the table and drop the changes appended before.
+     *
+     * @param table the policies to write, containing every change up to sequence
+     * @param sequence the sequence of the last change contained in the table
+     * @return return thr ErrCode of this function
+     */
+    virtual ErrCode Flush(const std::shared_ptr<const PolicyTable> &table, std::uint64_t sequence) = 0;
+
+    /*
+     * Flush the table in the background if the changes appended since the last flush are too many,
+     * otherwise do nothing. It is called after the changes are appended.
+     *
+     * @param table the policies to write, containing every change up to sequence
+     * @param sequence the sequence of the last change contained in the table
+     */
+    virtual void Checkpoint(const std::shared_ptr<const PolicyTable> &table, std::uint64_t sequence) = 0;
+
+    /*
+     * Get the bytes written to the storage device, it is used to evaluate the write amplification.
+     *
+     * @return return the total bytes written since the store is created
+     */
+    virtual std::uint64_t GetWrittenBytes() = 0;
+};
+} // namespace EDM
+} // namespace OHOS
+
+#endif // SERVICES_EDM_INCLUDE_EDM_IPOLICY_STORE_H_
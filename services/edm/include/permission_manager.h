@@ -17,7 +17,9 @@
 #define SERVICES_EDM_INCLUDE_EDM_PERMISSION_MANAGER_H_
 
 #include <map>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "admin.h"
 #include "edm_permission.h"
@@ -36,18 +38,43 @@ static const AdminPermission ADMIN_PERMISSIONS[] = {
     { "ohos.permission.EDM_TEST_ENT_PERMISSION", AdminType::ENT },
     { "ohos.permission.EDM_MANAGE_DATETIME", AdminType::ENT },
 };
+static_assert(sizeof(ADMIN_PERMISSIONS) / sizeof(ADMIN_PERMISSIONS[0]) <= EDM_MAX_PERMISSION_NUM,
+    "the permission ids must fit in PermissionBits");
 
+/*
+ * The permissions are added by the plugins while their libraries are opened, from several threads at boot.
+ */
 class PermissionManager : public DelayedSingleton<PermissionManager> {
 DECLARE_DELAYED_SINGLETON(PermissionManager)
 public:
     ErrCode AddPermission(const std::string &permission);
+
+    /*
+     * Get the id of a permission. The id is the position of the permission in ADMIN_PERMISSIONS, so the
+     * ids are dense and the same in every thread and every boot, also before the permission is added.
+     *
+     * @param permission the permission name
+     * @return return the id, EDM_INVALID_PERMISSION_ID if the permission is unknown
+     */
+    std::uint32_t GetPermissionId(const std::string &permission);
+
+    /*
+     * Get the bits of the known permissions in the list, the unknown permissions are ignored.
+     *
+     * @param permissions the permission names
+     * @param permissionBits the bits set at the ids of the permissions
+     */
+    void GetPermissionBits(const std::vector<std::string> &permissions, PermissionBits &permissionBits);
     void GetReqPermission(const std::vector<std::string> &permissions,
         std::vector<AdminPermission> &reqPermission);
     void GetReqPermission(const std::vector<std::string> &permissions,
         std::vector<EdmPermission> &reqPermission);
 
 private:
+    static const std::unordered_map<std::string, std::uint32_t> &GetPermissionIds();
+
     std::map<std::string, AdminPermission> permissions_;
+    std::shared_mutex permissionsLock_;
 };
 } // namespace EDM
 } // namespace OHOS
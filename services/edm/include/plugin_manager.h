@@ -12,35 +12,160 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
-
 #ifndef SERVICES_EDM_INCLUDE_EDM_PLUGIN_MANAGER_H_
 #define SERVICES_EDM_INCLUDE_EDM_PLUGIN_MANAGER_H_
+#include <array>
+#include <atomic>
 #include <dlfcn.h>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "func_code.h"
 #include "iplugin.h"
 
+namespace Json {
+class Value;
+}
+
 namespace OHOS {
 namespace EDM {
+/*
+ * The time spent by the static registration of a plugin, from the previous registration of its library or
+ * from the start of dlopen.
+ */
+struct PluginInitTime {
+    std::uint32_t code = 0;
+    std::int64_t initUs = 0;
+};
+
+/*
+ * The time spent opening a plugin library, loadUs includes the initTimes of its plugins. loadUs is -1 if
+ * the library is not opened yet.
+ */
+struct PluginLoadTime {
+    std::string library;
+    std::int64_t loadUs = -1;
+    bool overBudget = false;
+    std::vector<PluginInitTime> initTimes;
+};
+
+/*
+ * The plugins are shared libraries which register themselves to the PluginManager from a static initializer.
+ * The edm_plugin_shared_library template writes a descriptor of every plugin library, listing the policy
+ * code, policy name, permission, needSave and global of its plugins, and the edm_plugin_index template
+ * merges them into one index. At Init the index is read and the permissions registered, a library is only
+ * opened by the first request of one of its policies. Without an index all the libraries are opened at Init
+ * by a bounded number of threads. A library taking longer to open than the load budget is reported.
+ */
 class PluginManager : public std::enable_shared_from_this<PluginManager> {
 public:
     static std::shared_ptr<PluginManager> GetInstance();
-    std::shared_ptr<IPlugin> GetPluginByFuncCode(std::uint32_t funcCode);
-    std::shared_ptr<IPlugin> GetPluginByPolicyName(const std::string &policyName);
+
+    /*
+     * Get the plugin of the policy code in funcCode, its library is opened if it is not yet.
+     *
+     * @param funcCode the function code of the request
+     * @return the plugin, a null pointer if there is no plugin of the code; valid as long as the PluginManager
+     */
+    const std::shared_ptr<IPlugin> &GetPluginByFuncCode(std::uint32_t funcCode);
+    const std::shared_ptr<IPlugin> &GetPluginByPolicyName(const std::string &policyName);
     bool AddPlugin(std::shared_ptr<IPlugin> plugin);
     virtual ~PluginManager();
     void Init();
 
+    /*
+     * Register the plugins described by the plugin index, their libraries are opened from pluginDir on first
+     * use. Must be called before the first request.
+     *
+     * @param indexPath the path of the plugin index
+     * @param pluginDir the directory of the plugin libraries
+     * @param pluginCount the number of plugins registered from the index
+     * @return true if the index is read
+     */
+    bool LoadIndex(const std::string &indexPath, const std::string &pluginDir, std::size_t &pluginCount);
+
+    /*
+     * Get the number of the plugin libraries known and of those opened.
+     *
+     * @param libraryCount the libraries known from the index or opened at Init
+     * @param openedCount the libraries opened
+     */
+    void GetLibraryCount(std::size_t &libraryCount, std::size_t &openedCount);
+
+    /*
+     * Set the time a plugin library may take to open, including the registration of its plugins. Must be
+     * called before Init.
+     *
+     * @param budgetMs the load budget in milliseconds, 0 to not check the load time
+     */
+    void SetLoadBudget(std::uint32_t budgetMs);
+
+    /*
+     * Get the load time of every plugin library known.
+     *
+     * @param loadTimes the load times in the order the libraries are known
+     * @return the number of libraries over the load budget
+     */
+    std::size_t GetLoadTimes(std::vector<PluginLoadTime> &loadTimes);
+
     void DumpPlugin();
 private:
-    std::map<std::uint32_t, std::shared_ptr<IPlugin>> pluginsCode_;
-    std::map<std::string, std::shared_ptr<IPlugin>> pluginsName_;
-    std::vector<void *> pluginHandles_;
+    /*
+     * A plugin is published by setting ready, afterwards the slot is never changed and is read without lock.
+     * libraryIndex is the library in libraries_ which registers the code and the other fields its entry in the
+     * index, only set before the first request.
+     */
+    struct PluginSlot {
+        std::shared_ptr<IPlugin> plugin;
+        std::atomic<bool> ready {false};
+        std::int32_t libraryIndex = -1;
+        std::string policyName;
+        std::string permission;
+        bool needSave = true;
+        bool global = true;
+    };
+
+    struct PluginLibrary {
+        std::string path;
+        void *handle = nullptr;
+        bool failed = false;
+        std::int64_t loadUs = -1;
+        std::vector<PluginInitTime> initTimes;
+    };
+
+    /*
+     * The plugins indexed by the 16 bit policy code in two levels: the high byte selects a page, the low
+     * byte the slot in it. Pages are allocated when the first plugin of the page is added, the policy
+     * codes are dense so only a few pages exist.
+     */
+    static constexpr std::uint32_t DISPATCH_PAGE_BITS = 8;
+    static constexpr std::uint32_t DISPATCH_PAGE_SIZE = 1 << DISPATCH_PAGE_BITS;
+    static constexpr std::uint32_t DISPATCH_PAGE_COUNT = (FUNC_TO_POLICY(UINT32_MAX) + 1) / DISPATCH_PAGE_SIZE;
+    using DispatchPage = std::array<PluginSlot, DISPATCH_PAGE_SIZE>;
+    std::array<std::atomic<DispatchPage *>, DISPATCH_PAGE_COUNT> pluginsCode_ {};
+    std::vector<std::unique_ptr<DispatchPage>> pages_;
+    std::unordered_map<std::string, std::uint32_t> pluginsName_;
+    std::shared_mutex pluginsNameLock_;
+    std::mutex registerLock_;
+    std::mutex loadLock_;
+    std::vector<PluginLibrary> libraries_;
+    std::atomic<std::uint32_t> loadBudgetMs_ {0};
     static std::mutex mutexLock_;
     static std::shared_ptr<PluginManager> instance_;
     PluginManager();
+    PluginSlot &GetSlotLocked(std::uint32_t code);
+    const std::shared_ptr<IPlugin> &GetPluginByCode(std::uint32_t code);
+    const std::shared_ptr<IPlugin> &LoadPluginOfSlot(std::uint32_t code, PluginSlot &slot);
+    std::size_t LoadDescriptor(const Json::Value &descriptor, const std::string &pluginDir);
+    bool CheckDescriptor(const PluginSlot &slot, const std::shared_ptr<IPlugin> &plugin);
     void LoadPlugin();
-    void LoadPlugin(const std::string &pluginPath);
+    void OpenLibrary(PluginLibrary &library);
+    bool IsOverBudget(std::int64_t loadUs);
+    void *LoadPlugin(const std::string &pluginPath);
 };
 } // namespace EDM
 } // namespace OHOS
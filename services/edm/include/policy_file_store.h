@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SERVICES_EDM_INCLUDE_EDM_POLICY_FILE_STORE_H_
+#define SERVICES_EDM_INCLUDE_EDM_POLICY_FILE_STORE_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "ipolicy_store.h"
+#include "policy_journal.h"
+#include "policy_shard_store.h"
+
+namespace OHOS {
+namespace EDM {
+/*
+ * This class is the file store of PolicyManager, the base version is the snapshot file
+ * dir/device_policies.snapshot, or the sharded layout dir/device_policies/, and the changes are
+ * appended to the journal dir/device_policies.journal. The checkpoint rotates the journal and
+ * writes the base version in the background. The legacy dir/device_policies.json is imported when
+ * there is no base version.
+ */
+class PolicyFileStore : public IPolicyStore {
+public:
+    PolicyFileStore();
+    explicit PolicyFileStore(const std::string &dir);
+    ~PolicyFileStore() override;
+    PolicyFileStore(const PolicyFileStore &) = delete;
+    PolicyFileStore &operator=(const PolicyFileStore &) = delete;
+
+    ErrCode Load(PolicyTable &table, std::uint64_t &sequence, bool &needFlush) override;
+    std::uint64_t ReplayDelta(std::uint64_t sequence, const PolicyDeltaHandler &handler) override;
+    ErrCode ApplyDelta(const std::vector<PolicyJournalRecord> &records, bool sync) override;
+    ErrCode Flush(const std::shared_ptr<const PolicyTable> &table, std::uint64_t sequence) override;
+    void Checkpoint(const std::shared_ptr<const PolicyTable> &table, std::uint64_t sequence) override;
+    std::uint64_t GetWrittenBytes() override;
+
+    /*
+     * This function is used to choose how Load reads the snapshot file. When lazy load is enabled only
+     * the combined policies are decoded, the admins are left lazy in the table. Must be called before Load.
+     *
+     * @param enable true to leave the admin policies in the mapped snapshot
+     */
+    void SetLazyLoad(bool enable);
+
+    /*
+     * This function is used to choose the layout of the base version. The sharded layout keeps every admin
+     * in its own file, so rewriting the policies of one admin doesn't depend on the number of admins. Load
+     * moves the policies found in the other layout to the chosen one. Must be called before Load.
+     *
+     * @param enable true to use the sharded layout, false to use the snapshot file
+     */
+    void SetShardedLayout(bool enable);
+
+private:
+    static std::shared_ptr<const PolicyTable> DecodeTable(const std::shared_ptr<const PolicyTable> &table);
+    ErrCode LoadSnapshot(PolicyTable &table, std::uint64_t &sequence);
+    void RemoveUnusedFiles();
+    void WaitCheckpoint();
+    ErrCode WriteShards(const std::shared_ptr<const PolicyTable> &table, std::uint64_t sequence,
+        std::uint64_t &writtenBytes);
+    bool WriteTable(const std::shared_ptr<const PolicyTable> &table, std::uint64_t sequence);
+
+    std::string jsonPath_;
+    std::string snapshotPath_;
+    std::string journalPath_;
+    std::unique_ptr<PolicyShardStore> shardStore_;
+
+    /*
+     * This member is the write-ahead journal, it is created by ReplayDelta
+     */
+    std::unique_ptr<PolicyJournal> journal_;
+
+    bool lazyLoad_ = false;
+
+    bool shardedLayout_ = false;
+
+    /*
+     * This member is set when the files of the other layout are removed after the next flush
+     */
+    bool needRemoveUnused_ = false;
+
+    /*
+     * This member is the thread writing the checkpoint of the base version
+     */
+    std::thread checkpointThread_;
+
+    std::atomic<bool> checkpointRunning_ {false};
+
+    /*
+     * This member is the mutex lock used to protect savedShardTable_ while the shards are written
+     */
+    std::mutex shardMutex_;
+
+    /*
+     * This member is the table written by the last flush of the sharded layout, null if the next flush
+     * writes every admin
+     */
+    std::shared_ptr<const PolicyTable> savedShardTable_;
+
+    std::atomic<std::uint64_t> writtenBytes_ {0};
+};
+} // namespace EDM
+} // namespace OHOS
+
+#endif // SERVICES_EDM_INCLUDE_EDM_POLICY_FILE_STORE_H_
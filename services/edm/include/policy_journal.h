@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SERVICES_EDM_INCLUDE_EDM_POLICY_JOURNAL_H_
+#define SERVICES_EDM_INCLUDE_EDM_POLICY_JOURNAL_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "edm_errors.h"
+
+namespace OHOS {
+namespace EDM {
+/*
+ * One SetPolicy call recorded in the journal, an empty value means the item is deleted.
+ */
+struct PolicyJournalRecord {
+    std::uint64_t sequence = 0;
+    std::string adminName;
+    std::string policyName;
+    std::string adminPolicy;
+    std::string mergedPolicy;
+};
+
+/*
+ * This class is the append-only write-ahead journal of PolicyManager.
+ * Every record is stored as [length][crc32][payload], a record with a bad length or crc
+ * is regarded as the torn tail of an interrupted write and ends the replay.
+ * When a checkpoint starts, the active journal is rotated so that new records can be
+ * appended while the snapshot is written, the rotated journal is removed once the
+ * snapshot is on disk.
+ */
+class PolicyJournal {
+public:
+    explicit PolicyJournal(const std::string &path);
+    ~PolicyJournal();
+
+    /*
+     * Open the active journal for appending, create it if it does not exist.
+     *
+     * @return return thr ErrCode of this function
+     */
+    ErrCode Open();
+
+    /*
+     * Append one record to the end of the active journal.
+     *
+     * @param record the record to append
+     * @param writtenBytes the bytes written to the journal
+     * @return return thr ErrCode of this function
+     */
+    ErrCode Append(const PolicyJournalRecord &record, std::uint64_t &writtenBytes);
+
+    /*
+     * Append a batch of records to the end of the active journal with a single write.
+     *
+     * @param records the records to append
+     * @param writtenBytes the bytes written to the journal
+     * @return return thr ErrCode of this function
+     */
+    ErrCode Append(const std::vector<PolicyJournalRecord> &records, std::uint64_t &writtenBytes);
+
+    /*
+     * Flush the records appended so far to the storage device.
+     *
+     * @return return thr ErrCode of this function
+     */
+    ErrCode Sync();
+
+    /*
+     * Replay the rotated journal and then the active journal, records whose sequence is not
+     * bigger than minSequence are already contained in the snapshot and are skipped.
+     *
+     * @param minSequence the journal sequence saved in the snapshot
+     * @param apply the function called for every record to be replayed
+     * @return return the biggest sequence found in the journal
+     */
+    std::uint64_t Replay(std::uint64_t minSequence, const std::function<void(const PolicyJournalRecord &)> &apply);
+
+    /*
+     * Rename the active journal to the rotated journal and start a new active journal.
+     *
+     * @return return thr ErrCode of this function
+     */
+    ErrCode Rotate();
+
+    /*
+     * Truncate the active journal and remove the rotated journal, used after a snapshot
+     * containing all records has been written synchronously.
+     *
+     * @return return thr ErrCode of this function
+     */
+    ErrCode Reset();
+
+    void RemoveRotated();
+
+    bool HasRotated();
+
+    std::uint64_t GetSize();
+
+private:
+    std::uint64_t ReplayFile(const std::string &path, bool isActive, std::uint64_t minSequence,
+        const std::function<void(const PolicyJournalRecord &)> &apply);
+    ErrCode WriteHeader();
+    void Close();
+
+    std::string path_;
+    std::string rotatedPath_;
+    int fd_ = -1;
+    std::uint64_t size_ = 0;
+};
+} // namespace EDM
+} // namespace OHOS
+
+#endif // SERVICES_EDM_INCLUDE_EDM_POLICY_JOURNAL_H_
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SERVICES_EDM_INCLUDE_EDM_POLICY_JSON_CONVERTER_H_
+#define SERVICES_EDM_INCLUDE_EDM_POLICY_JSON_CONVERTER_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include "edm_errors.h"
+#include "policy_value.h"
+
+namespace OHOS {
+namespace EDM {
+/*
+ * This class converts the policies of PolicyManager from and to the device_policies.json document.
+ * The document is only generated for import and export, PolicyManager keeps no copy of it.
+ */
+class PolicyJsonConverter {
+public:
+    /*
+     * Read the policies from a json file.
+     *
+     * @param path the json file path
+     * @param table the admin policies and combined policies read from the file, the policyAdmins
+     *              index is left to the caller
+     * @param journalSequence the journal sequence saved in the file, 0 if there is none
+     * @return return thr ErrCode of this function
+     */
+    static ErrCode ReadFile(const std::string &path, PolicyTable &table, std::uint64_t &journalSequence);
+
+    /*
+     * Write the policies to a json file, the file is written to path.bak and then renamed.
+     *
+     * @param path the json file path
+     * @param table the policies to write
+     * @return return thr ErrCode of this function
+     */
+    static ErrCode WriteFile(const std::string &path, const PolicyTable &table);
+};
+} // namespace EDM
+} // namespace OHOS
+
+#endif // SERVICES_EDM_INCLUDE_EDM_POLICY_JSON_CONVERTER_H_
@@ -16,22 +16,59 @@
 #ifndef SERVICES_EDM_INCLUDE_EDM_POLICY_MANAGER_H_
 #define SERVICES_EDM_INCLUDE_EDM_POLICY_MANAGER_H_
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 #include "edm_errors.h"
-#include "json/json.h"
+#include "ipolicy_store.h"
+#include "policy_journal.h"
+#include "policy_transaction.h"
+#include "policy_value.h"
 
 namespace OHOS {
 namespace EDM {
 using PolicyItemsMap = std::unordered_map<std::string, std::string>;     /* PolicyName and PolicyValue pair */
 using AdminValueItemsMap = std::unordered_map<std::string, std::string>; /* AdminName and PolicyValue pair */
+using AdminValueViewMap = PolicyValueMap;                                /* AdminName and shared PolicyValue pair */
 
 /*
- * This class is used to load and store /data/system/device_policies.json file.
- * provide the Get and Set api to operate on json file, the read and write json
- * file depend on jsoncpp library
+ * The counters of the persistence worker, the latencies are the wall time of writing one batch.
+ */
+struct PolicyPersistStats {
+    /* the SetPolicy calls not written to the storage yet */
+    std::uint64_t queueDepth = 0;
+    std::uint64_t maxQueueDepth = 0;
+    std::uint64_t flushCount = 0;
+    std::uint64_t failedFlushCount = 0;
+    /* the SetPolicy calls blocked because the queue was full */
+    std::uint64_t backpressureCount = 0;
+    std::uint64_t lastFlushLatencyUs = 0;
+    std::uint64_t maxFlushLatencyUs = 0;
+    std::uint64_t totalFlushLatencyUs = 0;
+};
+
+/*
+ * This class is used to load and store the policies through an IPolicyStore, the PolicyFileStore of
+ * /data/system by default. provide the Get and Set api to operate on the policies, the published
+ * PolicyTable is the only copy of the policies in memory, json is only generated to import and export
+ * the policies.
+ * The Get api reads the published table without any lock. SetPolicy builds a new table sharing the
+ * unchanged items maps under tableMutex_ and publishes it atomically, so a reader never sees a half
+ * applied SetPolicy.
+ * Every SetPolicy is applied to the store as a delta, the store flushes the whole table as a checkpoint
+ * when the deltas grow too large. The store is never written under tableMutex_: a writer queues its
+ * records under it, and writes the queue afterwards under ioMutex_ unless the worker writes it.
+ * When coalescing is enabled the store is only written by the persistence worker, SetPolicy returns
+ * once the new table is published and the change is queued. The worker takes the whole queue, writes
+ * it at the lowest io priority without holding journalMutex_, and blocks the writers while the queue
+ * is full. The lock order is tableMutex_, ioMutex_ and then journalMutex_, the worker holds one of them
+ * at a time.
  */
 class PolicyManager : public std::enable_shared_from_this<PolicyManager> {
 public:
@@ -63,12 +100,27 @@ public:
      */
     ErrCode GetPolicy(const std::string &adminName, const std::string &policyName, std::string &policyValue);
 
+    /*
+     * This function is used to get policy items and the generation of their last change by admin name
+     * policy name. The generation increases with every change and changes across restarts, a caller holding
+     * the value of a generation can skip reading the policy again while the generation is the same.
+     * The generation is returned even if the policy is not found, deleting a policy changes it too.
+     *
+     * @param adminName the application's bundle name, null to get the combined policy
+     * @param policyName the policy item name
+     * @param policyValue the policy value which the caller wanted to get
+     * @param generation the generation of the last change of the policy, never 0
+     * @return return thr ErrCode of this function
+     */
+    ErrCode GetPolicy(const std::string &adminName, const std::string &policyName, std::string &policyValue,
+        std::uint64_t &generation);
+
     /*
      * This function is used to set policy items by admin name policy name. If the adminName is null,
      * will set the combined policy. If the policyName is null, will set the admin policy, otherwise will
      * set both the admin policy and merged policy, if the policy value is null, the policy item will be
      * deleted, this function will write json file. write merged policy and admin policy simultaneously
-     * is very useful for atomic operation
+     * is very useful for atomic operation, use PolicyTransaction to change several policies atomically
      *
      * @param adminName the application's bundle name
      * @param policyName the policy item name
@@ -89,13 +141,98 @@ public:
      */
     ErrCode GetAdminByPolicyName(const std::string &policyName, AdminValueItemsMap &adminValueItems);
 
+    /*
+     * This function is used to get admin name by policy name without copying the policy values,
+     * the returned handles stay valid after the policy is changed
+     *
+     * @param policyName the policy item name
+     * @param adminValueViews the all admin name and shared policy value packaged in std::unordered_map
+     * @return return thr ErrCode of this function
+     */
+    ErrCode GetAdminByPolicyName(const std::string &policyName, AdminValueViewMap &adminValueViews);
+
     /*
      * This function is used to init the PolicyManager, must be called before any of other api
-     * init function will read and parse json file and construct some std::unordered_map to
+     * init function will load the policies from the store and construct some std::unordered_map to
      * provide get and set operation
      */
     void Init();
 
+    /*
+     * This function is used to replace the storage backend, the changes not written yet are written to
+     * the old store first. Init must be called after it to load the policies from the new store.
+     *
+     * @param store the storage backend
+     */
+    void SetPolicyStore(std::shared_ptr<IPolicyStore> store);
+
+    /*
+     * This function is used to replace all policies with the policies in a json file, the
+     * imported policies are flushed to the store immediately
+     *
+     * @param path the json file path, the format is the same as ExportPolicyJson
+     * @return return thr ErrCode of this function
+     */
+    ErrCode ImportPolicyJson(const std::string &path);
+
+    /*
+     * This function is used to write all policies to a json file for debugging and migration
+     *
+     * @param path the json file path
+     * @return return thr ErrCode of this function
+     */
+    ErrCode ExportPolicyJson(const std::string &path);
+
+    /*
+     * This function is used to choose how SetPolicy persists the policies. When the journal is
+     * disabled every SetPolicy flushes the whole table to the store.
+     *
+     * @param enable true to apply SetPolicy to the store as a delta, false to flush the whole table
+     */
+    void SetJournalEnabled(bool enable);
+
+    /*
+     * This function is used to coalesce the journal writes of a burst of SetPolicy. The records are
+     * kept in memory and written with one write after the burst has been quiet for quietWindowMs, or
+     * at the latest maxDelayMs after the first record of the burst.
+     *
+     * @param quietWindowMs the quiet window in milliseconds, 0 means every SetPolicy writes the journal
+     * @param maxDelayMs the max delay of a record in milliseconds
+     */
+    void SetCoalescing(std::uint32_t quietWindowMs, std::uint32_t maxDelayMs);
+
+    /*
+     * This function is used to make SetPolicy wait until its change is written to the storage device
+     * when coalescing is enabled. The other writers are not blocked while one of them waits.
+     *
+     * @param enable true to return from SetPolicy only after the change is durable
+     */
+    void SetDurableWrite(bool enable);
+
+    /*
+     * This function is used to get the counters of the persistence worker
+     *
+     * @param stats the counters and the current queue depth
+     */
+    void GetPersistStats(PolicyPersistStats &stats);
+
+    /*
+     * This function is used as a durability barrier, it writes the coalesced records and waits
+     * until the store writes them to the storage device. When coalescing is enabled the worker
+     * writes them and the caller waits for it.
+     *
+     * @return return thr ErrCode of this function
+     */
+    ErrCode Flush();
+
+    /*
+     * This function is used to get the bytes written to the storage device by the store, including
+     * the deltas and the flushes, it is used to evaluate the write amplification of SetPolicy
+     *
+     * @return return the total bytes written since the store is created
+     */
+    std::uint64_t GetPersistedBytes();
+
     /*
      * This function is debug api used to print all admin policy
      */
@@ -114,56 +251,137 @@ public:
     virtual ~PolicyManager();
 
 private:
+    friend class PolicyTransaction;
+
     PolicyManager();
-    bool DeleteAdminPolicyItemJsonValue(Json::Value &admin, const std::string &adminName,
-        const std::string &policyName, unsigned int &policyItemsNum);
-    bool GetAdminItemJsonObject(const Json::Value &admin, const std::string &adminName);
-    bool ParseAdminList(const std::string &adminName, const PolicyItemsMap &itemsMap);
-    bool ParseAdminPolicy(const Json::Value &admin);
-    bool ParseCombinedPolicy(const Json::Value &combined);
-    bool ParsePolicyItems(const Json::Value &items, PolicyItemsMap &itemsMap);
-    bool SetAdminPolicyItemJsonValue(Json::Value &admin, const std::string &adminName, const std::string &policyName,
+
+    static PolicyValueMap &CopyItems(std::unordered_map<std::string, PolicyItemsHandle> &itemsMaps,
+        const std::string &name);
+    static bool DecodeAdmin(PolicyTable &table, const std::string &adminName);
+    static bool DecodeAllAdmins(PolicyTable &table);
+    static ErrCode DeleteAdminPolicy(PolicyTable &table, const std::string &adminName, const std::string &policyName);
+    static ErrCode DeleteCombinedPolicy(PolicyTable &table, const std::string &policyName);
+    static ErrCode GetAdminPolicy(const PolicyTable &table, const std::string &adminName,
+        const std::string &policyName, std::string &policyValue);
+    static ErrCode GetCombinedPolicy(const PolicyTable &table, const std::string &policyName,
+        std::string &policyValue);
+    static ErrCode SetAdminPolicy(PolicyTable &table, const std::string &adminName, const std::string &policyName,
+        const std::string &policyValue);
+    static ErrCode SetCombinedPolicy(PolicyTable &table, const std::string &policyName,
         const std::string &policyValue);
+    static void BuildAdminIndex(PolicyTable &table);
+    static std::uint64_t GetGeneration(const PolicyTable &table, const std::string &adminName,
+        const std::string &policyName);
+    static void SetGeneration(PolicyTable &table, const std::string &adminName, const std::string &policyName);
+    static std::uint64_t NewGenerationEpoch(std::uint64_t lastEpoch);
+    std::uint64_t MakeGeneration(std::uint64_t sequence) const;
+    static void DeleteAdminList(PolicyTable &table, const std::string &adminName, const std::string &policyName);
 
-    ErrCode DeleteAdminJsonValue(const std::string &adminName, const std::string &policyName);
-    ErrCode DeleteAdminPolicy(const std::string &adminName, const std::string &policyName);
-    ErrCode DeleteCombinedJsonValue(const std::string &policyName);
-    ErrCode DeleteCombinedPolicy(const std::string &policyName);
-    ErrCode GetAdminPolicy(const std::string &adminName, const std::string &policyName, std::string &policyValue);
-    ErrCode GetCombinedPolicy(const std::string &policyName, std::string &policyValue);
+    ErrCode ApplyPolicy(PolicyTable &table, const std::string &adminName, const std::string &policyName,
+        const std::string &adminPolicy, const std::string &mergedPolicy);
+    ErrCode CommitPolicies(std::vector<PolicyJournalRecord> &records);
     ErrCode LoadPolicy();
-    ErrCode SetAdminJsonValue(const std::string &adminName, const std::string &policyName,
-        const std::string &policyValue);
-    ErrCode SetAdminPolicy(const std::string &adminName, const std::string &policyName, const std::string &policyValue);
-    ErrCode SetCombinedJsonValue(const std::string &policyName, const std::string &policyValue);
-    ErrCode SetCombinedPolicy(const std::string &policyName, const std::string &policyValue);
-    ErrCode ParseDevicePolicyJsonFile(const Json::Value &policyRoot);
-    ErrCode ParseJsonString(const std::string &policyValue, Json::Value &policyValueRoot);
+    ErrCode LoadPolicyJson(const std::string &path, PolicyTable &table, std::uint64_t &snapshotSequence);
+    std::shared_ptr<const PolicyTable> LoadDecodedTable();
+    std::shared_ptr<const PolicyTable> LoadTable() const;
+
+    void FlushLoop();
+    ErrCode PersistInline(bool sync);
+    void PersistPending(std::unique_lock<std::mutex> &lock);
+    void PublishTable(std::shared_ptr<const PolicyTable> table);
+    void QueuePolicy(std::vector<PolicyJournalRecord> &records);
+    bool SavePolicy();
+    static void SetLowIoPriority();
+    void StopFlushThread();
+    ErrCode WaitPersisted(std::unique_lock<std::mutex> &lock, std::uint64_t sequence);
+    void WaitQueueRoom();
+    bool WritePending(const std::vector<PolicyJournalRecord> &records, bool isSave, std::uint64_t sequence,
+        bool sync);
+
+    /*
+     * This member is the published policy table, it is never changed after being published and
+     * is only read and replaced through LoadTable and PublishTable
+     */
+    std::shared_ptr<const PolicyTable> table_;
+
+    /*
+     * This member is the mutex lock used to serialize the writers building the next policy table
+     */
+    std::mutex tableMutex_;
 
-    void CreateEmptyJsonFile();
-    void DeleteAdminList(const std::string &adminName, const std::string &policyName);
-    void SavePolicy();
-    void SetAdminList(const std::string &adminName, const std::string &policyName, const std::string &policyValue);
+    /*
+     * This member is the storage backend, it is replaced while holding tableMutex_, ioMutex_ and journalMutex_
+     */
+    std::shared_ptr<IPolicyStore> store_;
 
     /*
-     * This member is the combined policy and combined value pair
+     * This member is the sequence of the last change applied to the store, it counts every SetPolicy
+     * and is saved with the base version, the generation of a change is its sequence plus one in the
+     * current epoch
      */
-    PolicyItemsMap combinedPolicies_;
+    std::uint64_t journalSequence_ = 0;
 
     /*
-     * This member is the admin name and policyName, policyValue pairs
+     * This member is the random epoch taken by every load of the policies, it is set while holding tableMutex_
      */
-    std::unordered_map<std::string, PolicyItemsMap> adminPolicies_;
+    std::uint64_t generationEpoch_ = 0;
+
+    bool journalEnabled_ = true;
 
     /*
-     * This member is the policy name and adminName, policyValue pairs
+     * This member is the mutex lock used to protect the store and the records waiting to be written
      */
-    std::unordered_map<std::string, AdminValueItemsMap> policyAdmins_;
+    std::mutex journalMutex_;
+
+    std::condition_variable flushCond_;
 
     /*
-     * This member is the json root, used to parse and write json file
+     * This member is notified when the worker takes the queue and when a batch is written
      */
-    Json::Value policyRoot_;
+    std::condition_variable persistedCond_;
+
+    std::vector<PolicyJournalRecord> pendingRecords_;
+
+    /*
+     * This member is the persistence worker writing the coalesced records to the store
+     */
+    std::thread flushThread_;
+
+    bool flushStopping_ = false;
+
+    bool workerRunning_ = false;
+
+    bool flushRequested_ = false;
+
+    bool lastFlushFailed_ = false;
+
+    std::atomic<bool> durableWrite_ {false};
+
+    /*
+     * This member is the sequence of the last SetPolicy written to the storage device
+     */
+    std::uint64_t persistedSequence_ = 0;
+
+    PolicyPersistStats persistStats_;
+
+    /*
+     * This member is the mutex lock used to keep the worker from writing the store while it is
+     * reloaded or replaced
+     */
+    std::mutex ioMutex_;
+
+    /*
+     * This member is set when applying the delta failed, the whole table is flushed instead
+     */
+    bool needSave_ = false;
+
+    std::chrono::milliseconds quietWindow_ {0};
+
+    std::chrono::milliseconds maxDelay_ {0};
+
+    std::chrono::steady_clock::time_point firstPendingTime_;
+
+    std::chrono::steady_clock::time_point lastPendingTime_;
 
     /*
      * This member is the singleton instance of PolicyManager
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SERVICES_EDM_INCLUDE_EDM_POLICY_MEMORY_STORE_H_
+#define SERVICES_EDM_INCLUDE_EDM_POLICY_MEMORY_STORE_H_
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "ipolicy_store.h"
+
+namespace OHOS {
+namespace EDM {
+/*
+ * This class is the in-memory store of PolicyManager, the base version is the last flushed table
+ * and the changes are kept in a vector. Nothing is written to the storage device, the policies
+ * survive a reload of PolicyManager but not a restart of the process. It is used by the tests and
+ * as the baseline of the storage benchmarks.
+ */
+class PolicyMemoryStore : public IPolicyStore {
+public:
+    ErrCode Load(PolicyTable &table, std::uint64_t &sequence, bool &needFlush) override;
+    std::uint64_t ReplayDelta(std::uint64_t sequence, const PolicyDeltaHandler &handler) override;
+    ErrCode ApplyDelta(const std::vector<PolicyJournalRecord> &records, bool sync) override;
+    ErrCode Flush(const std::shared_ptr<const PolicyTable> &table, std::uint64_t sequence) override;
+    void Checkpoint(const std::shared_ptr<const PolicyTable> &table, std::uint64_t sequence) override;
+    std::uint64_t GetWrittenBytes() override;
+
+private:
+    std::mutex mutex_;
+
+    /*
+     * This member is the base version, the table is immutable so it is kept instead of copied
+     */
+    std::shared_ptr<const PolicyTable> table_;
+
+    std::uint64_t sequence_ = 0;
+
+    std::vector<PolicyJournalRecord> records_;
+};
+} // namespace EDM
+} // namespace OHOS
+
+#endif // SERVICES_EDM_INCLUDE_EDM_POLICY_MEMORY_STORE_H_
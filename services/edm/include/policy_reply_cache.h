@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SERVICES_EDM_INCLUDE_POLICY_REPLY_CACHE_H_
+#define SERVICES_EDM_INCLUDE_POLICY_REPLY_CACHE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace OHOS {
+namespace EDM {
+using PolicyReply = std::shared_ptr<const std::vector<std::uint8_t>>;
+
+/*
+ * The already encoded combined policy of the GetDevicePolicy replies, keyed by the policy code.
+ * A hit is copied into the parcel after the reply header, without deserializing and encoding the
+ * policy again. The PolicyManager generation of the encoded value is kept with it, so the reply
+ * to a conditional request for another generation is served from the cache too.
+ *
+ * Every entry has a generation which is increased by Invalidate. A reader takes the generation
+ * before reading the policy and Put drops the reply if the policy was changed in between, so
+ * a stale value is never cached.
+ */
+class PolicyReplyCache {
+public:
+    /*
+     * Get the cached reply of the policy.
+     *
+     * @param policyCode the policy code of the plugin
+     * @param reply the cached reply, nullptr if not cached
+     * @param policyGeneration the PolicyManager generation of the policy the reply is encoded from
+     * @return the current generation of the entry, to be passed to Put
+     */
+    std::uint64_t Get(std::uint32_t policyCode, PolicyReply &reply, std::uint64_t &policyGeneration);
+
+    /*
+     * Cache the reply encoded from the policy read after Get returned the generation.
+     *
+     * @param policyCode the policy code of the plugin
+     * @param generation the generation returned by Get
+     * @param policyGeneration the PolicyManager generation of the policy the reply is encoded from
+     * @param reply the encoded reply
+     * @return true if cached, false if the policy was invalidated since Get
+     */
+    bool Put(std::uint32_t policyCode, std::uint64_t generation, std::uint64_t policyGeneration, PolicyReply reply);
+
+    /*
+     * Drop the cached reply, called after the combined policy was changed.
+     *
+     * @param policyCode the policy code of the plugin
+     */
+    void Invalidate(std::uint32_t policyCode);
+
+    void Clear();
+
+    std::uint64_t GetHitCount() const;
+
+    std::uint64_t GetMissCount() const;
+
+private:
+    struct Entry {
+        std::uint64_t generation = 0;
+        std::uint64_t policyGeneration = 0;
+        PolicyReply reply;
+    };
+
+    std::shared_mutex mutex_;
+    std::unordered_map<std::uint32_t, Entry> entries_;
+    std::atomic<std::uint64_t> hitCount_ {0};
+    std::atomic<std::uint64_t> missCount_ {0};
+};
+} // namespace EDM
+} // namespace OHOS
+
+#endif // SERVICES_EDM_INCLUDE_POLICY_REPLY_CACHE_H_
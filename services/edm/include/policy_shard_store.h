@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SERVICES_EDM_INCLUDE_EDM_POLICY_SHARD_STORE_H_
+#define SERVICES_EDM_INCLUDE_EDM_POLICY_SHARD_STORE_H_
+
+#include <cstdint>
+#include <string>
+#include "edm_errors.h"
+#include "policy_value.h"
+
+namespace OHOS {
+namespace EDM {
+/*
+ * This class is the sharded layout of the policy files, /data/system/device_policies/. Every admin
+ * has its own file and the combined policies are kept in one more file, so a change of one admin
+ * rewrites two small files whatever the number of admins is. Every file has the format of
+ * PolicySnapshot. The combined file is written last and holds the journal sequence of the layout,
+ * the manifest is written once after all files of a new layout are written, a directory without it
+ * is ignored.
+ */
+class PolicyShardStore {
+public:
+    explicit PolicyShardStore(const std::string &dir);
+
+    /*
+     * Check whether the directory holds a complete layout.
+     *
+     * @return return true if the manifest exists
+     */
+    bool IsCreated() const;
+
+    /*
+     * Read all admin files and the combined file, the admin index of the table is not built.
+     *
+     * @param table the table to add the policies to
+     * @param journalSequence the journal sequence saved in the combined file
+     * @return return thr ErrCode of this function
+     */
+    ErrCode Load(PolicyTable &table, std::uint64_t &journalSequence);
+
+    /*
+     * Write the file of one admin, the file is removed if the admin has no policy.
+     *
+     * @param adminName the application's bundle name
+     * @param policies the policies of the admin, null if the admin has no policy
+     * @param journalSequence the sequence of the last journal record contained in the policies
+     * @param writtenBytes the size of the written file
+     * @return return thr ErrCode of this function
+     */
+    ErrCode WriteAdmin(const std::string &adminName, const PolicyItemsHandle &policies,
+        std::uint64_t journalSequence, std::uint64_t &writtenBytes);
+
+    /*
+     * Write the combined file, it must be written after the admin files changed by the same save.
+     *
+     * @param policies the combined policies
+     * @param journalSequence the sequence of the last journal record contained in the layout
+     * @param writtenBytes the size of the written file
+     * @return return thr ErrCode of this function
+     */
+    ErrCode WriteCombined(const PolicyValueMap &policies, std::uint64_t journalSequence,
+        std::uint64_t &writtenBytes);
+
+    /*
+     * Remove the files of the admins not in the table, they are left by a layout written before.
+     *
+     * @param table the policies just written
+     * @return return thr ErrCode of this function
+     */
+    ErrCode RemoveStaleAdmins(const PolicyTable &table);
+
+    /*
+     * Mark the layout as complete, it is called after the first save of a new layout.
+     *
+     * @return return thr ErrCode of this function
+     */
+    ErrCode WriteManifest();
+
+    /*
+     * Remove the manifest and every file of the layout, the manifest is removed first.
+     */
+    void Remove();
+
+private:
+    std::string GetAdminPath(const std::string &adminName) const;
+    static bool IsAdminFile(const std::string &fileName);
+
+    std::string dir_;
+};
+} // namespace EDM
+} // namespace OHOS
+
+#endif // SERVICES_EDM_INCLUDE_EDM_POLICY_SHARD_STORE_H_
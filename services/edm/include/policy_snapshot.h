@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SERVICES_EDM_INCLUDE_EDM_POLICY_SNAPSHOT_H_
+#define SERVICES_EDM_INCLUDE_EDM_POLICY_SNAPSHOT_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include "edm_errors.h"
+#include "policy_value.h"
+
+namespace OHOS {
+namespace EDM {
+/*
+ * This class is the binary snapshot of PolicyManager, /data/system/device_policies.snapshot.
+ * The file is made up of a header, a section table and four sections: the admin table, the
+ * admin policy table, the combined policy table and the string data. Every table entry refers
+ * to its strings by offset and length inside the data section, so the snapshot is mapped
+ * read-only and a value is only copied out when it is asked for.
+ */
+class PolicySnapshot {
+public:
+    PolicySnapshot() = default;
+    ~PolicySnapshot();
+    PolicySnapshot(const PolicySnapshot &) = delete;
+    PolicySnapshot &operator=(const PolicySnapshot &) = delete;
+
+    /*
+     * Map the snapshot file and check its header, section table and index.
+     *
+     * @param path the snapshot file path
+     * @return return thr ErrCode of this function
+     */
+    ErrCode Open(const std::string &path);
+
+    void Close();
+
+    std::uint64_t GetJournalSequence() const;
+
+    std::uint32_t GetAdminCount() const;
+
+    /*
+     * Get the name of the admin at index.
+     *
+     * @param index the index of the admin table, less than GetAdminCount()
+     * @param adminName the admin name
+     * @return return false if the index is invalid
+     */
+    bool GetAdminName(std::uint32_t index, std::string &adminName) const;
+
+    /*
+     * Get all policies of the admin at index.
+     *
+     * @param index the index of the admin table, less than GetAdminCount()
+     * @param policies the policy name and policy value pairs of the admin
+     * @return return false if the index is invalid
+     */
+    bool GetAdminPolicies(std::uint32_t index, PolicyValueMap &policies) const;
+
+    /*
+     * Get one policy of the admin at index without decoding the other policies of the admin.
+     *
+     * @param index the index of the admin table, less than GetAdminCount()
+     * @param policyName the policy item name
+     * @param policyValue the policy value
+     * @return return false if the index is invalid or the admin has no such policy
+     */
+    bool GetAdminPolicy(std::uint32_t index, const std::string &policyName, std::string &policyValue) const;
+
+    bool GetCombinedPolicies(PolicyValueMap &policies) const;
+
+    /*
+     * Write the policies to a new snapshot file, the file is written to path.bak and then renamed.
+     *
+     * @param path the snapshot file path
+     * @param journalSequence the sequence of the last journal record contained in the policies
+     * @param table the policies to write
+     * @param writtenBytes the size of the snapshot file
+     * @return return thr ErrCode of this function
+     */
+    static ErrCode Write(const std::string &path, std::uint64_t journalSequence, const PolicyTable &table,
+        std::uint64_t &writtenBytes);
+
+private:
+    struct Section;
+    struct ItemEntry;
+    struct AdminEntry;
+
+    bool CheckAdminPolicies(std::uint32_t index) const;
+    bool CheckIndex();
+    bool GetString(std::uint64_t offset, std::uint32_t length, std::string &value) const;
+    bool GetItems(const ItemEntry *entries, std::uint64_t begin, std::uint64_t count, PolicyValueMap &items) const;
+
+    const char *base_ = nullptr;
+    std::uint64_t size_ = 0;
+    std::uint64_t journalSequence_ = 0;
+    const AdminEntry *admins_ = nullptr;
+    std::uint32_t adminCount_ = 0;
+    const ItemEntry *policies_ = nullptr;
+    std::uint64_t policyCount_ = 0;
+    const ItemEntry *combined_ = nullptr;
+    std::uint64_t combinedCount_ = 0;
+    const char *data_ = nullptr;
+    std::uint64_t dataSize_ = 0;
+};
+} // namespace EDM
+} // namespace OHOS
+
+#endif // SERVICES_EDM_INCLUDE_EDM_POLICY_SNAPSHOT_H_
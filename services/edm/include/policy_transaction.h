@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SERVICES_EDM_INCLUDE_EDM_POLICY_TRANSACTION_H_
+#define SERVICES_EDM_INCLUDE_EDM_POLICY_TRANSACTION_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "edm_errors.h"
+#include "policy_journal.h"
+
+namespace OHOS {
+namespace EDM {
+class PolicyManager;
+
+/*
+ * This class is used to change several policies of PolicyManager atomically. SetPolicy only stages the
+ * change in memory, Commit applies the staged changes to one new policy table, publishes it once and
+ * persists the changes with one write to the store. A reader sees either none or all of the changes,
+ * the policies read before Commit don't contain the staged changes.
+ * A transaction not committed is aborted when it is destroyed. A transaction is used by one thread, the
+ * caller keeps the other writers of the same policies out until Commit returns.
+ */
+class PolicyTransaction {
+public:
+    explicit PolicyTransaction(std::shared_ptr<PolicyManager> policyMgr);
+
+    ~PolicyTransaction();
+
+    PolicyTransaction(const PolicyTransaction &) = delete;
+
+    PolicyTransaction &operator=(const PolicyTransaction &) = delete;
+
+    /*
+     * This function is used to stage a change of policy items, the parameters are the same as
+     * PolicyManager::SetPolicy
+     *
+     * @param adminName the application's bundle name, null to set the combined policy only
+     * @param policyName the policy item name
+     * @param adminPolicyValue the admin policy value, null to delete the admin policy
+     * @param mergedPolicyValue the merged policy value, null to delete the combined policy
+     * @return return thr ErrCode of this function
+     */
+    ErrCode SetPolicy(const std::string &adminName, const std::string &policyName,
+        const std::string &adminPolicyValue, const std::string &mergedPolicyValue);
+
+    /*
+     * This function is used to apply the staged changes in the order they were staged, the transaction
+     * is empty afterwards. Like SetPolicy the changes are applied even if one of them fails.
+     *
+     * @return return thr ErrCode of this function, the error of the first failed change
+     */
+    ErrCode Commit();
+
+    /*
+     * This function is used to drop the staged changes
+     */
+    void Abort();
+
+    /*
+     * This function is used to get the count of the staged changes
+     *
+     * @return return the count of the staged changes
+     */
+    std::size_t GetSize() const;
+
+private:
+    std::shared_ptr<PolicyManager> policyMgr_;
+
+    std::vector<PolicyJournalRecord> records_;
+};
+} // namespace EDM
+} // namespace OHOS
+
+#endif // SERVICES_EDM_INCLUDE_EDM_POLICY_TRANSACTION_H_
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SERVICES_EDM_INCLUDE_EDM_POLICY_VALUE_H_
+#define SERVICES_EDM_INCLUDE_EDM_POLICY_VALUE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace OHOS {
+namespace EDM {
+/*
+ * An immutable policy value shared by all indexes of PolicyManager, a value is never changed
+ * after it is created, setting a policy replaces the handle.
+ */
+using PolicyValue = std::shared_ptr<const std::string>;
+using PolicyValueMap = std::unordered_map<std::string, PolicyValue>; /* Name and shared PolicyValue pair */
+
+inline PolicyValue MakePolicyValue(std::string value)
+{
+    return std::make_shared<const std::string>(std::move(value));
+}
+
+using PolicyItemsHandle = std::shared_ptr<const PolicyValueMap>;
+using PolicyGenerationMap = std::unordered_map<std::string, std::uint64_t>; /* Name and generation pair */
+
+class PolicySnapshot;
+
+/*
+ * One immutable version of all policies. A new version shares every unchanged items map with
+ * the version it is copied from, so publishing a change only copies the outer maps.
+ */
+struct PolicyTable {
+    /* admin name and the policy name, policy value pairs of the admin */
+    std::unordered_map<std::string, PolicyItemsHandle> adminPolicies;
+    /* policy name and the admin name, policy value pairs, the index of adminPolicies by policy name */
+    std::unordered_map<std::string, PolicyItemsHandle> policyAdmins;
+    /* combined policy name and combined value pairs */
+    PolicyValueMap combinedPolicies;
+    /* the snapshot the lazy admins are decoded from, null if every admin is decoded */
+    std::shared_ptr<const PolicySnapshot> snapshot;
+    /* admin name and admin index in the snapshot of the admins not decoded yet, they are not in policyAdmins */
+    std::unordered_map<std::string, std::uint32_t> lazyAdmins;
+    /* the generation of the last change, every SetPolicy increases it by one */
+    std::uint64_t generation = 0;
+    /* the generation of the policies not changed since the table was loaded */
+    std::uint64_t baseGeneration = 0;
+    /* combined policy name and the generation of its last change since the table was loaded */
+    PolicyGenerationMap combinedGenerations;
+    /* admin name and the policy name, generation pairs of the admin policies changed since the table was loaded */
+    std::unordered_map<std::string, std::shared_ptr<const PolicyGenerationMap>> adminGenerations;
+};
+} // namespace EDM
+} // namespace OHOS
+
+#endif // SERVICES_EDM_INCLUDE_EDM_POLICY_VALUE_H_
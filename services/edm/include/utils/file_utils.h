@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SERVICES_EDM_INCLUDE_UTILS_FILE_UTILS_H_
+#define SERVICES_EDM_INCLUDE_UTILS_FILE_UTILS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace OHOS {
+namespace EDM {
+class FileUtils {
+public:
+    static std::uint32_t Crc32(const char *data, std::size_t size);
+
+    static bool WriteAll(int fd, const std::string &buffer);
+
+    /*
+     * Sync the directory of a file, a created, renamed or removed file is only durable after it.
+     *
+     * @param filePath the path of the file
+     * @return return true if the directory is synced
+     */
+    static bool SyncDir(const std::string &filePath);
+};
+} // namespace EDM
+} // namespace OHOS
+
+#endif // SERVICES_EDM_INCLUDE_UTILS_FILE_UTILS_H_
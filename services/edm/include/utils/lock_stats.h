@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SERVICES_EDM_INCLUDE_UTILS_LOCK_STATS_H_
+#define SERVICES_EDM_INCLUDE_UTILS_LOCK_STATS_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace OHOS {
+namespace EDM {
+/*
+ * Contention metrics of one lock domain: how many times the locks were taken, how many times
+ * the caller had to wait because another thread held them, and the total waiting time.
+ */
+class LockStats {
+public:
+    explicit LockStats(const std::string &name);
+
+    /*
+     * Lock a std::unique_lock or std::shared_lock constructed with std::defer_lock and record
+     * whether it was contended.
+     *
+     * @param lock the deferred lock to acquire
+     */
+    template<typename Lock>
+    void Acquire(Lock &lock)
+    {
+        acquireCount_++;
+        if (lock.try_lock()) {
+            return;
+        }
+        auto begin = std::chrono::steady_clock::now();
+        lock.lock();
+        contendedCount_++;
+        waitTimeUs_ += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - begin).count());
+    }
+
+    std::uint64_t GetAcquireCount() const;
+
+    std::uint64_t GetContendedCount() const;
+
+    std::uint64_t GetWaitTimeUs() const;
+
+    void Reset();
+
+    /*
+     * Print the metrics to the log.
+     */
+    void Dump() const;
+
+private:
+    std::string name_;
+    std::atomic<std::uint64_t> acquireCount_ {0};
+    std::atomic<std::uint64_t> contendedCount_ {0};
+    std::atomic<std::uint64_t> waitTimeUs_ {0};
+};
+} // namespace EDM
+} // namespace OHOS
+
+#endif // SERVICES_EDM_INCLUDE_UTILS_LOCK_STATS_H_
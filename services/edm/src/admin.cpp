@@ -17,15 +17,19 @@
 
 #include "edm_log.h"
 #include "ent_info.h"
+#include "permission_manager.h"
 #include "string_ex.h"
 
 namespace OHOS {
 namespace EDM {
 bool Admin::CheckPermission(const std::string &permission)
 {
-    EDMLOGD("Admin::CheckPermission");
-    return std::any_of(adminInfo_.permission_.begin(), adminInfo_.permission_.end(),
-        [&permission](const std::string &item) { return item == permission; });
+    return CheckPermissionId(PermissionManager::GetInstance()->GetPermissionId(permission));
+}
+
+bool Admin::CheckPermissionId(std::uint32_t permissionId)
+{
+    return permissionId < EDM_MAX_PERMISSION_NUM && adminInfo_.permissionBits_.test(permissionId);
 }
 
 AdminType Admin::GetAdminType()
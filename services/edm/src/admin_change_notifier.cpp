@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "admin_change_notifier.h"
+#include <algorithm>
+#include "edm_log.h"
+#include "iadmin_change_callback.h"
+
+namespace OHOS {
+namespace EDM {
+namespace {
+constexpr uint32_t DEFAULT_QUIET_WINDOW_MS = 100;
+constexpr uint32_t DEFAULT_MAX_DELAY_MS = 500;
+constexpr size_t MAX_SUBSCRIBER_COUNT = 64;
+}
+
+AdminChangeNotifier::AdminChangeNotifier()
+    : quietWindow_(DEFAULT_QUIET_WINDOW_MS), maxDelay_(DEFAULT_MAX_DELAY_MS)
+{
+    deathRecipient_ = new (std::nothrow) SubscriberDeathRecipient(*this);
+}
+
+AdminChangeNotifier::~AdminChangeNotifier()
+{
+    std::vector<Subscriber> subscribers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+        subscribers.swap(subscribers_);
+    }
+    cond_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    for (const auto &subscriber : subscribers) {
+        if (deathRecipient_ != nullptr) {
+            subscriber.callback->RemoveDeathRecipient(deathRecipient_);
+        }
+    }
+}
+
+ErrCode AdminChangeNotifier::Subscribe(const sptr<IRemoteObject> &callback, int32_t userId)
+{
+    if (callback == nullptr) {
+        return ERR_EDM_PARAM_ERROR;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = std::find_if(subscribers_.begin(), subscribers_.end(),
+        [&callback](const Subscriber &subscriber) { return subscriber.callback == callback; });
+    if (iter != subscribers_.end()) {
+        iter->userId = userId;
+        return ERR_OK;
+    }
+    if (subscribers_.size() >= MAX_SUBSCRIBER_COUNT) {
+        EDMLOGW("AdminChangeNotifier::Subscribe too many subscribers");
+        return ERR_EDM_SUBSCRIBE_ADMIN_CHANGE_FAILED;
+    }
+    // a callback of the same process is a local stub and never dies on its own
+    if (deathRecipient_ == nullptr || !callback->AddDeathRecipient(deathRecipient_)) {
+        EDMLOGI("AdminChangeNotifier::Subscribe death recipient not added");
+    }
+    subscribers_.push_back({callback, userId});
+    if (!worker_.joinable()) {
+        worker_ = std::thread(&AdminChangeNotifier::Run, this);
+    }
+    EDMLOGI("AdminChangeNotifier::Subscribe user %{public}d, %{public}zu subscribers", userId,
+        subscribers_.size());
+    return ERR_OK;
+}
+
+ErrCode AdminChangeNotifier::Unsubscribe(const sptr<IRemoteObject> &callback)
+{
+    if (callback == nullptr) {
+        return ERR_EDM_PARAM_ERROR;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = std::find_if(subscribers_.begin(), subscribers_.end(),
+        [&callback](const Subscriber &subscriber) { return subscriber.callback == callback; });
+    if (iter == subscribers_.end()) {
+        return ERR_EDM_PARAM_ERROR;
+    }
+    if (deathRecipient_ != nullptr) {
+        callback->RemoveDeathRecipient(deathRecipient_);
+    }
+    subscribers_.erase(iter);
+    if (subscribers_.empty()) {
+        pending_.clear();
+    }
+    return ERR_OK;
+}
+
+void AdminChangeNotifier::Notify(const AdminChangeEvent &event)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (subscribers_.empty()) {
+            return;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (pending_.empty()) {
+            firstPendingTime_ = now;
+        }
+        lastPendingTime_ = now;
+        AdminChangeEvent merged = event;
+        auto iter = std::find_if(pending_.begin(), pending_.end(), [&event](const AdminChangeEvent &item) {
+            return item.bundleName == event.bundleName && item.userId == event.userId;
+        });
+        if (iter != pending_.end()) {
+            bool isActivationPending = (iter->changeType == AdminChangeType::ADMIN_ACTIVATED);
+            pending_.erase(iter);
+            // the subscribers have not seen the activation yet, an admin deactivated again is never reported
+            if (isActivationPending && event.changeType == AdminChangeType::ADMIN_DEACTIVATED) {
+                return;
+            }
+            // the activation not seen yet already carries the new info
+            if (isActivationPending && event.changeType == AdminChangeType::ADMIN_ENT_INFO_CHANGED) {
+                merged.changeType = AdminChangeType::ADMIN_ACTIVATED;
+            }
+        }
+        pending_.push_back(merged);
+    }
+    cond_.notify_one();
+}
+
+void AdminChangeNotifier::SetCoalescing(uint32_t quietWindowMs, uint32_t maxDelayMs)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quietWindow_ = std::chrono::milliseconds(quietWindowMs);
+        maxDelay_ = std::chrono::milliseconds(std::max(quietWindowMs, maxDelayMs));
+    }
+    cond_.notify_one();
+}
+
+size_t AdminChangeNotifier::GetSubscriberCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return subscribers_.size();
+}
+
+void AdminChangeNotifier::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopped_) {
+        if (pending_.empty()) {
+            cond_.wait(lock, [this] { return stopped_ || !pending_.empty(); });
+            continue;
+        }
+        auto deadline = std::min(lastPendingTime_ + quietWindow_, firstPendingTime_ + maxDelay_);
+        if (std::chrono::steady_clock::now() < deadline) {
+            cond_.wait_until(lock, deadline);
+            continue;
+        }
+        std::vector<AdminChangeEvent> events;
+        events.swap(pending_);
+        std::vector<Subscriber> subscribers = subscribers_;
+        lock.unlock();
+        Deliver(events, subscribers);
+        lock.lock();
+    }
+}
+
+void AdminChangeNotifier::Deliver(const std::vector<AdminChangeEvent> &events,
+    const std::vector<Subscriber> &subscribers)
+{
+    for (const auto &subscriber : subscribers) {
+        std::vector<AdminChangeEvent> visible;
+        for (const auto &event : events) {
+            if (event.userId == subscriber.userId || event.adminType == AdminType::ENT) {
+                visible.push_back(event);
+            }
+        }
+        if (visible.empty()) {
+            continue;
+        }
+        sptr<IAdminChangeCallback> callback = iface_cast<IAdminChangeCallback>(subscriber.callback);
+        if (callback == nullptr) {
+            EDMLOGW("AdminChangeNotifier::Deliver callback is not an IAdminChangeCallback");
+            continue;
+        }
+        callback->OnAdminChanged(visible);
+    }
+}
+
+void AdminChangeNotifier::SubscriberDeathRecipient::OnRemoteDied(const wptr<IRemoteObject> &remote)
+{
+    sptr<IRemoteObject> callback = remote.promote();
+    if (callback == nullptr) {
+        return;
+    }
+    EDMLOGI("AdminChangeNotifier subscriber died");
+    notifier_.Unsubscribe(callback);
+}
+} // namespace EDM
+} // namespace OHOS
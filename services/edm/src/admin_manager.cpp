@@ -15,16 +15,26 @@
 
 #include "admin_manager.h"
 #include <algorithm>
-#include <ctime>
+#include <dirent.h>
 #include <fstream>
 #include <iostream>
+#include <unistd.h>
 #include "edm_log.h"
+#include "string_ex.h"
 #include "permission_manager.h"
 #include "super_admin.h"
 
 namespace OHOS {
 namespace EDM {
 const std::string EDM_ADMIN_JSON_FILE = "/data/system/admin_policies.json";
+const std::string EDM_ADMIN_RECORD_FILE = "/data/system/admin_policies.records";
+const std::string EDM_ADMIN_RECORD_DIR = "/data/system/";
+const std::string EDM_ADMIN_USER_RECORD_NAME = "admin_policies_";
+const std::string EDM_ADMIN_USER_RECORD_PREFIX = EDM_ADMIN_RECORD_DIR + EDM_ADMIN_USER_RECORD_NAME;
+const std::string EDM_ADMIN_USER_RECORD_SUFFIX = ".records";
+/* the record file is compacted when it holds this many records and most of them are dead */
+constexpr std::uint64_t EDM_ADMIN_COMPACT_MIN_RECORDS = 64;
+constexpr std::uint64_t EDM_ADMIN_COMPACT_RATIO = 2;
 std::shared_ptr<AdminManager> AdminManager::instance_;
 std::mutex AdminManager::mutexLock_;
 
@@ -39,7 +49,7 @@ std::shared_ptr<AdminManager> AdminManager::GetInstance()
     return instance_;
 }
 
-AdminManager::AdminManager()
+AdminManager::AdminManager() : admins_(std::make_shared<AdminTableMap>())
 {
     EDMLOGI("AdminManager::AdminManager");
 }
@@ -47,7 +57,180 @@ AdminManager::AdminManager()
 AdminManager::~AdminManager()
 {
     EDMLOGI("AdminManager::~AdminManager");
-    admins_.clear();
+}
+
+std::string AdminManager::GetRecordPath(int32_t userId)
+{
+    /* the admins of the default user keep the file of the admins saved before the partitioning */
+    if (userId == DEFAULT_USER_ID) {
+        return EDM_ADMIN_RECORD_FILE;
+    }
+    return EDM_ADMIN_USER_RECORD_PREFIX + std::to_string(userId) + EDM_ADMIN_USER_RECORD_SUFFIX;
+}
+
+std::shared_ptr<const AdminTable> AdminManager::LoadAdmins(int32_t userId)
+{
+    auto tables = std::atomic_load(&admins_);
+    auto iter = tables->find(userId);
+    if (iter != tables->end()) {
+        return iter->second;
+    }
+    std::lock_guard<std::mutex> lock(adminsMutex_);
+    return FindUserLocked(userId);
+}
+
+// the caller holds adminsMutex_, a user without a record file has no admins and is not published
+std::shared_ptr<const AdminTable> AdminManager::FindUserLocked(int32_t userId)
+{
+    static const std::shared_ptr<const AdminTable> emptyTable = []() {
+        auto admins = std::make_shared<AdminTable>();
+        BuildActiveAdmins(*admins);
+        return admins;
+    }();
+    auto tables = std::atomic_load(&admins_);
+    auto iter = tables->find(userId);
+    if (iter != tables->end()) {
+        return iter->second;
+    }
+    if (userId != DEFAULT_USER_ID && access(GetRecordPath(userId).c_str(), F_OK) != 0) {
+        return emptyTable;
+    }
+    return LoadUserLocked(userId);
+}
+
+// the caller holds adminsMutex_
+std::shared_ptr<const AdminTable> AdminManager::LoadUserLocked(int32_t userId)
+{
+    auto tables = std::atomic_load(&admins_);
+    auto iter = tables->find(userId);
+    if (iter != tables->end()) {
+        return iter->second;
+    }
+    auto admins = std::make_shared<AdminTable>();
+    std::unique_ptr<AdminRecordStore> &recordStore = recordStores_[userId];
+    recordStore = std::make_unique<AdminRecordStore>(GetRecordPath(userId));
+    if (recordStore->IsCreated()) {
+        recordStore->Load([this, &admins](const AdminRecord &record) { ReadAdminRecord(record, *admins); });
+    } else if (userId == DEFAULT_USER_ID) {
+        // migrate the admins of the json file, it is removed once the record file is written. The json file
+        // has no user, its admins are kept with the default user and stay admins of every user
+        ReadJsonAdmin(EDM_ADMIN_JSON_FILE, *admins);
+        CompactAdmin(userId, *admins);
+    }
+    if (userId == DEFAULT_USER_ID && recordStore->IsCreated()) {
+        unlink(EDM_ADMIN_JSON_FILE.c_str());
+    }
+    BuildActiveAdmins(*admins);
+    EDMLOGI("AdminManager::LoadUser user %{public}d, admin size %{public}zu", userId, admins->admins.size());
+    PublishAdmins(userId, admins);
+    return admins;
+}
+
+void AdminManager::PublishAdmins(int32_t userId, std::shared_ptr<const AdminTable> admins)
+{
+    auto tables = std::make_shared<AdminTableMap>(*std::atomic_load(&admins_));
+    (*tables)[userId] = std::move(admins);
+    std::atomic_store(&admins_, std::shared_ptr<const AdminTableMap>(std::move(tables)));
+}
+
+void AdminManager::PutAdmin(AdminTable &table, std::shared_ptr<Admin> admin)
+{
+    if (admin->adminInfo_.adminType_ == AdminType::ENT) {
+        table.superAdminCount++;
+    }
+    auto iter = table.index.find(admin->adminInfo_.packageName_);
+    if (iter == table.index.end()) {
+        table.index.emplace(admin->adminInfo_.packageName_, table.admins.size());
+        table.admins.push_back(std::move(admin));
+        return;
+    }
+    /* an admin activated again keeps its position in the list */
+    std::shared_ptr<Admin> &item = table.admins[iter->second];
+    if (item->adminInfo_.adminType_ == AdminType::ENT) {
+        table.superAdminCount--;
+    }
+    item = std::move(admin);
+}
+
+bool AdminManager::EraseAdmin(AdminTable &table, const std::string &packageName)
+{
+    auto iter = table.index.find(packageName);
+    if (iter == table.index.end()) {
+        return false;
+    }
+    std::size_t pos = iter->second;
+    if (table.admins[pos]->adminInfo_.adminType_ == AdminType::ENT) {
+        table.superAdminCount--;
+    }
+    table.index.erase(iter);
+    table.admins.erase(table.admins.begin() + pos);
+    /* only the admins behind the removed one move */
+    for (std::size_t i = pos; i < table.admins.size(); ++i) {
+        table.index[table.admins[i]->adminInfo_.packageName_] = i;
+    }
+    return true;
+}
+
+void AdminManager::BuildActiveAdmins(AdminTable &table)
+{
+    std::array<std::shared_ptr<ActiveAdminList>, AdminType::UNKNOWN> activeAdmins;
+    for (auto &activeAdmin : activeAdmins) {
+        activeAdmin = std::make_shared<ActiveAdminList>();
+    }
+    for (const auto &item : table.admins) {
+        AdminType role = item->adminInfo_.adminType_;
+        if (role >= AdminType::NORMAL && role < AdminType::UNKNOWN) {
+            activeAdmins[role]->push_back(Str8ToStr16(item->adminInfo_.packageName_ + "/" +
+                item->adminInfo_.className_));
+        }
+    }
+    std::copy(activeAdmins.begin(), activeAdmins.end(), table.activeAdmins.begin());
+}
+
+std::shared_ptr<Admin> AdminManager::CreateAdmin(AdminType role)
+{
+    if (role == AdminType::ENT) {
+        return std::make_shared<SuperAdmin>();
+    }
+    return std::make_shared<Admin>();
+}
+
+// the caller holds adminsMutex_
+int32_t AdminManager::FindAdminUserLocked(const std::string &packageName, int32_t userId)
+{
+    if (userId == DEFAULT_USER_ID || FindUserLocked(userId)->index.count(packageName) != 0) {
+        return userId;
+    }
+    /* the admins of the default user are admins of every user */
+    if (LoadUserLocked(DEFAULT_USER_ID)->index.count(packageName) != 0) {
+        return DEFAULT_USER_ID;
+    }
+    return userId;
+}
+
+ErrCode AdminManager::UpdateAdminInfo(const std::string &packageName, int32_t userId,
+    const std::function<void(AdminInfo &)> &update)
+{
+    std::lock_guard<std::mutex> lock(adminsMutex_);
+    userId = FindAdminUserLocked(packageName, userId);
+    auto admins = std::make_shared<AdminTable>(*FindUserLocked(userId));
+    auto iter = admins->index.find(packageName);
+    if (iter == admins->index.end()) {
+        return ERR_EDM_UNKNOWN_ADMIN;
+    }
+    /* the published admin may be in use by a reader, the change is made on a copy */
+    std::shared_ptr<Admin> &item = admins->admins[iter->second];
+    std::shared_ptr<Admin> adminItem = CreateAdmin(item->adminInfo_.adminType_);
+    adminItem->adminInfo_ = item->adminInfo_;
+    update(adminItem->adminInfo_);
+    bool isNameChanged = (adminItem->adminInfo_.className_ != item->adminInfo_.className_);
+    item = std::move(adminItem);
+    if (isNameChanged) {
+        BuildActiveAdmins(*admins);
+    }
+    PublishAdmins(userId, admins);
+    SaveAdmin(userId, *admins, packageName);
+    return ERR_OK;
 }
 
 ErrCode AdminManager::GetReqPermission(const std::vector<std::string> &permissions,
@@ -59,7 +242,7 @@ ErrCode AdminManager::GetReqPermission(const std::vector<std::string> &permissio
 }
 
 ErrCode AdminManager::SetAdminValue(AppExecFwk::AbilityInfo &abilityInfo, EntInfo &entInfo, AdminType role,
-    std::vector<std::string> &permissions)
+    std::vector<std::string> &permissions, int32_t userId)
 {
     std::vector<AdminPermission> reqPermission;
     std::vector<std::string> permissionNames;
@@ -74,57 +257,148 @@ ErrCode AdminManager::SetAdminValue(AppExecFwk::AbilityInfo &abilityInfo, EntInf
         permissionNames.push_back(it.permissionName);
     }
 
-    std::shared_ptr<Admin> adminItem = GetAdminByPkgName(abilityInfo.bundleName);
-    if (adminItem == nullptr) {
-        if (role == NORMAL) {
-            admins_.emplace_back(std::make_shared<Admin>());
-        } else {
-            admins_.emplace_back(std::make_shared<SuperAdmin>());
-        }
-        adminItem = admins_.back();
-    }
+    std::shared_ptr<Admin> adminItem = CreateAdmin(role);
     adminItem->adminInfo_.adminType_ = role;
     adminItem->adminInfo_.entInfo_ = entInfo;
     adminItem->adminInfo_.permission_ = permissionNames;
+    PermissionManager::GetInstance()->GetPermissionBits(permissionNames, adminItem->adminInfo_.permissionBits_);
     adminItem->adminInfo_.packageName_ = abilityInfo.bundleName;
     adminItem->adminInfo_.className_ = abilityInfo.name;
-    SaveAdmin();
+
+    std::lock_guard<std::mutex> lock(adminsMutex_);
+    /* the super admin manages the whole device, it is saved with the admins of the default user */
+    int32_t adminUserId = (role == AdminType::ENT) ? DEFAULT_USER_ID : userId;
+    if (adminUserId != userId && FindUserLocked(userId)->index.count(abilityInfo.bundleName) != 0) {
+        auto userAdmins = std::make_shared<AdminTable>(*LoadUserLocked(userId));
+        EraseAdmin(*userAdmins, abilityInfo.bundleName);
+        BuildActiveAdmins(*userAdmins);
+        PublishAdmins(userId, userAdmins);
+        SaveAdmin(userId, *userAdmins, abilityInfo.bundleName);
+    }
+    auto admins = std::make_shared<AdminTable>(*LoadUserLocked(adminUserId));
+    PutAdmin(*admins, std::move(adminItem));
+    BuildActiveAdmins(*admins);
+    PublishAdmins(adminUserId, admins);
+    SaveAdmin(adminUserId, *admins, abilityInfo.bundleName);
     return ERR_OK;
 }
 
-void AdminManager::GetAllAdmin(std::vector<std::shared_ptr<Admin>> &allAdmin)
+/*
+ * The policies are saved by package name, so a package is the admin of one user only. The super admin is an
+ * admin of every user, it is saved with DEFAULT_USER_ID and an admin of the user is moved there on activation.
+ */
+bool AdminManager::IsAdminOfOtherUser(const std::string &packageName, AdminType role, int32_t userId)
 {
-    allAdmin = admins_;
+    std::lock_guard<std::mutex> lock(adminsMutex_);
+    auto tables = std::atomic_load(&admins_);
+    std::vector<int32_t> userIds;
+    GetRecordUsers(userIds);
+    for (const auto &table : *tables) {
+        userIds.push_back(table.first);
+    }
+    std::sort(userIds.begin(), userIds.end());
+    userIds.erase(std::unique(userIds.begin(), userIds.end()), userIds.end());
+    for (int32_t otherUserId : userIds) {
+        if (otherUserId == userId || (role == AdminType::ENT && otherUserId == DEFAULT_USER_ID)) {
+            continue;
+        }
+        auto iter = tables->find(otherUserId);
+        AdminType otherRole = AdminType::UNKNOWN;
+        if (iter != tables->end()) {
+            auto adminIter = iter->second->index.find(packageName);
+            if (adminIter != iter->second->index.end()) {
+                otherRole = iter->second->admins[adminIter->second]->adminInfo_.adminType_;
+            }
+        } else {
+            /* a stopped user is read from its record file without loading it */
+            otherRole = ReadAdminRole(otherUserId, packageName);
+        }
+        if (otherRole != AdminType::UNKNOWN && (otherUserId != DEFAULT_USER_ID || otherRole != AdminType::ENT)) {
+            EDMLOGW("IsAdminOfOtherUser: %{public}s is an admin of user %{public}d", packageName.c_str(),
+                otherUserId);
+            return true;
+        }
+    }
+    return false;
 }
 
-std::shared_ptr<Admin> AdminManager::GetAdminByPkgName(const std::string &packageName)
+// the admin type of the package in the record file of the user, UNKNOWN if it is not an admin there
+AdminType AdminManager::ReadAdminRole(int32_t userId, const std::string &packageName)
 {
-    for (auto &item : admins_) {
-        if (item->adminInfo_.packageName_ == packageName) {
-            return item;
+    AdminTable admins;
+    AdminRecordStore recordStore(GetRecordPath(userId));
+    recordStore.Read([this, &packageName, &admins](const AdminRecord &record) {
+        if (record.packageName == packageName) {
+            ReadAdminRecord(record, admins);
         }
-    }
-    EDMLOGD("GetAdminByPkgName:get admin failed. admin size= %{public}u, packageName= %{public}s",
-        (uint32_t)admins_.size(), packageName.c_str());
-    return nullptr;
+    });
+    auto iter = admins.index.find(packageName);
+    return (iter == admins.index.end()) ? AdminType::UNKNOWN : admins.admins[iter->second]->adminInfo_.adminType_;
 }
 
-ErrCode AdminManager::DeleteAdmin(const std::string &packageName)
+// the users with a record file, they may not be loaded
+void AdminManager::GetRecordUsers(std::vector<int32_t> &userIds)
 {
-    ErrCode retCode;
-    auto iter = admins_.begin();
-    while (iter != admins_.end()) {
-        if ((*iter)->adminInfo_.packageName_ == packageName) {
-            iter = admins_.erase(iter);
-            retCode = ERR_OK;
-        } else {
-            iter++;
+    DIR *dir = opendir(EDM_ADMIN_RECORD_DIR.c_str());
+    if (dir == nullptr) {
+        EDMLOGW("GetRecordUsers: open %{public}s failed", EDM_ADMIN_RECORD_DIR.c_str());
+        return;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name.size() <= EDM_ADMIN_USER_RECORD_NAME.size() + EDM_ADMIN_USER_RECORD_SUFFIX.size() ||
+            name.compare(0, EDM_ADMIN_USER_RECORD_NAME.size(), EDM_ADMIN_USER_RECORD_NAME) != 0 ||
+            name.compare(name.size() - EDM_ADMIN_USER_RECORD_SUFFIX.size(), std::string::npos,
+            EDM_ADMIN_USER_RECORD_SUFFIX) != 0) {
+            continue;
+        }
+        std::string userName = name.substr(EDM_ADMIN_USER_RECORD_NAME.size(),
+            name.size() - EDM_ADMIN_USER_RECORD_NAME.size() - EDM_ADMIN_USER_RECORD_SUFFIX.size());
+        int32_t userId = 0;
+        if (StrToInt(userName, userId) && std::to_string(userId) == userName) {
+            userIds.push_back(userId);
         }
     }
-    if (SUCCEEDED(retCode)) {
+    closedir(dir);
+}
+
+void AdminManager::GetAllAdmin(std::vector<std::shared_ptr<Admin>> &allAdmin, int32_t userId)
+{
+    allAdmin = LoadAdmins(userId)->admins;
+}
+
+std::shared_ptr<Admin> AdminManager::GetAdminByPkgName(const std::string &packageName, int32_t userId)
+{
+    /* it is called on every policy request, a missing admin is logged by the caller */
+    auto admins = LoadAdmins(userId);
+    auto iter = admins->index.find(packageName);
+    if (iter != admins->index.end()) {
+        return admins->admins[iter->second];
+    }
+    if (userId == DEFAULT_USER_ID) {
+        return nullptr;
+    }
+    /* the admins of the default user are admins of every user */
+    admins = LoadAdmins(DEFAULT_USER_ID);
+    iter = admins->index.find(packageName);
+    if (iter == admins->index.end()) {
+        return nullptr;
+    }
+    return admins->admins[iter->second];
+}
+
+ErrCode AdminManager::DeleteAdmin(const std::string &packageName, int32_t userId)
+{
+    std::lock_guard<std::mutex> lock(adminsMutex_);
+    userId = FindAdminUserLocked(packageName, userId);
+    auto admins = std::make_shared<AdminTable>(*FindUserLocked(userId));
+    if (EraseAdmin(*admins, packageName)) {
+        BuildActiveAdmins(*admins);
+        PublishAdmins(userId, admins);
         EDMLOGD("SaveAdmin %{public}s", packageName.c_str());
-        SaveAdmin();
-        return retCode;
+        SaveAdmin(userId, *admins, packageName);
+        return ERR_OK;
     }
 
     EDMLOGW("delete admin (%{public}s) failed!", packageName.c_str());
@@ -158,9 +432,10 @@ ErrCode AdminManager::GetGrantedPermission(AppExecFwk::AbilityInfo &abilityInfo,
     return ERR_OK;
 }
 
-ErrCode AdminManager::UpdateAdmin(AppExecFwk::AbilityInfo &abilityInfo, const std::vector<std::string> &permissions)
+ErrCode AdminManager::UpdateAdmin(AppExecFwk::AbilityInfo &abilityInfo, const std::vector<std::string> &permissions,
+    int32_t userId)
 {
-    auto adminItem = GetAdminByPkgName(abilityInfo.bundleName);
+    auto adminItem = GetAdminByPkgName(abilityInfo.bundleName, userId);
     if (adminItem == nullptr) {
         EDMLOGW("UpdateAdmin: get null admin, never get here");
         return ERR_EDM_UNKNOWN_ADMIN;
@@ -173,62 +448,69 @@ ErrCode AdminManager::UpdateAdmin(AppExecFwk::AbilityInfo &abilityInfo, const st
         return ret;
     }
 
-    adminItem->adminInfo_.permission_ = combinePermission;
-    adminItem->adminInfo_.packageName_ = abilityInfo.bundleName;
-    adminItem->adminInfo_.className_ = abilityInfo.className;
-    SaveAdmin();
-    return ERR_OK;
+    return UpdateAdminInfo(abilityInfo.bundleName, userId, [&combinePermission, &abilityInfo](AdminInfo &adminInfo) {
+        adminInfo.permission_ = combinePermission;
+        PermissionManager::GetInstance()->GetPermissionBits(combinePermission, adminInfo.permissionBits_);
+        adminInfo.className_ = abilityInfo.className;
+    });
 }
 
 // success is returned as long as there is a super administrator
 bool AdminManager::IsSuperAdminExist()
 {
-    return std::any_of(admins_.begin(), admins_.end(),
-        [](const std::shared_ptr<Admin> &admin) { return admin->adminInfo_.adminType_ == AdminType::ENT; });
+    return LoadAdmins(DEFAULT_USER_ID)->superAdminCount > 0;
 }
 
 /*
  * There are different administrator types according to the input parameters.
  * Returns a list of package names
  */
-void AdminManager::GetActiveAdmin(AdminType role, std::vector<std::string> &packageNameList)
+void AdminManager::GetActiveAdmin(AdminType role, std::vector<std::string> &packageNameList, int32_t userId)
 {
-    EDMLOGD("AdminManager:GetActiveAdmin adminType: %{public}d , admin size: %{public}zu", role, admins_.size());
+    std::shared_ptr<const ActiveAdminList> activeAdmins = GetActiveAdminList(role, userId);
+    EDMLOGD("AdminManager:GetActiveAdmin adminType: %{public}d , admin size: %{public}zu", role,
+        activeAdmins->size());
     packageNameList.clear();
-    if (role >= AdminType::UNKNOWN || role < AdminType::NORMAL) {
-        EDMLOGD("there is no admin(%{public}u) device manager package name list!", role);
-        return;
+    for (const auto &activeAdmin : *activeAdmins) {
+        packageNameList.push_back(Str16ToStr8(activeAdmin));
     }
+}
 
-    for (auto &item : admins_) {
-        if (item->adminInfo_.adminType_ == role) {
-            std::string adminName = item->adminInfo_.packageName_ + "/" + item->adminInfo_.className_;
-            packageNameList.push_back(adminName);
-        }
+std::shared_ptr<const ActiveAdminList> AdminManager::GetActiveAdminList(AdminType role, int32_t userId)
+{
+    static const auto emptyList = std::make_shared<const ActiveAdminList>();
+    if (role >= AdminType::UNKNOWN || role < AdminType::NORMAL) {
+        return emptyList;
+    }
+    auto defaultAdmins = LoadAdmins(DEFAULT_USER_ID);
+    if (role == AdminType::ENT || userId == DEFAULT_USER_ID) {
+        return defaultAdmins->activeAdmins[role];
     }
+    /* the normal admins of the default user are admins of every user, they are listed first */
+    auto admins = LoadAdmins(userId);
+    const auto &defaultList = defaultAdmins->activeAdmins[role];
+    const auto &userList = admins->activeAdmins[role];
+    if (defaultList->empty() || userList->empty()) {
+        return defaultList->empty() ? userList : defaultList;
+    }
+    auto activeAdmins = std::make_shared<ActiveAdminList>(*defaultList);
+    activeAdmins->insert(activeAdmins->end(), userList->begin(), userList->end());
+    return activeAdmins;
 }
 
-ErrCode AdminManager::GetEntInfo(const std::string &packageName, EntInfo &entInfo)
+ErrCode AdminManager::GetEntInfo(const std::string &packageName, EntInfo &entInfo, int32_t userId)
 {
-    for (auto &item : admins_) {
-        if (item->adminInfo_.packageName_ == packageName) {
-            entInfo = item->adminInfo_.entInfo_;
-            return ERR_OK;
-        }
+    std::shared_ptr<Admin> adminItem = GetAdminByPkgName(packageName, userId);
+    if (adminItem == nullptr) {
+        return ERR_EDM_UNKNOWN_ADMIN;
     }
-    return ERR_EDM_UNKNOWN_ADMIN;
+    entInfo = adminItem->adminInfo_.entInfo_;
+    return ERR_OK;
 }
 
-ErrCode AdminManager::SetEntInfo(const std::string &packageName, EntInfo &entInfo)
+ErrCode AdminManager::SetEntInfo(const std::string &packageName, EntInfo &entInfo, int32_t userId)
 {
-    for (auto &item : admins_) {
-        if (item->adminInfo_.packageName_ == packageName) {
-            item->adminInfo_.entInfo_ = entInfo;
-            SaveAdmin();
-            return ERR_OK;
-        }
-    }
-    return ERR_EDM_UNKNOWN_ADMIN;
+    return UpdateAdminInfo(packageName, userId, [&entInfo](AdminInfo &adminInfo) { adminInfo.entInfo_ = entInfo; });
 }
 
 // init
@@ -237,6 +519,36 @@ void AdminManager::Init()
     RestoreAdminFromFile();
 }
 
+void AdminManager::LoadUser(int32_t userId)
+{
+    LoadAdmins(userId);
+}
+
+void AdminManager::UnloadUser(int32_t userId)
+{
+    if (userId == DEFAULT_USER_ID) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(adminsMutex_);
+    auto tables = std::make_shared<AdminTableMap>(*std::atomic_load(&admins_));
+    if (tables->erase(userId) == 0) {
+        return;
+    }
+    /* a reader may still use the table, it is freed with the last reference */
+    std::atomic_store(&admins_, std::shared_ptr<const AdminTableMap>(std::move(tables)));
+    recordStores_.erase(userId);
+    EDMLOGI("AdminManager::UnloadUser user %{public}d", userId);
+}
+
+void AdminManager::GetLoadedUsers(std::vector<int32_t> &userIds)
+{
+    auto tables = std::atomic_load(&admins_);
+    userIds.clear();
+    for (const auto &table : *tables) {
+        userIds.push_back(table.first);
+    }
+}
+
 void FindPackageAndClass(const std::string &name, std::string &packageName, std::string &className)
 {
     std::size_t initPos = name.find('/', 0);
@@ -245,16 +557,14 @@ void FindPackageAndClass(const std::string &name, std::string &packageName, std:
     className = name.substr(initPos + 1, len - (initPos + 1));
 }
 
-void AdminManager::ReadJsonAdminType(Json::Value &admin)
+std::shared_ptr<Admin> AdminManager::ReadJsonAdminType(Json::Value &admin)
 {
     std::shared_ptr<Admin> activeAdmin;
-    if (admin["adminType"].asUInt() == AdminType::NORMAL) {
-        activeAdmin = std::make_shared<Admin>();
-    } else if (admin["adminType"].asUInt() == AdminType::ENT) {
-        activeAdmin = std::make_shared<SuperAdmin>();
+    if (admin["adminType"].asUInt() == AdminType::NORMAL || admin["adminType"].asUInt() == AdminType::ENT) {
+        activeAdmin = CreateAdmin(static_cast<AdminType>(admin["adminType"].asUInt()));
     } else {
         EDMLOGD("admin type is error!");
-        return;
+        return nullptr;
     }
 
     FindPackageAndClass(admin["name"].asString(), activeAdmin->adminInfo_.packageName_,
@@ -266,12 +576,12 @@ void AdminManager::ReadJsonAdminType(Json::Value &admin)
     for (unsigned int i = 0; i < adminSize; i++) {
         activeAdmin->adminInfo_.permission_.push_back(admin["permission"][i].asString()); // array
     }
-
-    // read admin and store it in vector container
-    admins_.push_back(activeAdmin);
+    PermissionManager::GetInstance()->GetPermissionBits(activeAdmin->adminInfo_.permission_,
+        activeAdmin->adminInfo_.permissionBits_);
+    return activeAdmin;
 }
 
-void AdminManager::ReadJsonAdmin(const std::string &filePath)
+void AdminManager::ReadJsonAdmin(const std::string &filePath, AdminTable &admins)
 {
     std::ifstream is(filePath);
     JSONCPP_STRING errs;
@@ -295,18 +605,46 @@ void AdminManager::ReadJsonAdmin(const std::string &filePath)
     EDMLOGD("AdminManager: size of %{public}u", lang.size());
 
     for (auto temp : lang) {
-        ReadJsonAdminType(temp);
+        std::shared_ptr<Admin> activeAdmin = ReadJsonAdminType(temp);
+        // read admin and store it in the admin table, the first entry of a package wins
+        if (activeAdmin == nullptr || admins.index.count(activeAdmin->adminInfo_.packageName_) != 0) {
+            continue;
+        }
+        PutAdmin(admins, std::move(activeAdmin));
     }
 }
 
-// read admin from file
+void AdminManager::ReadAdminRecord(const AdminRecord &record, AdminTable &admins)
+{
+    if (record.data.empty()) {
+        EraseAdmin(admins, record.packageName);
+        return;
+    }
+    Json::Value root;
+    JSONCPP_STRING errs;
+    Json::CharReaderBuilder readerBuilder;
+    const std::unique_ptr<Json::CharReader> reader(readerBuilder.newCharReader());
+    if (!reader->parse(record.data.data(), record.data.data() + record.data.size(), &root, &errs)) {
+        EDMLOGW("ReadAdminRecord: parse admin %{public}s failed", record.packageName.c_str());
+        return;
+    }
+    std::shared_ptr<Admin> activeAdmin = ReadJsonAdminType(root);
+    if (activeAdmin != nullptr) {
+        /* a changed admin keeps the position of its first record */
+        PutAdmin(admins, std::move(activeAdmin));
+    }
+}
+
+// read admin from file, only the default user is loaded, the other users are loaded on their first use
 void AdminManager::RestoreAdminFromFile()
 {
-    // admin information storage location
-    ReadJsonAdmin(EDM_ADMIN_JSON_FILE);
+    std::lock_guard<std::mutex> lock(adminsMutex_);
+    std::atomic_store(&admins_, std::shared_ptr<const AdminTableMap>(std::make_shared<AdminTableMap>()));
+    recordStores_.clear();
+    LoadUserLocked(DEFAULT_USER_ID);
 }
 
-void AdminManager::WriteJsonAdminType(std::shared_ptr<Admin> &activeAdmin, Json::Value &tree)
+void AdminManager::WriteJsonAdminType(const std::shared_ptr<Admin> &activeAdmin, Json::Value &tree)
 {
     Json::Value entTree;
     Json::Value permissionTree;
@@ -324,43 +662,57 @@ void AdminManager::WriteJsonAdminType(std::shared_ptr<Admin> &activeAdmin, Json:
     tree["permission"] = permissionTree;
 }
 
-void AdminManager::WriteJsonAdmin(const std::string &filePath)
+std::string AdminManager::WriteAdminRecord(const std::shared_ptr<Admin> &activeAdmin)
 {
-    Json::Value root, tree, temp;
+    Json::Value tree;
+    WriteJsonAdminType(activeAdmin, tree);
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    return Json::writeString(builder, tree);
+}
 
-    EDMLOGD("WriteJsonAdmin start!  size = %{public}u  empty = %{public}d", (uint32_t)admins_.size(), admins_.empty());
-    // structure of each admin
-    for (std::uint32_t i = 0; i < admins_.size(); i++) {
-        WriteJsonAdminType(admins_.at(i), temp);
-        tree.append(temp);
+// write the record of one admin to file, the record of a removed admin is a tombstone
+ErrCode AdminManager::SaveAdmin(int32_t userId, const AdminTable &admins, const std::string &packageName)
+{
+    AdminRecord record;
+    record.packageName = packageName;
+    auto iter = admins.index.find(packageName);
+    if (iter != admins.index.end()) {
+        record.data = WriteAdminRecord(admins.admins[iter->second]);
     }
-    // root
-    root["admin"] = tree;
-
-    double time1 = clock();
-    // write to file
-    std::ofstream ofs(filePath);
-    if (!ofs.is_open()) {
-        EDMLOGE("WriteJsonAdmin open admin policies file failed!");
-        return;
+    AdminRecordStore &recordStore = *recordStores_[userId];
+    ErrCode ret = recordStore.Put(record);
+    std::uint64_t recordCount = recordStore.GetRecordCount();
+    if (FAILED(ret) || (recordCount >= EDM_ADMIN_COMPACT_MIN_RECORDS &&
+        recordCount > EDM_ADMIN_COMPACT_RATIO * admins.admins.size())) {
+        /* the compaction writes every admin again, it also repairs a failed append and creates the file of a user */
+        return CompactAdmin(userId, admins);
     }
+    return ERR_OK;
+}
 
-    Json::StreamWriterBuilder builder;
-    builder["indentation"] = "    ";
-    const std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
-    writer->write(root, &ofs);
-    ofs.flush();
-    ofs.close();
-    double time2 = clock();
-    if (time1 != 0 && time2 != 0) {
-        EDMLOGD("WriteJsonAdmin spend time %{public}f", (time2 - time1) / CLOCKS_PER_SEC);
+ErrCode AdminManager::CompactAdmin(int32_t userId, const AdminTable &admins)
+{
+    std::vector<AdminRecord> records;
+    records.reserve(admins.admins.size());
+    for (const auto &item : admins.admins) {
+        records.push_back({item->adminInfo_.packageName_, WriteAdminRecord(item)});
     }
+    ErrCode ret = recordStores_[userId]->Compact(records);
+    if (FAILED(ret)) {
+        EDMLOGE("CompactAdmin: write admin record file failed");
+    }
+    return ret;
 }
 
-// write admin to file
-void AdminManager::SaveAdmin()
+std::uint64_t AdminManager::GetPersistedBytes()
 {
-    WriteJsonAdmin(EDM_ADMIN_JSON_FILE);
+    std::lock_guard<std::mutex> lock(adminsMutex_);
+    std::uint64_t writtenBytes = 0;
+    for (const auto &recordStore : recordStores_) {
+        writtenBytes += recordStore.second->GetWrittenBytes();
+    }
+    return writtenBytes;
 }
 } // namespace EDM
 } // namespace OHOS
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "admin_record_store.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <unistd.h>
+#include "edm_log.h"
+#include "file_utils.h"
+
+namespace OHOS {
+namespace EDM {
+constexpr std::uint32_t ADMIN_RECORD_MAGIC = 0x414D4445; /* "EDMA" */
+constexpr std::uint32_t ADMIN_RECORD_VERSION = 1;
+constexpr std::uint32_t MAX_ADMIN_RECORD_SIZE = 16 * 1024 * 1024;
+constexpr mode_t ADMIN_RECORD_FILE_MODE = 0600;
+const std::string ADMIN_RECORD_BAK_SUFFIX = ".bak";
+
+static void PutUint32(std::string &buffer, std::uint32_t value)
+{
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+static void PutString(std::string &buffer, const std::string &value)
+{
+    PutUint32(buffer, static_cast<std::uint32_t>(value.size()));
+    buffer.append(value);
+}
+
+static bool GetUint32(const std::string &buffer, std::size_t &pos, std::uint32_t &value)
+{
+    if (buffer.size() - pos < sizeof(value)) {
+        return false;
+    }
+    memcpy(&value, buffer.data() + pos, sizeof(value));
+    pos += sizeof(value);
+    return true;
+}
+
+static bool GetString(const std::string &buffer, std::size_t &pos, std::string &value)
+{
+    std::uint32_t length = 0;
+    if (!GetUint32(buffer, pos, length) || buffer.size() - pos < length) {
+        return false;
+    }
+    value.assign(buffer, pos, length);
+    pos += length;
+    return true;
+}
+
+static std::string EncodeHeader()
+{
+    std::string header;
+    PutUint32(header, ADMIN_RECORD_MAGIC);
+    PutUint32(header, ADMIN_RECORD_VERSION);
+    return header;
+}
+
+static bool EncodeRecord(const AdminRecord &record, std::string &buffer)
+{
+    std::string payload;
+    PutString(payload, record.packageName);
+    PutString(payload, record.data);
+    if (payload.size() > MAX_ADMIN_RECORD_SIZE) {
+        EDMLOGW("AdminRecordStore: record too large:%{public}zu", payload.size());
+        return false;
+    }
+    PutUint32(buffer, static_cast<std::uint32_t>(payload.size()));
+    PutUint32(buffer, FileUtils::Crc32(payload.data(), payload.size()));
+    buffer.append(payload);
+    return true;
+}
+
+static bool DecodeRecord(const std::string &payload, AdminRecord &record)
+{
+    std::size_t pos = 0;
+    return GetString(payload, pos, record.packageName) && GetString(payload, pos, record.data) &&
+        pos == payload.size();
+}
+
+AdminRecordStore::AdminRecordStore(const std::string &path) : path_(path) {}
+
+AdminRecordStore::~AdminRecordStore()
+{
+    Close();
+}
+
+bool AdminRecordStore::IsCreated()
+{
+    return access(path_.c_str(), F_OK) == 0;
+}
+
+ErrCode AdminRecordStore::Open()
+{
+    Close();
+    fd_ = open(path_.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+    if (fd_ < 0) {
+        EDMLOGE("AdminRecordStore::Open open record file failed, errno:%{public}d", errno);
+        return ERR_EDM_WRITE_ADMIN_RECORD_FAILED;
+    }
+    return ERR_OK;
+}
+
+void AdminRecordStore::Close()
+{
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+ErrCode AdminRecordStore::Load(const std::function<void(const AdminRecord &)> &apply)
+{
+    Close();
+    recordCount_ = 0;
+    std::size_t tornPos = std::string::npos;
+    ErrCode ret = Replay(apply, recordCount_, tornPos);
+    if (ret != ERR_OK) {
+        return ret;
+    }
+    if (tornPos != std::string::npos) {
+        /* only the last append can be interrupted, the records before it are complete */
+        EDMLOGW("AdminRecordStore::Load torn record at %{public}zu, drop the tail", tornPos);
+        truncate(path_.c_str(), static_cast<off_t>(tornPos));
+    }
+    EDMLOGI("AdminRecordStore::Load replayed %{public}llu records", static_cast<unsigned long long>(recordCount_));
+    return Open();
+}
+
+ErrCode AdminRecordStore::Read(const std::function<void(const AdminRecord &)> &apply) const
+{
+    std::uint64_t recordCount = 0;
+    std::size_t tornPos = std::string::npos;
+    return Replay(apply, recordCount, tornPos);
+}
+
+ErrCode AdminRecordStore::Replay(const std::function<void(const AdminRecord &)> &apply, std::uint64_t &recordCount,
+    std::size_t &tornPos) const
+{
+    std::ifstream ifs(path_, std::ifstream::binary);
+    if (!ifs.is_open()) {
+        EDMLOGE("AdminRecordStore::Replay open record file failed");
+        return ERR_EDM_WRITE_ADMIN_RECORD_FAILED;
+    }
+    std::string buffer((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    ifs.close();
+
+    std::size_t pos = 0;
+    std::uint32_t magic = 0;
+    std::uint32_t version = 0;
+    if (!GetUint32(buffer, pos, magic) || !GetUint32(buffer, pos, version) || magic != ADMIN_RECORD_MAGIC ||
+        version != ADMIN_RECORD_VERSION) {
+        EDMLOGE("AdminRecordStore::Replay unknown record file header");
+        return ERR_EDM_WRITE_ADMIN_RECORD_FAILED;
+    }
+    while (pos < buffer.size()) {
+        std::size_t recordPos = pos;
+        std::uint32_t length = 0;
+        std::uint32_t crc = 0;
+        AdminRecord record;
+        if (!GetUint32(buffer, pos, length) || !GetUint32(buffer, pos, crc) || length > MAX_ADMIN_RECORD_SIZE ||
+            buffer.size() - pos < length || FileUtils::Crc32(buffer.data() + pos, length) != crc ||
+            !DecodeRecord(buffer.substr(pos, length), record)) {
+            tornPos = recordPos;
+            break;
+        }
+        pos += length;
+        apply(record);
+        recordCount++;
+    }
+    return ERR_OK;
+}
+
+ErrCode AdminRecordStore::Put(const AdminRecord &record)
+{
+    std::string buffer;
+    if (fd_ < 0 || !EncodeRecord(record, buffer)) {
+        return ERR_EDM_WRITE_ADMIN_RECORD_FAILED;
+    }
+    if (!FileUtils::WriteAll(fd_, buffer) || fdatasync(fd_) != 0) {
+        EDMLOGE("AdminRecordStore::Put write record failed, errno:%{public}d", errno);
+        return ERR_EDM_WRITE_ADMIN_RECORD_FAILED;
+    }
+    recordCount_++;
+    writtenBytes_ += buffer.size();
+    return ERR_OK;
+}
+
+ErrCode AdminRecordStore::Compact(const std::vector<AdminRecord> &records)
+{
+    std::string buffer = EncodeHeader();
+    for (const auto &record : records) {
+        if (!EncodeRecord(record, buffer)) {
+            return ERR_EDM_WRITE_ADMIN_RECORD_FAILED;
+        }
+    }
+    std::string bakPath = path_ + ADMIN_RECORD_BAK_SUFFIX;
+    int fd = open(bakPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, ADMIN_RECORD_FILE_MODE);
+    if (fd < 0) {
+        EDMLOGE("AdminRecordStore::Compact open record file failed, errno:%{public}d", errno);
+        return ERR_EDM_WRITE_ADMIN_RECORD_FAILED;
+    }
+    /* the new file must be complete on the storage device before it replaces the old one */
+    bool isWriteSuccess = FileUtils::WriteAll(fd, buffer) && fdatasync(fd) == 0;
+    close(fd);
+    if (!isWriteSuccess || std::rename(bakPath.c_str(), path_.c_str()) != 0) {
+        EDMLOGE("AdminRecordStore::Compact write record file failed, errno:%{public}d", errno);
+        unlink(bakPath.c_str());
+        return ERR_EDM_WRITE_ADMIN_RECORD_FAILED;
+    }
+    if (!FileUtils::SyncDir(path_)) {
+        EDMLOGE("AdminRecordStore::Compact sync record dir failed, errno:%{public}d", errno);
+        return ERR_EDM_WRITE_ADMIN_RECORD_FAILED;
+    }
+    recordCount_ = records.size();
+    writtenBytes_ += buffer.size();
+    return Open();
+}
+
+std::uint64_t AdminRecordStore::GetRecordCount()
+{
+    return recordCount_;
+}
+
+std::uint64_t AdminRecordStore::GetWrittenBytes()
+{
+    return writtenBytes_;
+}
+} // namespace EDM
+} // namespace OHOS
@@ -16,29 +16,71 @@
 #include "enterprise_device_mgr_ability.h"
 #include <bundle_info.h>
 #include <bundle_mgr_interface.h>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
 #include <ipc_skeleton.h>
 #include <iservice_registry.h>
 #include <message_parcel.h>
 #include <permission/permission_kit.h>
+#include <pthread.h>
+#include <sstream>
 #include <string_ex.h>
 #include <system_ability.h>
 #include <system_ability_definition.h>
+#include <thread>
+#include <unistd.h>
 
 #include "accesstoken_kit.h"
 #include "bundle_mgr_proxy.h"
 #include "edm_log.h"
+#include "os_account_manager.h"
 #include "parameters.h"
 #include "plugin_manager.h"
+#include "policy_file_store.h"
 
 namespace OHOS {
 namespace EDM {
 const bool REGISTER_RESULT =
     SystemAbility::MakeAndRegisterAbility(EnterpriseDeviceMgrAbility::GetInstance().GetRefPtr());
+/* a burst of policies pushed during provisioning is written to the journal once */
+constexpr uint32_t POLICY_FLUSH_QUIET_WINDOW_MS = 200;
+constexpr uint32_t POLICY_FLUSH_MAX_DELAY_MS = 1000;
+/* a plugin library opening slower than the budget is reported, the parameter set to 0 disables the check */
+const std::string PLUGIN_LOAD_BUDGET_PARAM = "persist.edm.plugin_load_budget_ms";
+constexpr uint32_t DEFAULT_PLUGIN_LOAD_BUDGET_MS = 50;
+constexpr const char *STARTUP_THREAD_NAME = "edm_startup";
+constexpr int PROC_STAT_FIRST_FIELD_INDEX = 3;
+constexpr int PROC_STAT_START_TIME_INDEX = 22;
+const std::string PROC_STATUS_RSS_KEY = "VmRSS:";
+constexpr int64_t MS_PER_SECOND = 1000;
+constexpr int64_t NS_PER_MS = 1000000;
 
 std::mutex EnterpriseDeviceMgrAbility::mutexLock_;
 
 sptr<EnterpriseDeviceMgrAbility> EnterpriseDeviceMgrAbility::instance_;
 
+EnterpriseDeviceEventSubscriber::EnterpriseDeviceEventSubscriber(
+    const EventFwk::CommonEventSubscribeInfo &subscribeInfo, std::shared_ptr<AdminManager> adminMgr)
+    : EventFwk::CommonEventSubscriber(subscribeInfo), adminMgr_(adminMgr)
+{
+}
+
+void EnterpriseDeviceEventSubscriber::OnReceiveEvent(const EventFwk::CommonEventData &data)
+{
+    std::string action = data.GetWant().GetAction();
+    /* the user events carry the id of the user in the code */
+    int32_t userId = data.GetCode();
+    EDMLOGI("EnterpriseDeviceEventSubscriber::OnReceiveEvent %{public}s, user %{public}d", action.c_str(), userId);
+    if (action == EventFwk::CommonEventSupport::COMMON_EVENT_USER_SWITCHED) {
+        adminMgr_->LoadUser(userId);
+    } else if (action == EventFwk::CommonEventSupport::COMMON_EVENT_USER_STOPPED) {
+        adminMgr_->UnloadUser(userId);
+    }
+}
+
 sptr<EnterpriseDeviceMgrAbility> EnterpriseDeviceMgrAbility::GetInstance()
 {
     if (instance_ == nullptr) {
@@ -59,6 +101,9 @@ EnterpriseDeviceMgrAbility::EnterpriseDeviceMgrAbility() : SystemAbility(ENTERPR
 EnterpriseDeviceMgrAbility::~EnterpriseDeviceMgrAbility()
 {
     instance_ = nullptr;
+    if (startupThread_.joinable()) {
+        startupThread_.join();
+    }
 
     if (adminMgr_) {
         adminMgr_.reset();
@@ -74,40 +119,261 @@ EnterpriseDeviceMgrAbility::~EnterpriseDeviceMgrAbility()
     EDMLOGD("instance is destroyed");
 }
 
-void EnterpriseDeviceMgrAbility::OnDump() {}
+void EnterpriseDeviceMgrAbility::OnDump()
+{
+    adminLockStats_.Dump();
+    policyLockStats_.Dump();
+}
+
+/*
+ * The resident set size in kB, read from VmRSS in /proc/self/status.
+ */
+static int64_t GetProcessRssKb()
+{
+    std::ifstream ifs("/proc/self/status");
+    std::string line;
+    while (std::getline(ifs, line)) {
+        if (line.compare(0, PROC_STATUS_RSS_KEY.size(), PROC_STATUS_RSS_KEY) == 0) {
+            return static_cast<int64_t>(strtoll(line.c_str() + PROC_STATUS_RSS_KEY.size(), nullptr, 10));
+        }
+    }
+    return -1;
+}
+
+int EnterpriseDeviceMgrAbility::Dump(int fd, const std::vector<std::u16string> &args)
+{
+    std::lock_guard<std::mutex> lock(readyMutex_);
+    dprintf(fd, "ready: %d\n", ready_ ? 1 : 0);
+    for (const auto &stage : startupStages_) {
+        dprintf(fd, "startup %s: %" PRId64 " ms\n", stage.first.c_str(), stage.second);
+    }
+    dprintf(fd, "rss at ready: %" PRId64 " kB, now: %" PRId64 " kB\n", readyRssKb_, GetProcessRssKb());
+    dprintf(fd, "admin lock: acquire %" PRIu64 ", contended %" PRIu64 ", wait %" PRIu64 " us\n",
+        adminLockStats_.GetAcquireCount(), adminLockStats_.GetContendedCount(), adminLockStats_.GetWaitTimeUs());
+    dprintf(fd, "policy lock: acquire %" PRIu64 ", contended %" PRIu64 ", wait %" PRIu64 " us\n",
+        policyLockStats_.GetAcquireCount(), policyLockStats_.GetContendedCount(), policyLockStats_.GetWaitTimeUs());
+    dprintf(fd, "policy reply cache: hit %" PRIu64 ", miss %" PRIu64 "\n", replyCache_.GetHitCount(),
+        replyCache_.GetMissCount());
+    dprintf(fd, "admin change subscribers: %zu\n", adminChangeNotifier_.GetSubscriberCount());
+    if (pluginMgr_ != nullptr) {
+        std::size_t libraryCount = 0;
+        std::size_t openedCount = 0;
+        pluginMgr_->GetLibraryCount(libraryCount, openedCount);
+        dprintf(fd, "plugin libraries: %zu, opened %zu\n", libraryCount, openedCount);
+        std::vector<PluginLoadTime> loadTimes;
+        std::size_t overBudgetCount = pluginMgr_->GetLoadTimes(loadTimes);
+        dprintf(fd, "plugin libraries over load budget: %zu\n", overBudgetCount);
+        for (const auto &loadTime : loadTimes) {
+            if (loadTime.loadUs < 0) {
+                continue;
+            }
+            dprintf(fd, "plugin load %s: %" PRId64 " us%s\n", loadTime.library.c_str(), loadTime.loadUs,
+                loadTime.overBudget ? ", over budget" : "");
+            for (const auto &initTime : loadTime.initTimes) {
+                dprintf(fd, "plugin init %u: %" PRId64 " us\n", initTime.code, initTime.initUs);
+            }
+        }
+    }
+    if (adminMgr_ != nullptr) {
+        std::vector<int32_t> userIds;
+        adminMgr_->GetLoadedUsers(userIds);
+        dprintf(fd, "admin users loaded:");
+        for (int32_t userId : userIds) {
+            dprintf(fd, " %d", userId);
+        }
+        dprintf(fd, "\n");
+    }
+    if (policyMgr_ != nullptr) {
+        PolicyPersistStats persistStats;
+        policyMgr_->GetPersistStats(persistStats);
+        dprintf(fd, "policy persist: queue %" PRIu64 ", max queue %" PRIu64 ", backpressure %" PRIu64 "\n",
+            persistStats.queueDepth, persistStats.maxQueueDepth, persistStats.backpressureCount);
+        dprintf(fd, "policy persist: flush %" PRIu64 ", failed %" PRIu64 ", last %" PRIu64 " us, max %" PRIu64
+            " us, total %" PRIu64 " us\n", persistStats.flushCount, persistStats.failedFlushCount,
+            persistStats.lastFlushLatencyUs, persistStats.maxFlushLatencyUs, persistStats.totalFlushLatencyUs);
+    }
+    return ERR_OK;
+}
+
+/*
+ * The time since sa_main was launched, read from the start time in /proc/self/stat.
+ */
+static int64_t GetProcessAgeMs()
+{
+    std::ifstream ifs("/proc/self/stat");
+    std::string stat;
+    std::getline(ifs, stat);
+    /* the process name may contain spaces, the fields are counted from its closing parenthesis */
+    std::size_t pos = stat.rfind(')');
+    if (pos == std::string::npos) {
+        return -1;
+    }
+    std::istringstream fields(stat.substr(pos + 1));
+    std::string field;
+    /* the first field after the name is the third field of the stat */
+    for (int i = PROC_STAT_FIRST_FIELD_INDEX; i <= PROC_STAT_START_TIME_INDEX; ++i) {
+        if (!(fields >> field)) {
+            return -1;
+        }
+    }
+    long ticksPerSecond = sysconf(_SC_CLK_TCK);
+    struct timespec now = {};
+    if (ticksPerSecond <= 0 || clock_gettime(CLOCK_BOOTTIME, &now) != 0) {
+        return -1;
+    }
+    int64_t startMs = static_cast<int64_t>(strtoull(field.c_str(), nullptr, 10)) * MS_PER_SECOND / ticksPerSecond;
+    return static_cast<int64_t>(now.tv_sec) * MS_PER_SECOND + now.tv_nsec / NS_PER_MS - startMs;
+}
+
+void EnterpriseDeviceMgrAbility::RecordStartupStage(const std::string &stage,
+    std::chrono::steady_clock::time_point begin)
+{
+    int64_t elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+    EDMLOGI("EnterpriseDeviceMgrAbility startup %{public}s spend %{public}" PRId64 " ms", stage.c_str(), elapsedMs);
+    std::lock_guard<std::mutex> lock(readyMutex_);
+    startupStages_.emplace_back(stage, elapsedMs);
+}
+
+void EnterpriseDeviceMgrAbility::WaitReady()
+{
+    std::unique_lock<std::mutex> lock(readyMutex_);
+    readyCond_.wait(lock, [this]() { return ready_; });
+    if (!firstRequestRecorded_) {
+        firstRequestRecorded_ = true;
+        startupStages_.emplace_back("launch_to_first_request", GetProcessAgeMs());
+    }
+}
+
+int32_t EnterpriseDeviceMgrAbility::OnRemoteRequest(uint32_t code, MessageParcel &data, MessageParcel &reply,
+    MessageOption &option)
+{
+    /* the service is published before the managers are initialized, early requests wait here */
+    WaitReady();
+    return EnterpriseDeviceMgrStub::OnRemoteRequest(code, data, reply, option);
+}
+
+std::mutex &EnterpriseDeviceMgrAbility::GetPolicyLock(uint32_t policyCode)
+{
+    return policyLocks_[policyCode % POLICY_LOCK_NUM];
+}
 
 void EnterpriseDeviceMgrAbility::OnStart()
 {
     EDMLOGD("EnterpriseDeviceMgrAbility::OnStart() Publish");
+    /* Dump is not held by the readiness latch, the managers are set before the service is published */
+    if (!adminMgr_) {
+        adminMgr_ = AdminManager::GetInstance();
+    }
+    if (!policyMgr_) {
+        policyMgr_ = PolicyManager::GetInstance();
+    }
+    if (!pluginMgr_) {
+        pluginMgr_ = PluginManager::GetInstance();
+    }
+    EDMLOGD("create adminMgr_, policyMgr_ and pluginMgr_ success");
     if (!registerToService_) {
         if (!Publish(this)) {
             EDMLOGE("EnterpriseDeviceMgrAbility: res == false");
             return;
         }
         registerToService_ = true;
-    }
-    if (!adminMgr_) {
-        adminMgr_ = AdminManager::GetInstance();
-    }
-    EDMLOGD("create adminMgr_ success");
-    adminMgr_->Init();
+        /* the managers are initialized once, OnStart returns and the early requests wait on the readiness latch */
+        startupThread_ = std::thread([this]() {
+            pthread_setname_np(pthread_self(), STARTUP_THREAD_NAME);
+            InitManagers();
+        });
+    }
+    /* the user events can only be subscribed once the common event service is started */
+    AddSystemAbilityListener(COMMON_EVENT_SERVICE_ID);
+}
 
-    if (!policyMgr_) {
-        policyMgr_ = PolicyManager::GetInstance();
+void EnterpriseDeviceMgrAbility::OnAddSystemAbility(int32_t systemAbilityId, const std::string &deviceId)
+{
+    EDMLOGD("OnAddSystemAbility systemAbilityId:%{public}d added!", systemAbilityId);
+    if (systemAbilityId == COMMON_EVENT_SERVICE_ID) {
+        SubscribeUserEvent();
     }
-    EDMLOGD("create policyMgr_ success");
-    policyMgr_->Init();
+}
 
-    if (!pluginMgr_) {
-        pluginMgr_ = PluginManager::GetInstance();
+void EnterpriseDeviceMgrAbility::SubscribeUserEvent()
+{
+    if (userEventSubscriber_ != nullptr) {
+        return;
+    }
+    EventFwk::MatchingSkills skill;
+    skill.AddEvent(EventFwk::CommonEventSupport::COMMON_EVENT_USER_SWITCHED);
+    skill.AddEvent(EventFwk::CommonEventSupport::COMMON_EVENT_USER_STOPPED);
+    EventFwk::CommonEventSubscribeInfo info(skill);
+    auto subscriber = std::make_shared<EnterpriseDeviceEventSubscriber>(info, adminMgr_);
+    if (!EventFwk::CommonEventManager::SubscribeCommonEvent(subscriber)) {
+        EDMLOGE("SubscribeUserEvent: subscribe user event failed");
+        return;
+    }
+    userEventSubscriber_ = subscriber;
+}
+
+int32_t EnterpriseDeviceMgrAbility::GetCallingUserId()
+{
+    int32_t userId = DEFAULT_USER_ID;
+    if (AccountSA::OsAccountManager::GetOsAccountLocalIdFromUid(GetCallingUid(), userId) != ERR_OK ||
+        userId < DEFAULT_USER_ID) {
+        /* the native callers such as hdcd run as the system user, they manage the default user */
+        return DEFAULT_USER_ID;
     }
-    EDMLOGD("create pluginMgr_ success");
-    pluginMgr_->Init();
+    return userId;
+}
+
+void EnterpriseDeviceMgrAbility::InitManagers()
+{
+    auto begin = std::chrono::steady_clock::now();
+    /*
+     * The three managers don't depend on each other until the first request, they are loaded in parallel
+     * and every stage is timed on its own thread.
+     */
+    std::thread adminThread([this]() {
+        auto stageBegin = std::chrono::steady_clock::now();
+        adminMgr_->Init();
+        RecordStartupStage("admin", stageBegin);
+    });
+    std::thread policyThread([this]() {
+        auto stageBegin = std::chrono::steady_clock::now();
+        /* only the combined policies are enforced at boot, the admin policies are decoded when used */
+        auto policyStore = std::make_shared<PolicyFileStore>();
+        policyStore->SetLazyLoad(true);
+        policyMgr_->SetPolicyStore(policyStore);
+        policyMgr_->Init();
+        policyMgr_->SetCoalescing(POLICY_FLUSH_QUIET_WINDOW_MS, POLICY_FLUSH_MAX_DELAY_MS);
+        RecordStartupStage("policy", stageBegin);
+    });
+    std::thread pluginThread([this]() {
+        auto stageBegin = std::chrono::steady_clock::now();
+        pluginMgr_->SetLoadBudget(OHOS::system::GetIntParameter(PLUGIN_LOAD_BUDGET_PARAM,
+            DEFAULT_PLUGIN_LOAD_BUDGET_MS));
+        pluginMgr_->Init();
+        RecordStartupStage("plugin", stageBegin);
+    });
+    adminThread.join();
+    policyThread.join();
+    pluginThread.join();
+    RecordStartupStage("total", begin);
+
+    std::lock_guard<std::mutex> lock(readyMutex_);
+    startupStages_.emplace_back("launch_to_ready", GetProcessAgeMs());
+    readyRssKb_ = GetProcessRssKb();
+    ready_ = true;
+    readyCond_.notify_all();
 }
 
 void EnterpriseDeviceMgrAbility::OnStop()
 {
     EDMLOGD("EnterpriseDeviceMgrAbility::OnStop()");
+    if (startupThread_.joinable()) {
+        startupThread_.join();
+    }
+    if (policyMgr_) {
+        policyMgr_->Flush();
+    }
 }
 
 ErrCode EnterpriseDeviceMgrAbility::GetAllPermissionsByAdmin(const std::string &bundleInfoName,
@@ -180,9 +446,15 @@ bool EnterpriseDeviceMgrAbility::VerifyCallingPermission(const std::string &perm
     return true;
 }
 
-ErrCode EnterpriseDeviceMgrAbility::VerifyActiveAdminCondition(AppExecFwk::ElementName &admin, AdminType type)
+ErrCode EnterpriseDeviceMgrAbility::VerifyActiveAdminCondition(AppExecFwk::ElementName &admin, AdminType type,
+    int32_t userId)
 {
-    std::shared_ptr<Admin> existAdmin = adminMgr_->GetAdminByPkgName(admin.GetBundleName());
+    /* the policies are kept by package name, the same package can't be the admin of two users */
+    if (adminMgr_->IsAdminOfOtherUser(admin.GetBundleName(), type, userId)) {
+        EDMLOGW("ActiveAdmin: The package is an admin of another user.");
+        return ERR_EDM_ADD_ADMIN_FAILED;
+    }
+    std::shared_ptr<Admin> existAdmin = adminMgr_->GetAdminByPkgName(admin.GetBundleName(), userId);
     if (type == AdminType::ENT && adminMgr_->IsSuperAdminExist()) {
         if (existAdmin == nullptr || existAdmin->adminInfo_.adminType_ != AdminType::ENT) {
             EDMLOGW("ActiveAdmin: There is another super admin active.");
@@ -212,7 +484,6 @@ ErrCode EnterpriseDeviceMgrAbility::ActiveAdmin(AppExecFwk::ElementName &admin,
     int32_t userId)
 {
     EDMLOGD("EnterpriseDeviceMgrAbility::ActiveAdmin");
-    std::lock_guard<std::mutex> autoLock(mutexLock_);
     int32_t ret = CheckPermission();
     if (ret != ERR_OK) {
         EDMLOGW("EnterpriseDeviceMgrAbility::ActiveAdmin check permission failed, ret: %{public}d", ret);
@@ -231,11 +502,6 @@ ErrCode EnterpriseDeviceMgrAbility::ActiveAdmin(AppExecFwk::ElementName &admin,
         EDMLOGW("ActiveAdmin: GetAbilityInfoByName failed %{public}d", ret);
         return ERR_EDM_BMS_ERROR;
     }
-    ret = VerifyActiveAdminCondition(admin, type);
-    if (FAILED(ret)) {
-        EDMLOGW("ActiveAdmin: VerifyActiveAdminCondition failed.");
-        return ERR_EDM_ADD_ADMIN_FAILED;
-    }
 
     /* Get all request and registered permissions */
     std::vector<std::string> permissionList;
@@ -252,20 +518,36 @@ ErrCode EnterpriseDeviceMgrAbility::ActiveAdmin(AppExecFwk::ElementName &admin,
         return ERR_EDM_PERMISSION_ERROR;
     }
 
+    /* the bundle manager is queried above without the lock, only the admin list change is serialized */
+    std::unique_lock<std::shared_mutex> adminLock(adminLock_, std::defer_lock);
+    adminLockStats_.Acquire(adminLock);
+    ret = VerifyActiveAdminCondition(admin, type, userId);
+    if (FAILED(ret)) {
+        EDMLOGW("ActiveAdmin: VerifyActiveAdminCondition failed.");
+        return ERR_EDM_ADD_ADMIN_FAILED;
+    }
+    ret = adminMgr_->SetAdminValue(abilityInfo.at(0), entInfo, type, permissionList, userId);
+    if (FAILED(ret)) {
+        return ret;
+    }
     EDMLOGI("ActiveAdmin: SetAdminValue success %{public}s, type:%{public}d", admin.GetBundleName().c_str(),
         static_cast<uint32_t>(type));
-    return adminMgr_->SetAdminValue(abilityInfo.at(0), entInfo, type, permissionList);
+    NotifyAdminChange(AdminChangeType::ADMIN_ACTIVATED, admin.GetBundleName(), admin.GetAbilityName(), type,
+        userId);
+    return ERR_OK;
 }
 
 ErrCode EnterpriseDeviceMgrAbility::RemoveAdminItem(std::string adminName, std::string policyName,
-    std::string policyValue)
+    std::string policyValue, PolicyTransaction &transaction)
 {
     ErrCode ret;
-    std::shared_ptr<IPlugin> plugin = pluginMgr_->GetPluginByPolicyName(policyName);
+    const std::shared_ptr<IPlugin> &plugin = pluginMgr_->GetPluginByPolicyName(policyName);
     if (plugin == nullptr) {
         EDMLOGW("RemoveAdminItem: Get plugin by policy failed: %{public}s\n", policyName.c_str());
         return ERR_EDM_GET_PLUGIN_MGR_FAILED;
     }
+    std::unique_lock<std::mutex> policyLock(GetPolicyLock(plugin->GetCode()), std::defer_lock);
+    policyLockStats_.Acquire(policyLock);
     if ((ret = plugin->OnAdminRemove(adminName, policyValue)) != ERR_OK) {
         EDMLOGW("RemoveAdminItem: OnAdminRemove failed, admin:%{public}s, value:%{public}s, res:%{public}d\n",
             adminName.c_str(), policyValue.c_str(), ret);
@@ -281,9 +563,9 @@ ErrCode EnterpriseDeviceMgrAbility::RemoveAdminItem(std::string adminName, std::
         std::unordered_map<std::string, std::string> adminListMap;
         ret = policyMgr_->GetAdminByPolicyName(policyName, adminListMap);
         if ((ret == ERR_EDM_POLICY_NOT_FOUND) || adminListMap.empty()) {
-            setRet = policyMgr_->SetPolicy("", policyName, "", "");
+            setRet = transaction.SetPolicy("", policyName, "", "");
         } else {
-            setRet = policyMgr_->SetPolicy(adminName, policyName, "", mergedPolicyData);
+            setRet = transaction.SetPolicy(adminName, policyName, "", mergedPolicyData);
         }
 
         if (FAILED(setRet)) {
@@ -292,40 +574,66 @@ ErrCode EnterpriseDeviceMgrAbility::RemoveAdminItem(std::string adminName, std::
             return ERR_EDM_DEL_ADMIN_FAILED;
         }
     }
-    plugin->OnAdminRemoveDone(adminName, policyValue);
     return ERR_OK;
 }
 
-ErrCode EnterpriseDeviceMgrAbility::RemoveAdmin(const std::string &adminName)
+ErrCode EnterpriseDeviceMgrAbility::RemoveAdmin(const std::string &adminName, int32_t userId)
 {
     EDMLOGD("RemoveAdmin %{public}s", adminName.c_str());
+    std::shared_ptr<Admin> removed = adminMgr_->GetAdminByPkgName(adminName, userId);
     std::unordered_map<std::string, std::string> policyItems;
     policyMgr_->GetAllPolicyByAdmin(adminName, policyItems);
+    /* the policies of the admin are removed with one write to the storage, the caller holds adminLock_ */
+    PolicyTransaction transaction(policyMgr_);
     for (auto &policyItem : policyItems) {
         std::string policyItemName = policyItem.first;
         std::string policyItemValue = policyItem.second;
         EDMLOGD("RemoveAdmin: RemoveAdminItem policyName:%{public}s,policyValue:%{public}s", policyItemName.c_str(),
             policyItemValue.c_str());
-        if (RemoveAdminItem(adminName, policyItemName, policyItemValue) != ERR_OK) {
+        if (RemoveAdminItem(adminName, policyItemName, policyItemValue, transaction) != ERR_OK) {
             return ERR_EDM_DEL_ADMIN_FAILED;
         }
     }
-    if (adminMgr_->DeleteAdmin(adminName) != ERR_OK) {
+    if (FAILED(transaction.Commit())) {
+        EDMLOGW("RemoveAdmin: DeleteAdminPolicy failed, admin:%{public}s", adminName.c_str());
         return ERR_EDM_DEL_ADMIN_FAILED;
     }
+    for (auto &policyItem : policyItems) {
+        const std::shared_ptr<IPlugin> &plugin = pluginMgr_->GetPluginByPolicyName(policyItem.first);
+        if (plugin == nullptr) {
+            EDMLOGW("RemoveAdmin: Get plugin by policy failed: %{public}s\n", policyItem.first.c_str());
+            continue;
+        }
+        if (plugin->NeedSavePolicy()) {
+            replyCache_.Invalidate(plugin->GetCode());
+        }
+        plugin->OnAdminRemoveDone(adminName, policyItem.second);
+    }
+    /* the policies of the admin must be removed from the storage before the admin itself */
+    if (policyMgr_->Flush() != ERR_OK) {
+        EDMLOGW("RemoveAdmin: flush policies failed %{public}s", adminName.c_str());
+    }
+    if (adminMgr_->DeleteAdmin(adminName, userId) != ERR_OK) {
+        return ERR_EDM_DEL_ADMIN_FAILED;
+    }
+    if (removed != nullptr) {
+        NotifyAdminChange(AdminChangeType::ADMIN_DEACTIVATED, adminName, removed->adminInfo_.className_,
+            removed->adminInfo_.adminType_, userId);
+    }
     return ERR_OK;
 }
 
 ErrCode EnterpriseDeviceMgrAbility::DeactiveAdmin(AppExecFwk::ElementName &admin, int32_t userId)
 {
-    std::lock_guard<std::mutex> autoLock(mutexLock_);
     int32_t checkRet = CheckPermission();
     if (checkRet != ERR_OK) {
         EDMLOGW("EnterpriseDeviceMgrAbility::DeactiveAdmin check permission failed, ret: %{public}d", checkRet);
         return ERR_EDM_PERMISSION_ERROR;
     }
 
-    std::shared_ptr<Admin> adminPtr = adminMgr_->GetAdminByPkgName(admin.GetBundleName());
+    std::unique_lock<std::shared_mutex> adminLock(adminLock_, std::defer_lock);
+    adminLockStats_.Acquire(adminLock);
+    std::shared_ptr<Admin> adminPtr = adminMgr_->GetAdminByPkgName(admin.GetBundleName(), userId);
     if (adminPtr == nullptr) {
         return ERR_EDM_DEL_ADMIN_FAILED;
     }
@@ -334,7 +642,7 @@ ErrCode EnterpriseDeviceMgrAbility::DeactiveAdmin(AppExecFwk::ElementName &admin
         return ERR_EDM_PERMISSION_ERROR;
     }
 
-    return RemoveAdmin(admin.GetBundleName());
+    return RemoveAdmin(admin.GetBundleName(), userId);
 }
 
 bool EnterpriseDeviceMgrAbility::IsHdc()
@@ -373,7 +681,8 @@ ErrCode EnterpriseDeviceMgrAbility::CheckCallingUid(std::string &bundleName)
 
 ErrCode EnterpriseDeviceMgrAbility::DeactiveSuperAdmin(std::string &bundleName)
 {
-    std::lock_guard<std::mutex> autoLock(mutexLock_);
+    std::unique_lock<std::shared_mutex> adminLock(adminLock_, std::defer_lock);
+    adminLockStats_.Acquire(adminLock);
     std::shared_ptr<Admin> admin = adminMgr_->GetAdminByPkgName(bundleName);
     if (admin == nullptr) {
         return ERR_EDM_DEL_ADMIN_FAILED;
@@ -388,12 +697,11 @@ ErrCode EnterpriseDeviceMgrAbility::DeactiveSuperAdmin(std::string &bundleName)
         return ERR_EDM_PERMISSION_ERROR;
     }
 
-    return RemoveAdmin(bundleName);
+    return RemoveAdmin(bundleName, DEFAULT_USER_ID);
 }
 
 bool EnterpriseDeviceMgrAbility::IsSuperAdmin(std::string &bundleName)
 {
-    std::lock_guard<std::mutex> autoLock(mutexLock_);
     std::shared_ptr<Admin> admin = adminMgr_->GetAdminByPkgName(bundleName);
     if (admin == nullptr) {
         EDMLOGW("IsSuperAdmin: admin == nullptr.");
@@ -408,8 +716,7 @@ bool EnterpriseDeviceMgrAbility::IsSuperAdmin(std::string &bundleName)
 
 bool EnterpriseDeviceMgrAbility::IsAdminActive(AppExecFwk::ElementName &admin)
 {
-    std::lock_guard<std::mutex> autoLock(mutexLock_);
-    std::shared_ptr<Admin> existAdmin = adminMgr_->GetAdminByPkgName(admin.GetBundleName());
+    std::shared_ptr<Admin> existAdmin = adminMgr_->GetAdminByPkgName(admin.GetBundleName(), GetCallingUserId());
     if (existAdmin != nullptr) {
         EDMLOGD("IsAdminActive: get admin successed");
         return true;
@@ -420,23 +727,26 @@ bool EnterpriseDeviceMgrAbility::IsAdminActive(AppExecFwk::ElementName &admin)
 ErrCode EnterpriseDeviceMgrAbility::HandleDevicePolicy(uint32_t code, AppExecFwk::ElementName &admin,
     MessageParcel &data)
 {
-    std::shared_ptr<Admin> deviceAdmin = adminMgr_->GetAdminByPkgName(admin.GetBundleName());
+    std::shared_lock<std::shared_mutex> adminLock(adminLock_, std::defer_lock);
+    adminLockStats_.Acquire(adminLock);
+    std::shared_ptr<Admin> deviceAdmin = adminMgr_->GetAdminByPkgName(admin.GetBundleName(), GetCallingUserId());
     if (deviceAdmin == nullptr) {
         EDMLOGW("HandleDevicePolicy: get admin failed");
         return ERR_EDM_GET_ADMIN_MGR_FAILED;
     }
-    std::shared_ptr<IPlugin> plugin = pluginMgr_->GetPluginByFuncCode(code);
+    const std::shared_ptr<IPlugin> &plugin = pluginMgr_->GetPluginByFuncCode(code);
     if (plugin == nullptr) {
         EDMLOGW("HandleDevicePolicy: get plugin failed, code:%{public}d", code);
         return ERR_EDM_GET_PLUGIN_MGR_FAILED;
     }
     EDMLOGD("HandleDevicePolicy: plugin info:%{public}d , %{public}s , %{public}s", plugin->GetCode(),
         plugin->GetPolicyName().c_str(), plugin->GetPermission().c_str());
-    if (!deviceAdmin->CheckPermission(plugin->GetPermission())) {
+    if (!deviceAdmin->CheckPermissionId(plugin->GetPermissionId())) {
         EDMLOGW("HandleDevicePolicy: check permission failed");
         return ERR_EDM_PERMISSION_ERROR;
     }
-    std::lock_guard<std::mutex> autoLock(mutexLock_);
+    std::unique_lock<std::mutex> policyLock(GetPolicyLock(plugin->GetCode()), std::defer_lock);
+    policyLockStats_.Acquire(policyLock);
     std::string policyName = plugin->GetPolicyName();
     std::string policyValue = "";
     policyMgr_->GetPolicy(admin.GetBundleName(), policyName, policyValue);
@@ -459,6 +769,7 @@ ErrCode EnterpriseDeviceMgrAbility::HandleDevicePolicy(uint32_t code, AppExecFwk
             return ERR_EDM_HANDLE_POLICY_FAILED;
         }
         policyMgr_->SetPolicy(admin.GetBundleName(), policyName, policyValue, mergedPolicy);
+        replyCache_.Invalidate(plugin->GetCode());
         isGlobalChanged = (oldCombinePolicy != mergedPolicy);
     }
     plugin->OnHandlePolicyDone(code, admin.GetBundleName(), isGlobalChanged);
@@ -468,16 +779,18 @@ ErrCode EnterpriseDeviceMgrAbility::HandleDevicePolicy(uint32_t code, AppExecFwk
 ErrCode EnterpriseDeviceMgrAbility::GetDevicePolicy(uint32_t code, AppExecFwk::ElementName *admin,
     MessageParcel &reply)
 {
-    std::shared_ptr<IPlugin> plugin = pluginMgr_->GetPluginByFuncCode(code);
+    const std::shared_ptr<IPlugin> &plugin = pluginMgr_->GetPluginByFuncCode(code);
     if (plugin == nullptr) {
         EDMLOGW("GetDevicePolicy: get plugin failed");
         reply.WriteInt32(ERR_EDM_GET_PLUGIN_MGR_FAILED);
         return ERR_EDM_GET_PLUGIN_MGR_FAILED;
     }
+    if (admin == nullptr) {
+        return GetCombinedPolicy(plugin, reply);
+    }
     std::string policyName = plugin->GetPolicyName();
     std::string policyValue;
-    std::string adminName = (admin == nullptr) ? "" : admin->GetBundleName();
-    if (policyMgr_->GetPolicy(adminName, policyName, policyValue) != ERR_OK) {
+    if (policyMgr_->GetPolicy(admin->GetBundleName(), policyName, policyValue) != ERR_OK) {
         EDMLOGW("GetDevicePolicy: get policy failed");
         reply.WriteInt32(ERR_EDM_POLICY_NOT_FIND);
     } else {
@@ -488,39 +801,118 @@ ErrCode EnterpriseDeviceMgrAbility::GetDevicePolicy(uint32_t code, AppExecFwk::E
     return ERR_OK;
 }
 
-ErrCode EnterpriseDeviceMgrAbility::GetActiveAdmin(AdminType type, std::vector<std::string> &activeAdminList)
+ErrCode EnterpriseDeviceMgrAbility::GetCombinedPolicy(const std::shared_ptr<IPlugin> &plugin,
+    MessageParcel &reply)
+{
+    PolicyReply encodedPolicy;
+    std::uint64_t policyGeneration = 0;
+    if (GetEncodedCombinedPolicy(plugin, encodedPolicy, policyGeneration) != ERR_OK) {
+        EDMLOGW("GetDevicePolicy: get policy failed");
+        reply.WriteInt32(ERR_EDM_POLICY_NOT_FIND);
+        return ERR_OK;
+    }
+    reply.WriteInt32(ERR_OK);
+    reply.WriteBuffer(encodedPolicy->data(), encodedPolicy->size());
+    return ERR_OK;
+}
+
+/*
+ * The combined policy encoded by the plugin and the generation of the encoded value, it is copied from the
+ * reply cache or read, encoded and cached on a miss.
+ */
+ErrCode EnterpriseDeviceMgrAbility::GetEncodedCombinedPolicy(const std::shared_ptr<IPlugin> &plugin,
+    PolicyReply &encodedPolicy, std::uint64_t &policyGeneration)
+{
+    std::uint64_t generation = replyCache_.Get(plugin->GetCode(), encodedPolicy, policyGeneration);
+    if (encodedPolicy != nullptr) {
+        return ERR_OK;
+    }
+    std::string policyValue;
+    if (policyMgr_->GetPolicy("", plugin->GetPolicyName(), policyValue, policyGeneration) != ERR_OK) {
+        return ERR_EDM_POLICY_NOT_FIND;
+    }
+    /* the policy is encoded once into its own parcel, later reads copy the bytes until the policy changes */
+    MessageParcel encodedParcel;
+    bool cacheable = (plugin->WritePolicyToParcel(policyValue, encodedParcel) == ERR_OK);
+    const std::uint8_t *data = reinterpret_cast<const std::uint8_t *>(encodedParcel.GetData());
+    encodedPolicy = std::make_shared<const std::vector<std::uint8_t>>(data, data + encodedParcel.GetDataSize());
+    if (cacheable) {
+        replyCache_.Put(plugin->GetCode(), generation, policyGeneration, encodedPolicy);
+    }
+    return ERR_OK;
+}
+
+ErrCode EnterpriseDeviceMgrAbility::GetDevicePolicyIfModified(uint32_t code, AppExecFwk::ElementName *admin,
+    std::uint64_t generation, MessageParcel &reply)
+{
+    const std::shared_ptr<IPlugin> &plugin = pluginMgr_->GetPluginByFuncCode(code);
+    if (plugin == nullptr) {
+        EDMLOGW("GetDevicePolicyIfModified: get plugin failed");
+        reply.WriteInt32(ERR_EDM_GET_PLUGIN_MGR_FAILED);
+        return ERR_EDM_GET_PLUGIN_MGR_FAILED;
+    }
+    /* the value must be of the same table as the generation, the cached policy is kept with its generation */
+    ErrCode ret = ERR_OK;
+    std::uint64_t currentGeneration = 0;
+    PolicyReply encodedPolicy;
+    std::string policyValue;
+    if (admin == nullptr) {
+        ret = GetEncodedCombinedPolicy(plugin, encodedPolicy, currentGeneration);
+    } else {
+        ret = policyMgr_->GetPolicy(admin->GetBundleName(), plugin->GetPolicyName(), policyValue,
+            currentGeneration);
+    }
+    if (currentGeneration == generation) {
+        reply.WriteInt32(ERR_EDM_POLICY_NOT_MODIFIED);
+        reply.WriteUint64(currentGeneration);
+    } else if (ret != ERR_OK) {
+        reply.WriteInt32(ERR_EDM_POLICY_NOT_FIND);
+        reply.WriteUint64(currentGeneration);
+    } else {
+        reply.WriteInt32(ERR_OK);
+        reply.WriteUint64(currentGeneration);
+        if (encodedPolicy != nullptr) {
+            reply.WriteBuffer(encodedPolicy->data(), encodedPolicy->size());
+        } else {
+            plugin->WritePolicyToParcel(policyValue, reply);
+        }
+    }
+    return ERR_OK;
+}
+
+ErrCode EnterpriseDeviceMgrAbility::GetActiveAdmin(AdminType type, std::vector<std::u16string> &activeAdminList)
 {
-    std::vector<std::string> superList;
-    std::vector<std::string> normalList;
+    /* the lists are cached by AdminManager, the normal admins are listed before the super admins */
+    std::shared_ptr<const ActiveAdminList> superList;
+    std::shared_ptr<const ActiveAdminList> normalList;
     switch (type) {
         case AdminType::NORMAL:
-            adminMgr_->GetActiveAdmin(AdminType::NORMAL, normalList);
-            adminMgr_->GetActiveAdmin(AdminType::ENT, superList);
+            normalList = adminMgr_->GetActiveAdminList(AdminType::NORMAL, GetCallingUserId());
+            superList = adminMgr_->GetActiveAdminList(AdminType::ENT);
             break;
         case AdminType::ENT:
-            adminMgr_->GetActiveAdmin(AdminType::ENT, superList);
+            superList = adminMgr_->GetActiveAdminList(AdminType::ENT);
             break;
         case AdminType::UNKNOWN:
-            break;
+            return ERR_OK;
         default:
             return ERR_EDM_PARAM_ERROR;
     }
-    if (!superList.empty()) {
-        activeAdminList.insert(activeAdminList.begin(), superList.begin(), superList.end());
-    }
-    if (!normalList.empty()) {
-        activeAdminList.insert(activeAdminList.begin(), normalList.begin(), normalList.end());
-    }
-    for (const auto &activeAdmin : activeAdminList) {
-        EDMLOGD("GetActiveAdmin: %{public}s", activeAdmin.c_str());
+    std::size_t normalSize = (normalList == nullptr) ? 0 : normalList->size();
+    activeAdminList.clear();
+    activeAdminList.reserve(normalSize + superList->size());
+    if (normalList != nullptr) {
+        activeAdminList.insert(activeAdminList.end(), normalList->begin(), normalList->end());
     }
+    activeAdminList.insert(activeAdminList.end(), superList->begin(), superList->end());
+    EDMLOGD("GetActiveAdmin: type %{public}d, size %{public}zu", type, activeAdminList.size());
     return ERR_OK;
 }
 
 ErrCode EnterpriseDeviceMgrAbility::GetEnterpriseInfo(AppExecFwk::ElementName &admin, MessageParcel &reply)
 {
     EntInfo entInfo;
-    ErrCode code = adminMgr_->GetEntInfo(admin.GetBundleName(), entInfo);
+    ErrCode code = adminMgr_->GetEntInfo(admin.GetBundleName(), entInfo, GetCallingUserId());
     if (code != ERR_OK) {
         reply.WriteInt32(ERR_EDM_GET_ENTINFO_FAILED);
         return ERR_EDM_GET_ENTINFO_FAILED;
@@ -535,8 +927,10 @@ ErrCode EnterpriseDeviceMgrAbility::GetEnterpriseInfo(AppExecFwk::ElementName &a
 
 ErrCode EnterpriseDeviceMgrAbility::SetEnterpriseInfo(AppExecFwk::ElementName &admin, EntInfo &entInfo)
 {
-    std::lock_guard<std::mutex> autoLock(mutexLock_);
-    std::shared_ptr<Admin> adminItem = adminMgr_->GetAdminByPkgName(admin.GetBundleName());
+    std::unique_lock<std::shared_mutex> adminLock(adminLock_, std::defer_lock);
+    adminLockStats_.Acquire(adminLock);
+    int32_t userId = GetCallingUserId();
+    std::shared_ptr<Admin> adminItem = adminMgr_->GetAdminByPkgName(admin.GetBundleName(), userId);
     if (adminItem == nullptr) {
         return ERR_EDM_SET_ENTINFO_FAILED;
     }
@@ -545,8 +939,45 @@ ErrCode EnterpriseDeviceMgrAbility::SetEnterpriseInfo(AppExecFwk::ElementName &a
         EDMLOGW("SetEnterpriseInfo: CheckCallingUid failed: %{public}d", ret);
         return ERR_EDM_PERMISSION_ERROR;
     }
-    ErrCode code = adminMgr_->SetEntInfo(admin.GetBundleName(), entInfo);
-    return (code != ERR_OK) ? ERR_EDM_SET_ENTINFO_FAILED : ERR_OK;
+    ErrCode code = adminMgr_->SetEntInfo(admin.GetBundleName(), entInfo, userId);
+    if (code != ERR_OK) {
+        return ERR_EDM_SET_ENTINFO_FAILED;
+    }
+    NotifyAdminChange(AdminChangeType::ADMIN_ENT_INFO_CHANGED, admin.GetBundleName(),
+        adminItem->adminInfo_.className_, adminItem->adminInfo_.adminType_, userId);
+    return ERR_OK;
+}
+
+ErrCode EnterpriseDeviceMgrAbility::SubscribeAdminChange(const sptr<IRemoteObject> &callback)
+{
+    int32_t ret = CheckPermission();
+    if (ret != ERR_OK) {
+        EDMLOGW("EnterpriseDeviceMgrAbility::SubscribeAdminChange check permission failed, ret: %{public}d", ret);
+        return ERR_EDM_PERMISSION_ERROR;
+    }
+    return adminChangeNotifier_.Subscribe(callback, GetCallingUserId());
+}
+
+ErrCode EnterpriseDeviceMgrAbility::UnsubscribeAdminChange(const sptr<IRemoteObject> &callback)
+{
+    int32_t ret = CheckPermission();
+    if (ret != ERR_OK) {
+        EDMLOGW("EnterpriseDeviceMgrAbility::UnsubscribeAdminChange check permission failed, ret: %{public}d", ret);
+        return ERR_EDM_PERMISSION_ERROR;
+    }
+    return adminChangeNotifier_.Unsubscribe(callback);
+}
+
+void EnterpriseDeviceMgrAbility::NotifyAdminChange(AdminChangeType changeType, const std::string &bundleName,
+    const std::string &abilityName, AdminType adminType, int32_t userId)
+{
+    AdminChangeEvent event;
+    event.changeType = changeType;
+    event.bundleName = bundleName;
+    event.abilityName = abilityName;
+    event.adminType = adminType;
+    event.userId = userId;
+    adminChangeNotifier_.Notify(event);
 }
 } // namespace EDM
 } // namespace OHOS
\ No newline at end of file
@@ -43,6 +43,8 @@ void EnterpriseDeviceMgrStub::AddCallFuncMap()
     memberFuncMap_[SET_ENT_INFO] =  &EnterpriseDeviceMgrStub::SetEnterpriseInfoInner;
     memberFuncMap_[IS_SUPER_ADMIN] =  &EnterpriseDeviceMgrStub::IsSuperAdminInner;
     memberFuncMap_[IS_ADMIN_ACTIVE] =  &EnterpriseDeviceMgrStub::IsAdminActiveInner;
+    memberFuncMap_[SUBSCRIBE_ADMIN_CHANGE] = &EnterpriseDeviceMgrStub::SubscribeAdminChangeInner;
+    memberFuncMap_[UNSUBSCRIBE_ADMIN_CHANGE] = &EnterpriseDeviceMgrStub::UnsubscribeAdminChangeInner;
 }
 
 int32_t EnterpriseDeviceMgrStub::OnRemoteRequest(uint32_t code, MessageParcel &data, MessageParcel &reply,
@@ -70,6 +72,9 @@ int32_t EnterpriseDeviceMgrStub::OnRemoteRequest(uint32_t code, MessageParcel &d
         if (FUNC_TO_OPERATE(code) == static_cast<int>(FuncOperateType::GET)) {
             EDMLOGD("GetDevicePolicyInner");
             return GetDevicePolicyInner(code, data, reply);
+        } else if (FUNC_TO_OPERATE(code) == static_cast<int>(FuncOperateType::GET_IF_MODIFIED)) {
+            EDMLOGD("GetDevicePolicyIfModifiedInner");
+            return GetDevicePolicyIfModifiedInner(code, data, reply);
         } else {
             EDMLOGD("HandleDevicePolicyInner");
             return HandleDevicePolicyInner(code, data, reply);
@@ -158,6 +163,19 @@ ErrCode EnterpriseDeviceMgrStub::GetDevicePolicyInner(uint32_t code, MessageParc
     return retCode;
 }
 
+ErrCode EnterpriseDeviceMgrStub::GetDevicePolicyIfModifiedInner(uint32_t code, MessageParcel &data,
+    MessageParcel &reply)
+{
+    AppExecFwk::ElementName *admin = nullptr;
+    if (data.ReadInt32() != ERR_OK) {
+        admin = AppExecFwk::ElementName::Unmarshalling(data);
+    }
+    std::uint64_t generation = data.ReadUint64();
+    ErrCode retCode = GetDevicePolicyIfModified(code, admin, generation, reply);
+    delete admin;
+    return retCode;
+}
+
 ErrCode EnterpriseDeviceMgrStub::GetActiveAdminInner(MessageParcel &data, MessageParcel &reply)
 {
     EDMLOGD("EnterpriseDeviceMgrStub:GetActiveAdmin");
@@ -167,7 +185,7 @@ ErrCode EnterpriseDeviceMgrStub::GetActiveAdminInner(MessageParcel &data, Messag
         EDMLOGE("EnterpriseDeviceMgrStub:GetActiveAdminInner read type fail %{public}u", type);
         return ERR_EDM_PARAM_ERROR;
     }
-    std::vector<std::string> activeAdminList;
+    std::vector<std::u16string> activeAdminList;
     ErrCode res = GetActiveAdmin((AdminType)type, activeAdminList);
     if (FAILED(res)) {
         EDMLOGE("EnterpriseDeviceMgrStub:GetActiveAdmin failed:%{public}d", res);
@@ -175,9 +193,7 @@ ErrCode EnterpriseDeviceMgrStub::GetActiveAdminInner(MessageParcel &data, Messag
         return res;
     }
     reply.WriteInt32(ERR_OK);
-    std::vector<std::u16string> writeArray;
-    ArrayPolicyUtils::StringToU16String(activeAdminList, writeArray);
-    reply.WriteString16Vector(writeArray);
+    reply.WriteString16Vector(activeAdminList);
     return ERR_OK;
 }
 
@@ -220,6 +236,32 @@ ErrCode EnterpriseDeviceMgrStub::IsAdminActiveInner(MessageParcel &data, Message
     return ERR_OK;
 }
 
+ErrCode EnterpriseDeviceMgrStub::SubscribeAdminChangeInner(MessageParcel &data, MessageParcel &reply)
+{
+    EDMLOGD("EnterpriseDeviceMgrStub:SubscribeAdminChangeInner");
+    sptr<IRemoteObject> callback = data.ReadRemoteObject();
+    if (callback == nullptr) {
+        reply.WriteInt32(ERR_EDM_PARAM_ERROR);
+        return ERR_EDM_PARAM_ERROR;
+    }
+    ErrCode ret = SubscribeAdminChange(callback);
+    reply.WriteInt32(ret);
+    return ERR_OK;
+}
+
+ErrCode EnterpriseDeviceMgrStub::UnsubscribeAdminChangeInner(MessageParcel &data, MessageParcel &reply)
+{
+    EDMLOGD("EnterpriseDeviceMgrStub:UnsubscribeAdminChangeInner");
+    sptr<IRemoteObject> callback = data.ReadRemoteObject();
+    if (callback == nullptr) {
+        reply.WriteInt32(ERR_EDM_PARAM_ERROR);
+        return ERR_EDM_PARAM_ERROR;
+    }
+    ErrCode ret = UnsubscribeAdminChange(callback);
+    reply.WriteInt32(ret);
+    return ERR_OK;
+}
+
 ErrCode EnterpriseDeviceMgrStub::SetEnterpriseInfoInner(MessageParcel &data, MessageParcel &reply)
 {
     EDMLOGD("EnterpriseDeviceMgrStub:SetEnterpriseInfoInner");
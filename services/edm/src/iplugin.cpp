@@ -39,6 +39,16 @@ std::string IPlugin::GetPermission()
     return permission_;
 }
 
+std::uint32_t IPlugin::GetPermissionId()
+{
+    return permissionId_;
+}
+
+void IPlugin::SetPermissionId(std::uint32_t permissionId)
+{
+    permissionId_ = permissionId;
+}
+
 std::uint32_t IPlugin::GetCode()
 {
     return policyCode_;
@@ -47,7 +57,7 @@ std::uint32_t IPlugin::GetCode()
 ErrCode IPlugin::MergePolicyData(const std::string &adminName, std::string &mergeJsonData)
 {
     std::shared_ptr<PolicyManager> ptr = PolicyManager::GetInstance();
-    AdminValueItemsMap map;
+    AdminValueViewMap map;
     if (ptr != nullptr) {
         ptr->GetAdminByPolicyName(policyName_, map);
     }
@@ -25,20 +25,49 @@ PermissionManager::~PermissionManager()
     permissions_.clear();
 }
 
+const std::unordered_map<std::string, std::uint32_t> &PermissionManager::GetPermissionIds()
+{
+    static const std::unordered_map<std::string, std::uint32_t> permissionIds = []() {
+        std::unordered_map<std::string, std::uint32_t> ids;
+        std::uint32_t id = 0;
+        for (const auto &item : ADMIN_PERMISSIONS) {
+            ids.emplace(item.permissionName, id++);
+        }
+        return ids;
+    }();
+    return permissionIds;
+}
+
 ErrCode PermissionManager::AddPermission(const std::string &permission)
 {
-    for (const auto &item : ADMIN_PERMISSIONS) {
-        if (permission == item.permissionName) {
-            auto entry = permissions_.find(permission);
-            if (entry == permissions_.end()) {
-                permissions_.insert(std::make_pair(permission, item));
-            }
-            EDMLOGD("AddPermission::return ok");
-            return ERR_OK;
+    std::uint32_t permissionId = GetPermissionId(permission);
+    if (permissionId == EDM_INVALID_PERMISSION_ID) {
+        EDMLOGW("AddPermission::return unknow permission");
+        return ERR_EDM_UNKNOWN_PERMISSION;
+    }
+    std::unique_lock<std::shared_mutex> lock(permissionsLock_);
+    permissions_.emplace(permission, ADMIN_PERMISSIONS[permissionId]);
+    EDMLOGD("AddPermission::return ok");
+    return ERR_OK;
+}
+
+std::uint32_t PermissionManager::GetPermissionId(const std::string &permission)
+{
+    const auto &permissionIds = GetPermissionIds();
+    auto iter = permissionIds.find(permission);
+    return (iter == permissionIds.end()) ? EDM_INVALID_PERMISSION_ID : iter->second;
+}
+
+void PermissionManager::GetPermissionBits(const std::vector<std::string> &permissions,
+    PermissionBits &permissionBits)
+{
+    permissionBits.reset();
+    for (const auto &item : permissions) {
+        std::uint32_t permissionId = GetPermissionId(item);
+        if (permissionId != EDM_INVALID_PERMISSION_ID) {
+            permissionBits.set(permissionId);
         }
     }
-    EDMLOGW("AddPermission::return unknow permission");
-    return ERR_EDM_UNKNOWN_PERMISSION;
 }
 
 void PermissionManager::GetReqPermission(const std::vector<std::string> &permissions,
@@ -49,6 +78,7 @@ void PermissionManager::GetReqPermission(const std::vector<std::string> &permiss
         return;
     }
 
+    std::shared_lock<std::shared_mutex> lock(permissionsLock_);
     for (const auto &item : permissions) {
         auto entry = permissions_.find(item);
         if (entry != permissions_.end()) {
@@ -61,6 +91,7 @@ void PermissionManager::GetReqPermission(const std::vector<std::string> &permiss
     std::vector<EdmPermission> &reqPermission)
 {
     reqPermission.clear();
+    std::shared_lock<std::shared_mutex> lock(permissionsLock_);
     for (const auto &item : permissions) {
         auto entry = permissions_.find(item);
         if (entry != permissions_.end()) {
@@ -14,19 +14,53 @@
  */
 
 #include "plugin_manager.h"
+#include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <dirent.h>
 #include <dlfcn.h>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <mutex>
 #include <string_ex.h>
+#include <thread>
 #include <unistd.h>
 #include "edm_log.h"
+#include "json/json.h"
 #include "permission_manager.h"
 
 namespace OHOS {
 namespace EDM {
+namespace {
+const std::shared_ptr<IPlugin> NULL_PLUGIN;
+const std::string PLUGIN_INDEX_PATH = "/system/etc/edm_plugin/plugin_index.json";
+#ifdef _ARM64_
+const std::string PLUGIN_DIR = "/system/lib64/edm_plugin/";
+#else
+const std::string PLUGIN_DIR = "/system/lib/edm_plugin/";
+#endif
+/* the C library may serialize parts of dlopen on its loader lock, a few threads are enough to overlap the loads */
+constexpr std::uint32_t MAX_LOAD_THREAD_COUNT = 4;
+constexpr std::int64_t US_PER_MS = 1000;
+
+/*
+ * The plugins register themselves from the static initializers run by dlopen, on the thread opening their
+ * library. The context of that thread attributes the time between two registrations to the later plugin.
+ */
+struct LibraryLoadContext {
+    bool loading = false;
+    std::chrono::steady_clock::time_point mark;
+    std::vector<PluginInitTime> initTimes;
+};
+thread_local LibraryLoadContext g_loadContext;
+
+std::int64_t ElapsedUs(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+}
+}
+
 std::shared_ptr<PluginManager> PluginManager::instance_;
 std::mutex PluginManager::mutexLock_;
 
@@ -38,15 +72,18 @@ PluginManager::PluginManager()
 PluginManager::~PluginManager()
 {
     EDMLOGD("PluginManager::~PluginManager.");
-    for (auto entry : pluginsCode_) {
-        entry.second.reset();
-        entry.second = nullptr;
+    for (auto &page : pluginsCode_) {
+        page.store(nullptr);
     }
-    pluginsCode_.clear();
-    for (auto handle : pluginHandles_) {
-        dlclose(handle);
+    /* the plugins are released before the code of their libraries is unmapped */
+    pages_.clear();
+    pluginsName_.clear();
+    for (auto &library : libraries_) {
+        if (library.handle != nullptr) {
+            dlclose(library.handle);
+        }
     }
-    pluginHandles_.clear();
+    libraries_.clear();
 }
 
 std::shared_ptr<PluginManager> PluginManager::GetInstance()
@@ -60,29 +97,73 @@ std::shared_ptr<PluginManager> PluginManager::GetInstance()
     return instance_;
 }
 
-std::shared_ptr<IPlugin> PluginManager::GetPluginByFuncCode(std::uint32_t funcCode)
+const std::shared_ptr<IPlugin> &PluginManager::GetPluginByFuncCode(std::uint32_t funcCode)
 {
-    FuncCodeUtils::PrintFuncCode(funcCode);
-    FuncFlag flag = FuncCodeUtils::GetSystemFlag(funcCode);
-    if (flag == FuncFlag::POLICY_FLAG) {
-        std::uint32_t code = FuncCodeUtils::GetPolicyCode(funcCode);
-        EDMLOGD("PluginManager::code %{public}u", code);
-        auto it = pluginsCode_.find(code);
-        if (it != pluginsCode_.end()) {
-            return it->second;
+    if (EDMLOG_DEBUG_ENABLED()) {
+        FuncCodeUtils::PrintFuncCode(funcCode);
+    }
+    if (FuncCodeUtils::GetSystemFlag(funcCode) != FuncFlag::POLICY_FLAG) {
+        return NULL_PLUGIN;
+    }
+    return GetPluginByCode(FuncCodeUtils::GetPolicyCode(funcCode));
+}
+
+const std::shared_ptr<IPlugin> &PluginManager::GetPluginByPolicyName(const std::string &policyName)
+{
+    std::uint32_t code = 0;
+    {
+        std::shared_lock<std::shared_mutex> lock(pluginsNameLock_);
+        auto it = pluginsName_.find(policyName);
+        if (it == pluginsName_.end()) {
+            return NULL_PLUGIN;
         }
+        code = it->second;
+    }
+    return GetPluginByCode(code);
+}
+
+const std::shared_ptr<IPlugin> &PluginManager::GetPluginByCode(std::uint32_t code)
+{
+    DispatchPage *page = pluginsCode_[code >> DISPATCH_PAGE_BITS].load(std::memory_order_acquire);
+    if (page == nullptr) {
+        EDMLOGD("GetPluginByCode::no plugin of code %{public}u", code);
+        return NULL_PLUGIN;
+    }
+    PluginSlot &slot = (*page)[code & (DISPATCH_PAGE_SIZE - 1)];
+    if (slot.ready.load(std::memory_order_acquire)) {
+        return slot.plugin;
+    }
+    return LoadPluginOfSlot(code, slot);
+}
+
+const std::shared_ptr<IPlugin> &PluginManager::LoadPluginOfSlot(std::uint32_t code, PluginSlot &slot)
+{
+    if (slot.libraryIndex < 0) {
+        return NULL_PLUGIN;
     }
-    EDMLOGD("GetPluginByFuncCode::return nullptr");
-    return nullptr;
+    std::lock_guard<std::mutex> lock(loadLock_);
+    PluginLibrary &library = libraries_[slot.libraryIndex];
+    if (library.handle == nullptr && !library.failed) {
+        EDMLOGI("PluginManager::open %{public}s for code %{public}u", library.path.c_str(), code);
+        OpenLibrary(library);
+    }
+    if (!slot.ready.load(std::memory_order_acquire)) {
+        EDMLOGW("PluginManager::%{public}s does not register code %{public}u", library.path.c_str(), code);
+        return NULL_PLUGIN;
+    }
+    return slot.plugin;
 }
 
-std::shared_ptr<IPlugin> PluginManager::GetPluginByPolicyName(const std::string &policyName)
+PluginManager::PluginSlot &PluginManager::GetSlotLocked(std::uint32_t code)
 {
-    auto it = pluginsName_.find(policyName);
-    if (it != pluginsName_.end()) {
-        return it->second;
+    std::atomic<DispatchPage *> &pageEntry = pluginsCode_[code >> DISPATCH_PAGE_BITS];
+    DispatchPage *page = pageEntry.load(std::memory_order_relaxed);
+    if (page == nullptr) {
+        pages_.push_back(std::make_unique<DispatchPage>());
+        page = pages_.back().get();
+        pageEntry.store(page, std::memory_order_release);
     }
-    return nullptr;
+    return (*page)[code & (DISPATCH_PAGE_SIZE - 1)];
 }
 
 bool PluginManager::AddPlugin(std::shared_ptr<IPlugin> plugin)
@@ -91,63 +172,266 @@ bool PluginManager::AddPlugin(std::shared_ptr<IPlugin> plugin)
     if (plugin == nullptr) {
         return false;
     }
+    std::uint32_t code = plugin->GetCode();
+    if (code > FUNC_TO_POLICY(UINT32_MAX)) {
+        EDMLOGW("AddPlugin: policy code %{public}u out of range", code);
+        return false;
+    }
     ErrCode result = PermissionManager::GetInstance()->AddPermission(plugin->GetPermission());
     if (result == ERR_OK) {
-        pluginsCode_.insert(std::make_pair(plugin->GetCode(), plugin));
-        pluginsName_.insert(std::make_pair(plugin->GetPolicyName(), plugin));
+        plugin->SetPermissionId(PermissionManager::GetInstance()->GetPermissionId(plugin->GetPermission()));
+        std::lock_guard<std::mutex> lock(registerLock_);
+        PluginSlot &slot = GetSlotLocked(code);
+        if (!slot.ready.load(std::memory_order_relaxed)) {
+            if (!CheckDescriptor(slot, plugin)) {
+                return false;
+            }
+            slot.plugin = plugin;
+            slot.ready.store(true, std::memory_order_release);
+        }
+        std::unique_lock<std::shared_mutex> nameLock(pluginsNameLock_);
+        pluginsName_.emplace(plugin->GetPolicyName(), code);
+    }
+    if (g_loadContext.loading) {
+        auto now = std::chrono::steady_clock::now();
+        g_loadContext.initTimes.push_back({code, ElapsedUs(g_loadContext.mark, now)});
+        g_loadContext.mark = now;
     }
     return result;
 }
 
 void PluginManager::Init()
 {
+    std::size_t count = 0;
+    if (LoadIndex(PLUGIN_INDEX_PATH, PLUGIN_DIR, count)) {
+        EDMLOGI("PluginManager::Init %{public}zu plugins from index", count);
+        return;
+    }
     LoadPlugin();
 }
 
+/*
+ * The plugin index, written by the edm_plugin_index template from the descriptors of the plugin libraries:
+ * {"plugins": [{"library": "libxxx_plugin.z.so", "policies": [{"code": 1001, "name": "xxx",
+ * "permission": "ohos.permission.xxx", "need_save": true, "global": true}]}]}
+ * The codes and names are checked to be unique when the index is generated.
+ */
+bool PluginManager::LoadIndex(const std::string &indexPath, const std::string &pluginDir, std::size_t &pluginCount)
+{
+    pluginCount = 0;
+    std::ifstream ifs(indexPath);
+    if (!ifs.is_open()) {
+        EDMLOGW("PluginManager::LoadIndex open %{public}s fail.", indexPath.c_str());
+        return false;
+    }
+    Json::Value root;
+    JSONCPP_STRING errs;
+    Json::CharReaderBuilder readerBuilder;
+    if (!Json::parseFromStream(readerBuilder, ifs, &root, &errs) || !root.isObject() ||
+        !root["plugins"].isArray()) {
+        EDMLOGE("PluginManager::LoadIndex parse %{public}s fail.", indexPath.c_str());
+        return false;
+    }
+    for (const auto &descriptor : root["plugins"]) {
+        pluginCount += LoadDescriptor(descriptor, pluginDir);
+    }
+    return true;
+}
+
+std::size_t PluginManager::LoadDescriptor(const Json::Value &descriptor, const std::string &pluginDir)
+{
+    if (!descriptor.isObject() || !descriptor["library"].isString() || !descriptor["policies"].isArray()) {
+        EDMLOGE("PluginManager::LoadDescriptor invalid descriptor.");
+        return 0;
+    }
+    std::string library = descriptor["library"].asString();
+    if (library.empty() || library.find('/') != std::string::npos) {
+        EDMLOGE("PluginManager::LoadDescriptor invalid library %{public}s.", library.c_str());
+        return 0;
+    }
+    std::int32_t libraryIndex = 0;
+    {
+        std::lock_guard<std::mutex> lock(loadLock_);
+        libraryIndex = static_cast<std::int32_t>(libraries_.size());
+        libraries_.push_back({pluginDir + library});
+    }
+    std::size_t count = 0;
+    for (const auto &policy : descriptor["policies"]) {
+        if (!policy["code"].isUInt() || policy["code"].asUInt() > FUNC_TO_POLICY(UINT32_MAX) ||
+            !policy["name"].isString() || !policy["permission"].isString() ||
+            !policy["need_save"].isBool() || !policy["global"].isBool()) {
+            EDMLOGE("PluginManager::LoadDescriptor invalid policy of %{public}s.", library.c_str());
+            continue;
+        }
+        std::uint32_t code = policy["code"].asUInt();
+        std::string permission = policy["permission"].asString();
+        /* the permissions are known up front, an admin can be granted them before any plugin is opened */
+        if (PermissionManager::GetInstance()->AddPermission(permission) != ERR_OK) {
+            EDMLOGW("PluginManager::LoadDescriptor unknown permission %{public}s.", permission.c_str());
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(registerLock_);
+        PluginSlot &slot = GetSlotLocked(code);
+        if (slot.ready.load(std::memory_order_relaxed) || slot.libraryIndex >= 0) {
+            EDMLOGW("PluginManager::LoadDescriptor duplicate code %{public}u of %{public}s.", code, library.c_str());
+            continue;
+        }
+        slot.libraryIndex = libraryIndex;
+        slot.policyName = policy["name"].asString();
+        slot.permission = permission;
+        slot.needSave = policy["need_save"].asBool();
+        slot.global = policy["global"].asBool();
+        std::unique_lock<std::shared_mutex> nameLock(pluginsNameLock_);
+        pluginsName_.emplace(slot.policyName, code);
+        count++;
+    }
+    return count;
+}
+
+bool PluginManager::CheckDescriptor(const PluginSlot &slot, const std::shared_ptr<IPlugin> &plugin)
+{
+    if (slot.libraryIndex < 0) {
+        return true;
+    }
+    /* the policies are dispatched by the index before the library is opened, a differing plugin is not installed */
+    if (slot.policyName != plugin->GetPolicyName() || slot.permission != plugin->GetPermission() ||
+        slot.needSave != plugin->NeedSavePolicy() || slot.global != plugin->IsGlobalPolicy()) {
+        EDMLOGE("PluginManager::plugin %{public}s of code %{public}u differs from the plugin index, not installed.",
+            plugin->GetPolicyName().c_str(), plugin->GetCode());
+        return false;
+    }
+    return true;
+}
+
+void PluginManager::GetLibraryCount(std::size_t &libraryCount, std::size_t &openedCount)
+{
+    std::lock_guard<std::mutex> lock(loadLock_);
+    libraryCount = libraries_.size();
+    openedCount = 0;
+    for (const auto &library : libraries_) {
+        if (library.handle != nullptr) {
+            openedCount++;
+        }
+    }
+}
+
 void PluginManager::LoadPlugin()
 {
-#ifdef _ARM64_
-    std::string pluginDir = "/system/lib64/edm_plugin/";
-#else
-    std::string pluginDir = "/system/lib/edm_plugin/";
-#endif
-    DIR *dir = opendir(pluginDir.c_str());
+    DIR *dir = opendir(PLUGIN_DIR.c_str());
     if (dir == nullptr) {
         EDMLOGE("PluginManager::LoadPlugin open edm_plugin dir fail.");
         return;
     }
+    std::vector<PluginLibrary> libraries;
     struct dirent *entry;
     while ((entry = readdir(dir)) != nullptr) {
-        if (entry->d_type == DT_REG && strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
-            LoadPlugin(pluginDir + entry->d_name);
+        if (entry->d_type != DT_REG || strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
         }
+        libraries.push_back({PLUGIN_DIR + entry->d_name});
     }
     closedir(dir);
+
+    /* every thread takes the next library, a library is opened by one thread */
+    std::atomic<std::size_t> next {0};
+    auto loadLibraries = [this, &libraries, &next]() {
+        std::size_t index;
+        while ((index = next.fetch_add(1)) < libraries.size()) {
+            OpenLibrary(libraries[index]);
+        }
+    };
+    std::uint32_t threadCount = std::min({std::max(std::thread::hardware_concurrency(), 1U),
+        MAX_LOAD_THREAD_COUNT, static_cast<std::uint32_t>(libraries.size())});
+    std::vector<std::thread> threads;
+    for (std::uint32_t i = 1; i < threadCount; i++) {
+        threads.emplace_back(loadLibraries);
+    }
+    loadLibraries();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    std::lock_guard<std::mutex> lock(loadLock_);
+    for (auto &library : libraries) {
+        libraries_.push_back(std::move(library));
+    }
+}
+
+void PluginManager::OpenLibrary(PluginLibrary &library)
+{
+    auto begin = std::chrono::steady_clock::now();
+    g_loadContext = {true, begin, {}};
+    library.handle = LoadPlugin(library.path);
+    library.failed = (library.handle == nullptr);
+    library.loadUs = ElapsedUs(begin, std::chrono::steady_clock::now());
+    library.initTimes = std::move(g_loadContext.initTimes);
+    g_loadContext = {};
+    EDMLOGI("PluginManager::open %{public}s spend %{public}lld us, %{public}zu plugins", library.path.c_str(),
+        static_cast<long long>(library.loadUs), library.initTimes.size());
+    if (IsOverBudget(library.loadUs)) {
+        EDMLOGW("PluginManager::open %{public}s spend %{public}lld us, over the budget of %{public}u ms",
+            library.path.c_str(), static_cast<long long>(library.loadUs), loadBudgetMs_.load());
+        for (const auto &initTime : library.initTimes) {
+            EDMLOGW("PluginManager::plugin of code %{public}u init spend %{public}lld us", initTime.code,
+                static_cast<long long>(initTime.initUs));
+        }
+    }
+}
+
+bool PluginManager::IsOverBudget(std::int64_t loadUs)
+{
+    std::uint32_t budgetMs = loadBudgetMs_.load();
+    return budgetMs != 0 && loadUs > static_cast<std::int64_t>(budgetMs) * US_PER_MS;
+}
+
+void PluginManager::SetLoadBudget(std::uint32_t budgetMs)
+{
+    loadBudgetMs_.store(budgetMs);
 }
 
-void PluginManager::LoadPlugin(const std::string &pluginPath)
+std::size_t PluginManager::GetLoadTimes(std::vector<PluginLoadTime> &loadTimes)
+{
+    loadTimes.clear();
+    std::size_t overBudgetCount = 0;
+    std::lock_guard<std::mutex> lock(loadLock_);
+    for (const auto &library : libraries_) {
+        bool overBudget = IsOverBudget(library.loadUs);
+        loadTimes.push_back({library.path, library.loadUs, overBudget, library.initTimes});
+        if (overBudget) {
+            overBudgetCount++;
+        }
+    }
+    return overBudgetCount;
+}
+
+void *PluginManager::LoadPlugin(const std::string &pluginPath)
 {
     void *handle = dlopen(pluginPath.c_str(), RTLD_LAZY);
     if (!handle) {
         EDMLOGE("PluginManager::open plugin so fail. %{public}s.", dlerror());
-        return;
+        return nullptr;
     }
     char *szError = dlerror();
     if (szError != nullptr) {
         EDMLOGW("PluginManager::loading plugin fail. %{public}s.", szError);
     }
-    pluginHandles_.push_back(handle);
+    return handle;
 }
 
 void PluginManager::DumpPlugin()
 {
-    for (auto it = pluginsCode_.begin(); it != pluginsCode_.end(); it++) {
-        EDMLOGD("PluginManager::Dump plugins_code.code:%{public}u,name:%{public}s,permission:%{public}s",
-            it->first, it->second->GetPolicyName().c_str(), it->second->GetPermission().c_str());
+    std::lock_guard<std::mutex> lock(registerLock_);
+    for (const auto &page : pages_) {
+        for (const auto &slot : *page) {
+            if (slot.ready.load(std::memory_order_acquire)) {
+                EDMLOGD("PluginManager::Dump plugins_code.code:%{public}u,name:%{public}s,permission:%{public}s",
+                    slot.plugin->GetCode(), slot.plugin->GetPolicyName().c_str(),
+                    slot.plugin->GetPermission().c_str());
+            }
+        }
     }
+    std::shared_lock<std::shared_mutex> nameLock(pluginsNameLock_);
     for (auto it = pluginsName_.begin(); it != pluginsName_.end(); it++) {
-        EDMLOGD("PluginManager::Dump plugins_name.name:%{public}s,code:%{public}u,permission:%{public}s",
-            it->first.c_str(), it->second->GetCode(), it->second->GetPermission().c_str());
+        EDMLOGD("PluginManager::Dump plugins_name.name:%{public}s,code:%{public}u", it->first.c_str(), it->second);
     }
 }
 } // namespace EDM
@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "policy_file_store.h"
+#include <ctime>
+#include <unistd.h>
+#include "edm_log.h"
+#include "policy_json_converter.h"
+#include "policy_snapshot.h"
+
+namespace OHOS {
+namespace EDM {
+const std::string EDM_POLICY_FILE_DIR = "/data/system";
+const std::string EDM_POLICY_JSON_FILE_NAME = "/device_policies.json";
+const std::string EDM_POLICY_SNAPSHOT_FILE_NAME = "/device_policies.snapshot";
+const std::string EDM_POLICY_JOURNAL_FILE_NAME = "/device_policies.journal";
+const std::string EDM_POLICY_SHARD_DIR_NAME = "/device_policies";
+constexpr std::uint64_t EDM_POLICY_JOURNAL_CHECKPOINT_SIZE = 128 * 1024;
+
+PolicyFileStore::PolicyFileStore() : PolicyFileStore(EDM_POLICY_FILE_DIR) {}
+
+PolicyFileStore::PolicyFileStore(const std::string &dir)
+    : jsonPath_(dir + EDM_POLICY_JSON_FILE_NAME), snapshotPath_(dir + EDM_POLICY_SNAPSHOT_FILE_NAME),
+      journalPath_(dir + EDM_POLICY_JOURNAL_FILE_NAME),
+      shardStore_(std::make_unique<PolicyShardStore>(dir + EDM_POLICY_SHARD_DIR_NAME))
+{}
+
+PolicyFileStore::~PolicyFileStore()
+{
+    WaitCheckpoint();
+}
+
+void PolicyFileStore::SetLazyLoad(bool enable)
+{
+    lazyLoad_ = enable;
+}
+
+void PolicyFileStore::SetShardedLayout(bool enable)
+{
+    shardedLayout_ = enable;
+}
+
+ErrCode PolicyFileStore::Load(PolicyTable &table, std::uint64_t &sequence, bool &needFlush)
+{
+    WaitCheckpoint();
+    {
+        /* the first flush after loading writes every admin of the sharded layout */
+        std::lock_guard<std::mutex> lock(shardMutex_);
+        savedShardTable_.reset();
+    }
+    ErrCode ret = ERR_OK;
+    sequence = 0;
+    needFlush = true;
+    bool isShardCreated = shardStore_->IsCreated();
+    if (shardedLayout_ && isShardCreated) {
+        ret = shardStore_->Load(table, sequence);
+        needFlush = false;
+    } else if (access(snapshotPath_.c_str(), F_OK) == 0) {
+        ret = LoadSnapshot(table, sequence);
+        needFlush = shardedLayout_ && (ret == ERR_OK);
+    } else if (isShardCreated) {
+        EDMLOGI("PolicyFileStore::Load move policies from the sharded layout to the snapshot file\n");
+        ret = shardStore_->Load(table, sequence);
+        needFlush = (ret == ERR_OK);
+    } else if (access(jsonPath_.c_str(), F_OK) == 0) {
+        EDMLOGI("PolicyFileStore::Load import policies from json file\n");
+        ret = PolicyJsonConverter::ReadFile(jsonPath_, table, sequence);
+        needFlush = (ret == ERR_OK);
+    } else {
+        EDMLOGI("PolicyFileStore::Load create an empty snapshot file\n");
+    }
+    /* the files of the other layout are only removed once the policies are saved in the chosen one */
+    needRemoveUnused_ = needFlush;
+    if (ret == ERR_OK && !needFlush) {
+        RemoveUnusedFiles();
+    }
+    return ret;
+}
+
+ErrCode PolicyFileStore::LoadSnapshot(PolicyTable &table, std::uint64_t &sequence)
+{
+    double time1 = clock();
+    auto snapshot = std::make_shared<PolicySnapshot>();
+    ErrCode ret = snapshot->Open(snapshotPath_);
+    if (FAILED(ret)) {
+        EDMLOGE("LoadSnapshot: open snapshot failed:%{public}d\n", ret);
+        return ret;
+    }
+    sequence = snapshot->GetJournalSequence();
+    /* the sharded layout writes the admins from their items maps, they are decoded before being moved */
+    bool isLazy = lazyLoad_ && !shardedLayout_;
+    for (std::uint32_t i = 0; i < snapshot->GetAdminCount(); ++i) {
+        std::string adminName;
+        if (!snapshot->GetAdminName(i, adminName)) {
+            EDMLOGW("LoadSnapshot: admin %{public}u is damaged\n", i);
+            return ERR_EDM_POLICY_PARSE_JSON_FAILED;
+        }
+        if (isLazy) {
+            table.lazyAdmins[adminName] = i;
+            continue;
+        }
+        auto itemsMap = std::make_shared<PolicyValueMap>();
+        if (!snapshot->GetAdminPolicies(i, *itemsMap)) {
+            EDMLOGW("LoadSnapshot: admin %{public}s is damaged\n", adminName.c_str());
+            ret = ERR_EDM_POLICY_PARSE_JSON_FAILED;
+            continue;
+        }
+        if (!itemsMap->empty()) {
+            table.adminPolicies[adminName] = std::move(itemsMap);
+        }
+    }
+    if (!table.lazyAdmins.empty()) {
+        /* the snapshot stays mapped while any admin is not decoded */
+        table.snapshot = snapshot;
+    }
+    if (!snapshot->GetCombinedPolicies(table.combinedPolicies)) {
+        EDMLOGW("LoadSnapshot: combined policies are damaged\n");
+        return ERR_EDM_POLICY_PARSE_JSON_FAILED;
+    }
+    double time2 = clock();
+    EDMLOGI("LoadSnapshot spend time %{public}f", (time2 - time1) / CLOCKS_PER_SEC);
+    return ret;
+}
+
+void PolicyFileStore::RemoveUnusedFiles()
+{
+    /* the json file is only read once, the policies are kept in the chosen layout since then */
+    unlink(jsonPath_.c_str());
+    if (shardedLayout_) {
+        unlink(snapshotPath_.c_str());
+    } else {
+        shardStore_->Remove();
+    }
+}
+
+std::uint64_t PolicyFileStore::ReplayDelta(std::uint64_t sequence, const PolicyDeltaHandler &handler)
+{
+    journal_ = std::make_unique<PolicyJournal>(journalPath_);
+    std::uint64_t lastSequence = journal_->Replay(sequence, handler);
+    if (journal_->Open() != ERR_OK) {
+        EDMLOGW("ReplayDelta: open journal failed, fall back to rewrite the base version\n");
+    }
+    return lastSequence;
+}
+
+ErrCode PolicyFileStore::ApplyDelta(const std::vector<PolicyJournalRecord> &records, bool sync)
+{
+    if (journal_ == nullptr) {
+        /* nothing is loaded yet, the changes can only be saved by flushing the whole table */
+        return records.empty() ? ERR_OK : ERR_EDM_POLICY_WRITE_JOURNAL_FAILED;
+    }
+    ErrCode ret = ERR_OK;
+    if (!records.empty()) {
+        std::uint64_t writtenBytes = 0;
+        ret = journal_->Append(records, writtenBytes);
+        writtenBytes_ += writtenBytes;
+    }
+    if (ret == ERR_OK && sync) {
+        ret = journal_->Sync();
+    }
+    return ret;
+}
+
+ErrCode PolicyFileStore::Flush(const std::shared_ptr<const PolicyTable> &table, std::uint64_t sequence)
+{
+    WaitCheckpoint();
+    if (!WriteTable(table, sequence)) {
+        return ERR_EDM_POLICY_SET_FAILED;
+    }
+    if (journal_ != nullptr) {
+        journal_->Reset();
+    }
+    if (needRemoveUnused_) {
+        needRemoveUnused_ = false;
+        RemoveUnusedFiles();
+    }
+    return ERR_OK;
+}
+
+void PolicyFileStore::Checkpoint(const std::shared_ptr<const PolicyTable> &table, std::uint64_t sequence)
+{
+    if (journal_ == nullptr || journal_->GetSize() < EDM_POLICY_JOURNAL_CHECKPOINT_SIZE) {
+        return;
+    }
+    if (checkpointRunning_) {
+        /* the journal keeps growing until the running checkpoint is done */
+        return;
+    }
+    WaitCheckpoint();
+    if (journal_->HasRotated()) {
+        /* the last checkpoint failed, the rotated journal can only be dropped after a synchronous save */
+        EDMLOGW("Checkpoint: last checkpoint failed, save the base version synchronously\n");
+        if (WriteTable(table, sequence)) {
+            journal_->Reset();
+        }
+        return;
+    }
+    if (journal_->Rotate() != ERR_OK) {
+        return;
+    }
+    checkpointRunning_ = true;
+    /* the table is immutable, the checkpoint holds it instead of copying the policies */
+    checkpointThread_ = std::thread([this, sequence, table]() {
+        if (WriteTable(table, sequence)) {
+            journal_->RemoveRotated();
+        }
+        checkpointRunning_ = false;
+    });
+}
+
+void PolicyFileStore::WaitCheckpoint()
+{
+    if (checkpointThread_.joinable()) {
+        checkpointThread_.join();
+    }
+}
+
+std::uint64_t PolicyFileStore::GetWrittenBytes()
+{
+    return writtenBytes_;
+}
+
+std::shared_ptr<const PolicyTable> PolicyFileStore::DecodeTable(const std::shared_ptr<const PolicyTable> &table)
+{
+    if (table->lazyAdmins.empty()) {
+        return table;
+    }
+    /* the decoded copy is only used for writing, the published table stays lazy */
+    auto decodedTable = std::make_shared<PolicyTable>();
+    decodedTable->adminPolicies = table->adminPolicies;
+    decodedTable->combinedPolicies = table->combinedPolicies;
+    for (const auto &admin : table->lazyAdmins) {
+        auto itemsMap = std::make_shared<PolicyValueMap>();
+        if (!table->snapshot->GetAdminPolicies(admin.second, *itemsMap)) {
+            /* the index of the snapshot is checked when it is opened, never get here */
+            EDMLOGW("DecodeTable: admin %{public}s is damaged\n", admin.first.c_str());
+        }
+        if (!itemsMap->empty()) {
+            decodedTable->adminPolicies[admin.first] = std::move(itemsMap);
+        }
+    }
+    return decodedTable;
+}
+
+bool PolicyFileStore::WriteTable(const std::shared_ptr<const PolicyTable> &table, std::uint64_t sequence)
+{
+    auto decodedTable = DecodeTable(table);
+    double time1 = clock();
+    std::uint64_t writtenBytes = 0;
+    ErrCode ret = shardedLayout_ ? WriteShards(decodedTable, sequence, writtenBytes) :
+        PolicySnapshot::Write(snapshotPath_, sequence, *decodedTable, writtenBytes);
+    writtenBytes_ += writtenBytes;
+    if (FAILED(ret)) {
+        EDMLOGW("WriteTable write edm policy files failed:%{public}d\n", ret);
+        return false;
+    }
+    double time2 = clock();
+    EDMLOGI("WriteTable spend time %{public}f", (time2 - time1) / CLOCKS_PER_SEC);
+    return true;
+}
+
+ErrCode PolicyFileStore::WriteShards(const std::shared_ptr<const PolicyTable> &table, std::uint64_t sequence,
+    std::uint64_t &writtenBytes)
+{
+    std::lock_guard<std::mutex> lock(shardMutex_);
+    /* an admin changed since the last save has a new items map, the unchanged ones are shared by both tables */
+    std::shared_ptr<const PolicyTable> savedTable = savedShardTable_;
+    std::uint64_t fileBytes = 0;
+    ErrCode ret = ERR_OK;
+    for (const auto &admin : table->adminPolicies) {
+        if (savedTable != nullptr) {
+            auto iter = savedTable->adminPolicies.find(admin.first);
+            if (iter != savedTable->adminPolicies.end() && iter->second == admin.second) {
+                continue;
+            }
+        }
+        ret = shardStore_->WriteAdmin(admin.first, admin.second, sequence, fileBytes);
+        writtenBytes += fileBytes;
+        if (FAILED(ret)) {
+            return ret;
+        }
+    }
+    if (savedTable == nullptr) {
+        ret = shardStore_->RemoveStaleAdmins(*table);
+    } else {
+        for (const auto &admin : savedTable->adminPolicies) {
+            if (table->adminPolicies.find(admin.first) == table->adminPolicies.end()) {
+                /* the last policy of the admin is deleted, its file is unlinked */
+                ret = shardStore_->WriteAdmin(admin.first, nullptr, sequence, fileBytes);
+            }
+            if (FAILED(ret)) {
+                break;
+            }
+        }
+    }
+    if (FAILED(ret)) {
+        return ret;
+    }
+    /* the combined file holds the journal sequence, it is written after the admins of this save */
+    ret = shardStore_->WriteCombined(table->combinedPolicies, sequence, fileBytes);
+    writtenBytes += fileBytes;
+    if (FAILED(ret)) {
+        return ret;
+    }
+    if (savedTable == nullptr && !shardStore_->IsCreated()) {
+        ret = shardStore_->WriteManifest();
+        if (FAILED(ret)) {
+            return ret;
+        }
+    }
+    savedShardTable_ = table;
+    return ERR_OK;
+}
+} // namespace EDM
+} // namespace OHOS
@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "policy_journal.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "edm_log.h"
+#include "file_utils.h"
+
+namespace OHOS {
+namespace EDM {
+constexpr std::uint32_t JOURNAL_MAGIC = 0x4A4D4445; /* "EDMJ" */
+constexpr std::uint32_t JOURNAL_VERSION = 1;
+constexpr std::uint32_t RECORD_HEADER_SIZE = 2 * sizeof(std::uint32_t);
+constexpr std::uint32_t MAX_RECORD_SIZE = 64 * 1024 * 1024;
+constexpr mode_t JOURNAL_FILE_MODE = 0600;
+const std::string ROTATED_SUFFIX = ".old";
+
+static void PutUint32(std::string &buffer, std::uint32_t value)
+{
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+static void PutString(std::string &buffer, const std::string &value)
+{
+    PutUint32(buffer, static_cast<std::uint32_t>(value.size()));
+    buffer.append(value);
+}
+
+static bool GetUint32(const std::string &buffer, std::size_t &pos, std::uint32_t &value)
+{
+    if (buffer.size() - pos < sizeof(value)) {
+        return false;
+    }
+    memcpy(&value, buffer.data() + pos, sizeof(value));
+    pos += sizeof(value);
+    return true;
+}
+
+static bool GetString(const std::string &buffer, std::size_t &pos, std::string &value)
+{
+    std::uint32_t length = 0;
+    if (!GetUint32(buffer, pos, length) || buffer.size() - pos < length) {
+        return false;
+    }
+    value.assign(buffer, pos, length);
+    pos += length;
+    return true;
+}
+
+static bool DecodeRecord(const std::string &payload, PolicyJournalRecord &record)
+{
+    std::size_t pos = 0;
+    if (payload.size() < sizeof(record.sequence)) {
+        return false;
+    }
+    memcpy(&record.sequence, payload.data(), sizeof(record.sequence));
+    pos += sizeof(record.sequence);
+    return GetString(payload, pos, record.adminName) && GetString(payload, pos, record.policyName) &&
+        GetString(payload, pos, record.adminPolicy) && GetString(payload, pos, record.mergedPolicy) &&
+        pos == payload.size();
+}
+
+PolicyJournal::PolicyJournal(const std::string &path) : path_(path), rotatedPath_(path + ROTATED_SUFFIX) {}
+
+PolicyJournal::~PolicyJournal()
+{
+    Close();
+}
+
+ErrCode PolicyJournal::Open()
+{
+    Close();
+    fd_ = open(path_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, JOURNAL_FILE_MODE);
+    if (fd_ < 0) {
+        EDMLOGE("PolicyJournal::Open open journal failed, errno:%{public}d", errno);
+        return ERR_EDM_POLICY_WRITE_JOURNAL_FAILED;
+    }
+    struct stat fileStat = {};
+    if (fstat(fd_, &fileStat) != 0) {
+        Close();
+        return ERR_EDM_POLICY_WRITE_JOURNAL_FAILED;
+    }
+    size_ = static_cast<std::uint64_t>(fileStat.st_size);
+    if (size_ != 0) {
+        return ERR_OK;
+    }
+    /* a new journal, also after Rotate, the records synced later are lost if its entry is not durable */
+    ErrCode ret = WriteHeader();
+    if (ret == ERR_OK && (fdatasync(fd_) != 0 || !FileUtils::SyncDir(path_))) {
+        EDMLOGE("PolicyJournal::Open sync journal failed, errno:%{public}d", errno);
+        ret = ERR_EDM_POLICY_WRITE_JOURNAL_FAILED;
+    }
+    return ret;
+}
+
+void PolicyJournal::Close()
+{
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+ErrCode PolicyJournal::WriteHeader()
+{
+    std::string header;
+    PutUint32(header, JOURNAL_MAGIC);
+    PutUint32(header, JOURNAL_VERSION);
+    if (!FileUtils::WriteAll(fd_, header)) {
+        EDMLOGE("PolicyJournal::WriteHeader failed, errno:%{public}d", errno);
+        return ERR_EDM_POLICY_WRITE_JOURNAL_FAILED;
+    }
+    size_ = header.size();
+    return ERR_OK;
+}
+
+static bool EncodeRecord(const PolicyJournalRecord &record, std::string &buffer)
+{
+    std::string payload;
+    payload.append(reinterpret_cast<const char *>(&record.sequence), sizeof(record.sequence));
+    PutString(payload, record.adminName);
+    PutString(payload, record.policyName);
+    PutString(payload, record.adminPolicy);
+    PutString(payload, record.mergedPolicy);
+    if (payload.size() > MAX_RECORD_SIZE) {
+        EDMLOGW("PolicyJournal::Append record too large:%{public}zu", payload.size());
+        return false;
+    }
+    PutUint32(buffer, static_cast<std::uint32_t>(payload.size()));
+    PutUint32(buffer, FileUtils::Crc32(payload.data(), payload.size()));
+    buffer.append(payload);
+    return true;
+}
+
+ErrCode PolicyJournal::Append(const PolicyJournalRecord &record, std::uint64_t &writtenBytes)
+{
+    return Append(std::vector<PolicyJournalRecord>{record}, writtenBytes);
+}
+
+ErrCode PolicyJournal::Append(const std::vector<PolicyJournalRecord> &records, std::uint64_t &writtenBytes)
+{
+    writtenBytes = 0;
+    if (fd_ < 0) {
+        return ERR_EDM_POLICY_WRITE_JOURNAL_FAILED;
+    }
+    std::string buffer;
+    for (const auto &record : records) {
+        if (!EncodeRecord(record, buffer)) {
+            return ERR_EDM_POLICY_WRITE_JOURNAL_FAILED;
+        }
+    }
+    /* a single write keeps the records contiguous, a partial write is detected by the crc during replay */
+    if (!FileUtils::WriteAll(fd_, buffer)) {
+        EDMLOGE("PolicyJournal::Append write failed, errno:%{public}d", errno);
+        return ERR_EDM_POLICY_WRITE_JOURNAL_FAILED;
+    }
+    size_ += buffer.size();
+    writtenBytes = buffer.size();
+    return ERR_OK;
+}
+
+ErrCode PolicyJournal::Sync()
+{
+    if (fd_ < 0 || fdatasync(fd_) != 0) {
+        EDMLOGE("PolicyJournal::Sync failed, errno:%{public}d", errno);
+        return ERR_EDM_POLICY_WRITE_JOURNAL_FAILED;
+    }
+    return ERR_OK;
+}
+
+std::uint64_t PolicyJournal::Replay(std::uint64_t minSequence,
+    const std::function<void(const PolicyJournalRecord &)> &apply)
+{
+    std::uint64_t lastSequence = minSequence;
+    if (HasRotated()) {
+        lastSequence = std::max(lastSequence, ReplayFile(rotatedPath_, false, minSequence, apply));
+    }
+    return std::max(lastSequence, ReplayFile(path_, true, minSequence, apply));
+}
+
+std::uint64_t PolicyJournal::ReplayFile(const std::string &path, bool isActive, std::uint64_t minSequence,
+    const std::function<void(const PolicyJournalRecord &)> &apply)
+{
+    std::ifstream ifs(path, std::ifstream::binary);
+    if (!ifs.is_open()) {
+        return minSequence;
+    }
+    std::string buffer((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    ifs.close();
+
+    std::size_t pos = 0;
+    std::uint32_t magic = 0;
+    std::uint32_t version = 0;
+    if (!GetUint32(buffer, pos, magic) || !GetUint32(buffer, pos, version) || magic != JOURNAL_MAGIC ||
+        version != JOURNAL_VERSION) {
+        EDMLOGW("PolicyJournal::ReplayFile unknown journal header, ignore it");
+        if (isActive) {
+            truncate(path.c_str(), 0);
+        }
+        return minSequence;
+    }
+
+    std::uint64_t lastSequence = minSequence;
+    std::uint32_t replayed = 0;
+    while (pos < buffer.size()) {
+        std::size_t recordPos = pos;
+        std::uint32_t length = 0;
+        std::uint32_t crc = 0;
+        PolicyJournalRecord record;
+        if (!GetUint32(buffer, pos, length) || !GetUint32(buffer, pos, crc) || length > MAX_RECORD_SIZE ||
+            buffer.size() - pos < length || FileUtils::Crc32(buffer.data() + pos, length) != crc ||
+            !DecodeRecord(buffer.substr(pos, length), record)) {
+            EDMLOGW("PolicyJournal::ReplayFile torn record at %{public}zu, drop the tail", recordPos);
+            if (isActive) {
+                truncate(path.c_str(), static_cast<off_t>(recordPos));
+            }
+            break;
+        }
+        pos += length;
+        if (record.sequence <= minSequence) {
+            continue;
+        }
+        apply(record);
+        lastSequence = std::max(lastSequence, record.sequence);
+        replayed++;
+    }
+    EDMLOGI("PolicyJournal::ReplayFile %{public}s replayed %{public}u records", path.c_str(), replayed);
+    return lastSequence;
+}
+
+ErrCode PolicyJournal::Rotate()
+{
+    Close();
+    if (std::rename(path_.c_str(), rotatedPath_.c_str()) != 0) {
+        EDMLOGW("PolicyJournal::Rotate rename journal failed, errno:%{public}d", errno);
+        Open();
+        return ERR_EDM_POLICY_WRITE_JOURNAL_FAILED;
+    }
+    return Open();
+}
+
+ErrCode PolicyJournal::Reset()
+{
+    RemoveRotated();
+    if (fd_ < 0 || ftruncate(fd_, 0) != 0) {
+        EDMLOGW("PolicyJournal::Reset truncate journal failed, errno:%{public}d", errno);
+        return Open();
+    }
+    return WriteHeader();
+}
+
+void PolicyJournal::RemoveRotated()
+{
+    unlink(rotatedPath_.c_str());
+}
+
+bool PolicyJournal::HasRotated()
+{
+    return access(rotatedPath_.c_str(), F_OK) == 0;
+}
+
+std::uint64_t PolicyJournal::GetSize()
+{
+    return size_;
+}
+} // namespace EDM
+} // namespace OHOS
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "policy_json_converter.h"
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include "edm_log.h"
+#include "json/json.h"
+
+namespace OHOS {
+namespace EDM {
+const std::string JSON_FILE_BAK_SUFFIX = ".bak";
+const std::string ADMIN_POLICIES = "AdminPolicies";
+const std::string ADMIN_NAME = "AdminName";
+const std::string POLICY_ITEMS = "PolicyItems";
+const std::string COMBINED_POLICIES = "CombinedPolicies";
+const std::string JOURNAL_SEQUENCE = "JournalSequence";
+
+static bool ParsePolicyItems(const Json::Value &items, PolicyValueMap &itemsMap)
+{
+    if (!items.isObject()) {
+        EDMLOGW("ParsePolicyItems items is not object");
+        return false;
+    }
+
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "    ";
+    Json::Value::Members mem = items.getMemberNames();
+    for (const auto &i : mem) {
+        itemsMap[i] = MakePolicyValue(Json::writeString(builder, items[i]));
+    }
+    return true;
+}
+
+static bool ParseAdminPolicy(const Json::Value &admin,
+    std::unordered_map<std::string, PolicyItemsHandle> &adminPolicies)
+{
+    if (!admin.isObject()) {
+        EDMLOGI("admin root policy is not object\n");
+        return false;
+    }
+    std::string adminName;
+    if (admin.isMember(ADMIN_NAME) && admin[ADMIN_NAME].isString()) {
+        adminName = admin[ADMIN_NAME].asString();
+    }
+    if (adminName.empty() || !admin.isMember(POLICY_ITEMS)) {
+        return false;
+    }
+    auto itemsMap = std::make_shared<PolicyValueMap>();
+    auto iter = adminPolicies.find(adminName);
+    if (iter != adminPolicies.end()) {
+        EDMLOGW("AdminName:%{public}s should not repetitive\n", adminName.c_str());
+        *itemsMap = *iter->second;
+    }
+    if (!ParsePolicyItems(admin[POLICY_ITEMS], *itemsMap)) {
+        return false;
+    }
+    adminPolicies[adminName] = std::move(itemsMap);
+    return true;
+}
+
+static void ParseJsonString(const std::string &policyValue, Json::Value &policyValueRoot)
+{
+    JSONCPP_STRING err;
+    Json::CharReaderBuilder builder;
+    const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    if (!reader->parse(policyValue.c_str(), policyValue.c_str() + policyValue.length(), &policyValueRoot, &err)) {
+        policyValueRoot = Json::Value(policyValue);
+    }
+}
+
+ErrCode PolicyJsonConverter::ReadFile(const std::string &path, PolicyTable &table, std::uint64_t &journalSequence)
+{
+    std::ifstream ifs(path);
+    if (!ifs.is_open()) {
+        EDMLOGE("PolicyJsonConverter: open edm policy json file failed\n");
+        return ERR_EDM_POLICY_OPEN_JSON_FAILED;
+    }
+    Json::Value policyRoot;
+    Json::String errs;
+    Json::CharReaderBuilder builder;
+    if (!parseFromStream(builder, ifs, &policyRoot, &errs)) {
+        EDMLOGW("parse from stream failed: %{public}s\n", errs.c_str());
+        return ERR_EDM_POLICY_LOAD_JSON_FAILED;
+    }
+    if (!policyRoot.isObject()) {
+        EDMLOGW("json root is not object\n");
+        return ERR_EDM_POLICY_PARSE_JSON_FAILED;
+    }
+
+    journalSequence = 0;
+    if (policyRoot.isMember(JOURNAL_SEQUENCE) && policyRoot[JOURNAL_SEQUENCE].isUInt64()) {
+        journalSequence = policyRoot[JOURNAL_SEQUENCE].asUInt64();
+    }
+    if (policyRoot.isMember(ADMIN_POLICIES)) {
+        if (!policyRoot[ADMIN_POLICIES].isArray()) {
+            return ERR_EDM_POLICY_PARSE_JSON_FAILED;
+        }
+        for (const auto &item : policyRoot[ADMIN_POLICIES]) {
+            if (!ParseAdminPolicy(item, table.adminPolicies)) {
+                EDMLOGI("AdminPolicies parse failed object");
+                return ERR_EDM_POLICY_PARSE_JSON_FAILED;
+            }
+        }
+    }
+    if (policyRoot.isMember(COMBINED_POLICIES) &&
+        !ParsePolicyItems(policyRoot[COMBINED_POLICIES], table.combinedPolicies)) {
+        EDMLOGI("CombinedPolicies parse failed object");
+        return ERR_EDM_POLICY_PARSE_JSON_FAILED;
+    }
+    return ERR_OK;
+}
+
+ErrCode PolicyJsonConverter::WriteFile(const std::string &path, const PolicyTable &table)
+{
+    Json::Value policyRoot(Json::objectValue);
+    Json::Value adminArray(Json::arrayValue);
+    for (const auto &admin : table.adminPolicies) {
+        Json::Value adminObject;
+        Json::Value policyItemsObject(Json::objectValue);
+        for (const auto &item : *admin.second) {
+            ParseJsonString(*item.second, policyItemsObject[item.first]);
+        }
+        adminObject[ADMIN_NAME] = admin.first;
+        adminObject[POLICY_ITEMS] = policyItemsObject;
+        adminArray.append(adminObject);
+    }
+    Json::Value combinedObject(Json::objectValue);
+    for (const auto &item : table.combinedPolicies) {
+        ParseJsonString(*item.second, combinedObject[item.first]);
+    }
+    policyRoot[ADMIN_POLICIES] = adminArray;
+    policyRoot[COMBINED_POLICIES] = combinedObject;
+
+    std::string bakPath = path + JSON_FILE_BAK_SUFFIX;
+    std::ofstream ofs(bakPath, std::ofstream::binary);
+    if (!ofs.is_open()) {
+        EDMLOGW("PolicyJsonConverter open edm policy json file failed\n");
+        return ERR_EDM_POLICY_OPEN_JSON_FAILED;
+    }
+    Json::StreamWriterBuilder builder;
+    /* use 4 spaces instead of tab for indentation */
+    builder["indentation"] = "    ";
+    const std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+    writer->write(policyRoot, &ofs);
+    ofs.flush();
+    bool isWriteSuccess = ofs.good();
+    ofs.close();
+    if (!isWriteSuccess || std::rename(bakPath.c_str(), path.c_str()) != 0) {
+        EDMLOGW("PolicyJsonConverter write edm policy json file failed\n");
+        return ERR_EDM_POLICY_SET_FAILED;
+    }
+    return ERR_OK;
+}
+} // namespace EDM
+} // namespace OHOS
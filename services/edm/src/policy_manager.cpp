@@ -15,21 +15,33 @@
 
 #include "policy_manager.h"
 #include <algorithm>
-#include <ctime>
-#include <fstream>
+#include <chrono>
+#include <iterator>
+#include <cerrno>
+#include <random>
+#include <sys/syscall.h>
 #include <unistd.h>
 #include "edm_log.h"
+#include "policy_file_store.h"
+#include "policy_json_converter.h"
+#include "policy_snapshot.h"
 
 namespace OHOS {
 namespace EDM {
-const std::string EDM_POLICY_JSON_FILE = "/data/system/device_policies.json";
-const std::string EDM_POLICY_JSON_FILE_BAK = "/data/system/device_policies.json.bak";
-constexpr unsigned int INVALID_INDEX = -1;
+constexpr std::size_t EDM_POLICY_PERSIST_QUEUE_SIZE = 256;
+constexpr int EDM_IOPRIO_WHO_PROCESS = 1;
+constexpr int EDM_IOPRIO_CLASS_SHIFT = 13;
+constexpr int EDM_IOPRIO_CLASS_BE = 2;
+constexpr int EDM_IOPRIO_LOWEST_LEVEL = 7;
+/* the sequence of a change takes the low bits of its generation, the epoch of the start the high bits */
+constexpr std::uint32_t GENERATION_EPOCH_SHIFT = 40;
+constexpr std::uint64_t GENERATION_SEQUENCE_MASK = (1ULL << GENERATION_EPOCH_SHIFT) - 1;
+constexpr std::uint64_t GENERATION_EPOCH_MASK = (1ULL << (64 - GENERATION_EPOCH_SHIFT)) - 1;
 
 std::shared_ptr<PolicyManager> PolicyManager::instance_;
 std::mutex PolicyManager::mutexLock_;
 
-PolicyManager::PolicyManager()
+PolicyManager::PolicyManager() : table_(std::make_shared<PolicyTable>()), store_(std::make_shared<PolicyFileStore>())
 {
     EDMLOGD("PolicyManager::PolicyManager\n");
 }
@@ -37,477 +49,690 @@ PolicyManager::PolicyManager()
 PolicyManager::~PolicyManager()
 {
     EDMLOGD("PolicyManager::~PolicyManager\n");
+    StopFlushThread();
+    Flush();
 }
 
-bool PolicyManager::ParsePolicyItems(const Json::Value &items, PolicyItemsMap &itemsMap)
+std::shared_ptr<const PolicyTable> PolicyManager::LoadTable() const
 {
-    if (!items.isObject()) {
-        EDMLOGW("ParsePolicyItems items is not object");
-        return false;
+    return std::atomic_load(&table_);
+}
+
+void PolicyManager::PublishTable(std::shared_ptr<const PolicyTable> table)
+{
+    std::atomic_store(&table_, std::move(table));
+}
+
+void PolicyManager::SetPolicyStore(std::shared_ptr<IPolicyStore> store)
+{
+    Flush();
+    std::lock_guard<std::mutex> tableLock(tableMutex_);
+    std::lock_guard<std::mutex> ioLock(ioMutex_);
+    std::lock_guard<std::mutex> lock(journalMutex_);
+    store_ = std::move(store);
+}
+
+ErrCode PolicyManager::LoadPolicy()
+{
+    Flush();
+    std::lock_guard<std::mutex> tableLock(tableMutex_);
+    /* the worker doesn't write the store while it is reloaded */
+    std::lock_guard<std::mutex> ioLock(ioMutex_);
+    auto table = std::make_shared<PolicyTable>();
+    std::uint64_t snapshotSequence = 0;
+    bool needSave = false;
+    ErrCode ret = store_->Load(*table, snapshotSequence, needSave);
+    BuildAdminIndex(*table);
+    std::lock_guard<std::mutex> lock(journalMutex_);
+    journalSequence_ = store_->ReplayDelta(snapshotSequence, [this, &table](const PolicyJournalRecord &record) {
+        ApplyPolicy(*table, record.adminName, record.policyName, record.adminPolicy, record.mergedPolicy);
+    });
+    /*
+     * The changes not written before a crash are lost and their sequences are used again, the generations of
+     * every start take a new epoch so that a generation handed out before the crash never comes back.
+     */
+    generationEpoch_ = NewGenerationEpoch(generationEpoch_);
+    table->generation = MakeGeneration(journalSequence_);
+    table->baseGeneration = table->generation;
+    PublishTable(std::move(table));
+    pendingRecords_.clear();
+    needSave_ = false;
+    persistedSequence_ = journalSequence_;
+    if (needSave && !SavePolicy()) {
+        needSave_ = true;
+    }
+    return ret;
+}
+
+ErrCode PolicyManager::LoadPolicyJson(const std::string &path, PolicyTable &table, std::uint64_t &snapshotSequence)
+{
+    ErrCode ret = PolicyJsonConverter::ReadFile(path, table, snapshotSequence);
+    if (FAILED(ret)) {
+        return ret;
+    }
+    BuildAdminIndex(table);
+    return ERR_OK;
+}
+
+void PolicyManager::BuildAdminIndex(PolicyTable &table)
+{
+    std::unordered_map<std::string, AdminValueViewMap> policyAdmins;
+    for (const auto &admin : table.adminPolicies) {
+        for (const auto &item : *admin.second) {
+            policyAdmins[item.first][admin.first] = item.second;
+        }
+    }
+    table.policyAdmins.clear();
+    for (auto &admins : policyAdmins) {
+        table.policyAdmins[admins.first] = std::make_shared<const AdminValueViewMap>(std::move(admins.second));
     }
+}
 
-    Json::Value::Members mem = items.getMemberNames();
-    for (const auto &i : mem) {
-        Json::StreamWriterBuilder builder;
-        builder["indentation"] = "    ";
-        std::string arrayToString = Json::writeString(builder, items[i]);
-        itemsMap.insert(std::pair<std::string, std::string>(i, arrayToString));
+bool PolicyManager::DecodeAdmin(PolicyTable &table, const std::string &adminName)
+{
+    auto iter = table.lazyAdmins.find(adminName);
+    if (iter == table.lazyAdmins.end()) {
+        return true;
     }
-    return true;
+    auto itemsMap = std::make_shared<PolicyValueMap>();
+    bool decoded = table.snapshot->GetAdminPolicies(iter->second, *itemsMap);
+    if (!decoded) {
+        /* the index of the snapshot is checked when it is opened, never get here */
+        EDMLOGW("DecodeAdmin: admin %{public}s is damaged\n", adminName.c_str());
+        itemsMap->clear();
+    }
+    for (const auto &item : *itemsMap) {
+        CopyItems(table.policyAdmins, item.first)[adminName] = item.second;
+    }
+    if (!itemsMap->empty()) {
+        table.adminPolicies[adminName] = std::move(itemsMap);
+    }
+    table.lazyAdmins.erase(iter);
+    if (table.lazyAdmins.empty()) {
+        table.snapshot.reset();
+    }
+    return decoded;
 }
 
-bool PolicyManager::ParseAdminList(const std::string &adminName, const PolicyItemsMap &itemsMap)
+bool PolicyManager::DecodeAllAdmins(PolicyTable &table)
 {
-    for (auto &iter : itemsMap) {
-        std::string policyName = iter.first;
-        std::string policyValue = iter.second;
-        auto it = policyAdmins_.find(policyName);
-        if (it == policyAdmins_.end()) {
-            /* policy first added into map */
-            AdminValueItemsMap adminValueItem;
-            adminValueItem.insert(std::pair<std::string, std::string>(adminName, policyValue));
-            policyAdmins_.insert(std::pair<std::string, AdminValueItemsMap>(policyName, adminValueItem));
-        } else {
-            AdminValueItemsMap &adminValueRef = it->second;
-            auto iterValue = adminValueRef.find(adminName);
-            if (iterValue != adminValueRef.end()) {
-                EDMLOGW("AdminName:%{public}s PolicyName:%{public}s should not repetitive\n",
-                        adminName.c_str(), policyName.c_str());
-                iterValue->second = policyValue;
-            } else {
-                adminValueRef.insert(std::pair<std::string, std::string>(adminName, policyValue));
-            }
+    if (table.lazyAdmins.empty()) {
+        return true;
+    }
+    std::unordered_map<std::string, AdminValueViewMap> policyAdmins;
+    for (const auto &admins : table.policyAdmins) {
+        policyAdmins[admins.first] = *admins.second;
+    }
+    bool decoded = true;
+    for (const auto &admin : table.lazyAdmins) {
+        auto itemsMap = std::make_shared<PolicyValueMap>();
+        if (!table.snapshot->GetAdminPolicies(admin.second, *itemsMap)) {
+            EDMLOGW("DecodeAllAdmins: admin %{public}s is damaged\n", admin.first.c_str());
+            decoded = false;
+            continue;
+        }
+        for (const auto &item : *itemsMap) {
+            policyAdmins[item.first][admin.first] = item.second;
+        }
+        if (!itemsMap->empty()) {
+            table.adminPolicies[admin.first] = std::move(itemsMap);
         }
     }
-    return true;
+    table.lazyAdmins.clear();
+    table.snapshot.reset();
+    table.policyAdmins.clear();
+    for (auto &admins : policyAdmins) {
+        table.policyAdmins[admins.first] = std::make_shared<const AdminValueViewMap>(std::move(admins.second));
+    }
+    return decoded;
+}
+
+std::shared_ptr<const PolicyTable> PolicyManager::LoadDecodedTable()
+{
+    auto table = LoadTable();
+    if (table->lazyAdmins.empty()) {
+        return table;
+    }
+    std::lock_guard<std::mutex> lock(tableMutex_);
+    auto decodedTable = std::make_shared<PolicyTable>(*LoadTable());
+    DecodeAllAdmins(*decodedTable);
+    PublishTable(decodedTable);
+    return decodedTable;
+}
+
+ErrCode PolicyManager::ImportPolicyJson(const std::string &path)
+{
+    std::lock_guard<std::mutex> tableLock(tableMutex_);
+    std::lock_guard<std::mutex> ioLock(ioMutex_);
+    auto table = std::make_shared<PolicyTable>();
+    std::uint64_t snapshotSequence = 0;
+    ErrCode ret = LoadPolicyJson(path, *table, snapshotSequence);
+    if (FAILED(ret)) {
+        EDMLOGW("ImportPolicyJson: import failed, keep the current policies\n");
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(journalMutex_);
+    /* the records not written yet are older than the imported policies */
+    pendingRecords_.clear();
+    needSave_ = false;
+    /* every policy may be changed by the import */
+    journalSequence_++;
+    table->generation = MakeGeneration(journalSequence_);
+    table->baseGeneration = table->generation;
+    PublishTable(std::move(table));
+    if (!SavePolicy()) {
+        needSave_ = true;
+        return ERR_EDM_POLICY_SET_FAILED;
+    }
+    persistedSequence_ = journalSequence_;
+    return ERR_OK;
+}
+
+ErrCode PolicyManager::ExportPolicyJson(const std::string &path)
+{
+    return PolicyJsonConverter::WriteFile(path, *LoadDecodedTable());
 }
 
-bool PolicyManager::ParseAdminPolicy(const Json::Value &admin)
+bool PolicyManager::SavePolicy()
 {
-    std::string adminName;
-    PolicyItemsMap itemsMap;
-    if (!admin.isObject()) {
-        EDMLOGI("admin root policy is not object\n");
+    ErrCode ret = store_->Flush(LoadTable(), journalSequence_);
+    if (FAILED(ret)) {
+        EDMLOGW("SavePolicy flush policy store failed:%{public}d\n", ret);
         return false;
     }
+    return true;
+}
 
-    if (admin.isMember("AdminName") && admin["AdminName"].isString()) {
-        adminName = admin["AdminName"].asString();
+void PolicyManager::WaitQueueRoom()
+{
+    std::unique_lock<std::mutex> lock(journalMutex_);
+    if (workerRunning_ && pendingRecords_.size() >= EDM_POLICY_PERSIST_QUEUE_SIZE) {
+        /* the writers wait before building their table, the other writers and the readers are not blocked */
+        persistStats_.backpressureCount++;
+        flushCond_.notify_one();
+        persistedCond_.wait(lock, [this]() {
+            return !workerRunning_ || pendingRecords_.size() < EDM_POLICY_PERSIST_QUEUE_SIZE;
+        });
     }
+}
 
-    bool isParsePolicySuccess = false;
-    bool isParseAdminListSuccess = false;
-    if (admin.isMember("PolicyItems") && admin["PolicyItems"].isObject() && !adminName.empty()) {
-        isParsePolicySuccess = ParsePolicyItems(admin["PolicyItems"], itemsMap);
-        adminPolicies_.insert(std::pair<std::string, PolicyItemsMap>(adminName, itemsMap));
-        isParseAdminListSuccess = ParseAdminList(adminName, itemsMap);
+void PolicyManager::QueuePolicy(std::vector<PolicyJournalRecord> &records)
+{
+    bool isIdle = pendingRecords_.empty() && !needSave_;
+    if (journalEnabled_ && !needSave_) {
+        pendingRecords_.insert(pendingRecords_.end(), std::make_move_iterator(records.begin()),
+            std::make_move_iterator(records.end()));
+    } else {
+        /* the worker saves the latest table, it contains every change not written yet */
+        pendingRecords_.clear();
+        needSave_ = true;
+    }
+    persistStats_.maxQueueDepth = std::max(persistStats_.maxQueueDepth, journalSequence_ - persistedSequence_);
+    auto now = std::chrono::steady_clock::now();
+    lastPendingTime_ = now;
+    if (isIdle) {
+        /* the worker recomputes the deadline by itself, only the first change of a burst wakes it up */
+        firstPendingTime_ = now;
+        flushCond_.notify_one();
+    } else if (pendingRecords_.size() >= EDM_POLICY_PERSIST_QUEUE_SIZE) {
+        flushCond_.notify_one();
     }
-    return isParsePolicySuccess && isParseAdminListSuccess;
 }
 
-bool PolicyManager::ParseCombinedPolicy(const Json::Value &combined)
+ErrCode PolicyManager::Flush()
 {
-    if (!combined.isObject()) {
-        EDMLOGI("combined root is not object\n");
-        return false;
+    std::unique_lock<std::mutex> lock(journalMutex_);
+    if (workerRunning_) {
+        return WaitPersisted(lock, journalSequence_);
     }
-    return ParsePolicyItems(combined, combinedPolicies_);
+    lock.unlock();
+    return PersistInline(true);
 }
 
-ErrCode PolicyManager::ParseDevicePolicyJsonFile(const Json::Value &policyRoot)
+ErrCode PolicyManager::PersistInline(bool sync)
 {
-    if (!policyRoot.isObject()) {
-        EDMLOGW("json root is not object\n");
-        return ERR_EDM_POLICY_PARSE_JSON_FAILED;
+    /* ioMutex_ is held from taking the queue until it is written, the queues are written in sequence order */
+    std::lock_guard<std::mutex> ioLock(ioMutex_);
+    std::unique_lock<std::mutex> lock(journalMutex_);
+    if (!sync && pendingRecords_.empty() && !needSave_) {
+        /* the records of this writer are written by the writer before it */
+        return ERR_OK;
     }
+    std::vector<PolicyJournalRecord> records;
+    records.swap(pendingRecords_);
+    bool isSave = needSave_;
+    needSave_ = false;
+    std::uint64_t sequence = journalSequence_;
+    lock.unlock();
+    bool isDone = WritePending(records, isSave, sequence, sync);
+    lock.lock();
+    if (!isDone) {
+        /* the records are already applied to the table, the next write saves the whole table */
+        needSave_ = true;
+        return ERR_EDM_POLICY_WRITE_JOURNAL_FAILED;
+    }
+    persistedSequence_ = std::max(persistedSequence_, sequence);
+    return ERR_OK;
+}
 
-    bool isParseAdminSuccess = false;
-    bool isParseCombinedSuccess = false;
-    if (policyRoot.isMember("AdminPolicies") && policyRoot["AdminPolicies"].isArray()) {
-        for (const auto &item : policyRoot["AdminPolicies"]) {
-            if (!item.isObject()) {
-                EDMLOGI("is not object");
-                return ERR_EDM_POLICY_PARSE_JSON_FAILED;
-            }
-            isParseAdminSuccess = ParseAdminPolicy(item);
-            if (!isParseAdminSuccess) {
-                EDMLOGI("AdminPolicies parse failed object");
-                return ERR_EDM_POLICY_PARSE_JSON_FAILED;
-            }
+ErrCode PolicyManager::WaitPersisted(std::unique_lock<std::mutex> &lock, std::uint64_t sequence)
+{
+    while (workerRunning_ && persistedSequence_ < sequence) {
+        std::uint64_t flushCount = persistStats_.flushCount;
+        flushRequested_ = true;
+        flushCond_.notify_one();
+        persistedCond_.wait(lock, [this, flushCount]() {
+            return !workerRunning_ || persistStats_.flushCount != flushCount;
+        });
+        if (workerRunning_ && persistedSequence_ < sequence && lastFlushFailed_) {
+            return ERR_EDM_POLICY_WRITE_JOURNAL_FAILED;
         }
     }
+    if (persistedSequence_ >= sequence) {
+        return ERR_OK;
+    }
+    /* the worker is stopped before writing the change */
+    lock.unlock();
+    return PersistInline(true);
+}
 
-    if (isParseAdminSuccess) {
-        if (policyRoot.isMember("CombinedPolicies") && policyRoot["CombinedPolicies"].isObject()) {
-            isParseCombinedSuccess = ParseCombinedPolicy(policyRoot["CombinedPolicies"]);
+void PolicyManager::FlushLoop()
+{
+    SetLowIoPriority();
+    std::unique_lock<std::mutex> lock(journalMutex_);
+    while (!flushStopping_) {
+        if (pendingRecords_.empty() && !needSave_ && !flushRequested_) {
+            flushCond_.wait(lock);
+            continue;
+        }
+        /* wait until the burst is quiet, but never longer than the max delay since the first change */
+        auto deadline = std::min(lastPendingTime_ + quietWindow_, firstPendingTime_ + maxDelay_);
+        bool isDue = flushRequested_ || pendingRecords_.size() >= EDM_POLICY_PERSIST_QUEUE_SIZE ||
+            std::chrono::steady_clock::now() >= deadline;
+        if (!isDue) {
+            flushCond_.wait_until(lock, deadline);
+            continue;
         }
+        PersistPending(lock);
+    }
+}
+
+void PolicyManager::PersistPending(std::unique_lock<std::mutex> &lock)
+{
+    std::vector<PolicyJournalRecord> records;
+    records.swap(pendingRecords_);
+    bool isSave = needSave_;
+    needSave_ = false;
+    flushRequested_ = false;
+    std::uint64_t sequence = journalSequence_;
+    /* the queue has room again */
+    persistedCond_.notify_all();
+
+    /* the file io runs without the journal lock, SetPolicy keeps queueing meanwhile */
+    lock.unlock();
+    auto begin = std::chrono::steady_clock::now();
+    bool isDone = false;
+    {
+        std::lock_guard<std::mutex> ioLock(ioMutex_);
+        isDone = WritePending(records, isSave, sequence, true);
+    }
+    auto end = std::chrono::steady_clock::now();
+    lock.lock();
+
+    std::uint64_t latencyUs = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count());
+    persistStats_.flushCount++;
+    persistStats_.lastFlushLatencyUs = latencyUs;
+    persistStats_.maxFlushLatencyUs = std::max(persistStats_.maxFlushLatencyUs, latencyUs);
+    persistStats_.totalFlushLatencyUs += latencyUs;
+    lastFlushFailed_ = !isDone;
+    if (isDone) {
+        persistedSequence_ = std::max(persistedSequence_, sequence);
     } else {
-        EDMLOGW("ParseAdminPolicy failed\n");
+        /* retry with the whole snapshot after the next quiet window */
+        persistStats_.failedFlushCount++;
+        pendingRecords_.clear();
+        needSave_ = true;
+        firstPendingTime_ = end;
+        lastPendingTime_ = end;
     }
+    persistedCond_.notify_all();
+}
 
-    if (isParseAdminSuccess && isParseCombinedSuccess) {
-        return ERR_OK;
+bool PolicyManager::WritePending(const std::vector<PolicyJournalRecord> &records, bool isSave,
+    std::uint64_t sequence, bool sync)
+{
+    if (!isSave) {
+        ErrCode ret = store_->ApplyDelta(records, sync);
+        if (ret == ERR_OK) {
+            store_->Checkpoint(LoadTable(), sequence);
+            return true;
+        }
+        EDMLOGW("WritePending: write journal failed, flush the whole table\n");
     }
-    return ERR_EDM_POLICY_PARSE_JSON_FAILED;
+    /* the published table may be newer than the sequence, replaying the newer records again is harmless */
+    ErrCode ret = store_->Flush(LoadTable(), sequence);
+    if (FAILED(ret)) {
+        EDMLOGW("WritePending: flush policy store failed:%{public}d\n", ret);
+        return false;
+    }
+    return true;
 }
 
-ErrCode PolicyManager::LoadPolicy()
+void PolicyManager::SetLowIoPriority()
 {
-    if (access(EDM_POLICY_JSON_FILE.c_str(), F_OK) != 0) {
-        EDMLOGI("LoadPolicy: create an empty json file\n");
-        CreateEmptyJsonFile();
+    /* the worker only competes with the foreground for the storage, it runs at the lowest best effort level */
+    int ioPriority = (EDM_IOPRIO_CLASS_BE << EDM_IOPRIO_CLASS_SHIFT) | EDM_IOPRIO_LOWEST_LEVEL;
+    if (syscall(SYS_ioprio_set, EDM_IOPRIO_WHO_PROCESS, 0, ioPriority) != 0) {
+        EDMLOGW("SetLowIoPriority: set io priority failed:%{public}d\n", errno);
     }
+}
 
-    std::ifstream ifs(EDM_POLICY_JSON_FILE);
-    if (!ifs.is_open()) {
-        EDMLOGE("LoadPolicy: open edm policy json file failed\n");
-        return ERR_EDM_POLICY_OPEN_JSON_FAILED;
+void PolicyManager::SetCoalescing(std::uint32_t quietWindowMs, std::uint32_t maxDelayMs)
+{
+    StopFlushThread();
+    Flush();
+    std::lock_guard<std::mutex> lock(journalMutex_);
+    quietWindow_ = std::chrono::milliseconds(quietWindowMs);
+    maxDelay_ = std::chrono::milliseconds(std::max(quietWindowMs, maxDelayMs));
+    if (quietWindowMs > 0) {
+        flushStopping_ = false;
+        workerRunning_ = true;
+        flushThread_ = std::thread([this]() { FlushLoop(); });
     }
+}
 
-    Json::String errs;
-    Json::CharReaderBuilder builder;
-    if (!parseFromStream(builder, ifs, &policyRoot_, &errs)) {
-        EDMLOGW("parse from stream failed: %{public}s\n", errs.c_str());
-        ifs.close();
-        return ERR_EDM_POLICY_LOAD_JSON_FAILED;
-    }
-    ifs.close();
-    return ParseDevicePolicyJsonFile(policyRoot_);
+void PolicyManager::SetDurableWrite(bool enable)
+{
+    durableWrite_ = enable;
 }
 
-void PolicyManager::SavePolicy()
+void PolicyManager::GetPersistStats(PolicyPersistStats &stats)
 {
-    /* the default file permission is 600, no need to change  */
-    std::ofstream ofs(EDM_POLICY_JSON_FILE_BAK, std::ofstream::binary);
-    if (!ofs.is_open()) {
-        EDMLOGW("SavePolicy open edm policy json file failed\n");
-        return;
+    std::lock_guard<std::mutex> lock(journalMutex_);
+    stats = persistStats_;
+    stats.queueDepth = journalSequence_ - persistedSequence_;
+}
+
+void PolicyManager::StopFlushThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(journalMutex_);
+        flushStopping_ = true;
+        flushCond_.notify_all();
+    }
+    if (flushThread_.joinable()) {
+        flushThread_.join();
     }
+    /* the changes left in the queue are written by the caller */
+    std::lock_guard<std::mutex> lock(journalMutex_);
+    workerRunning_ = false;
+    persistedCond_.notify_all();
+}
 
-    double time1 = clock();
-    Json::StreamWriterBuilder builder;
-    /* use 4 spaces instead of tab for indentation */
-    builder["indentation"] = "    ";
-    const std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
-    writer->write(policyRoot_, &ofs);
+void PolicyManager::SetJournalEnabled(bool enable)
+{
+    std::lock_guard<std::mutex> lock(journalMutex_);
+    journalEnabled_ = enable;
+}
 
-    ofs.flush();
-    ofs.close();
-    double time2 = clock();
-    std::rename(EDM_POLICY_JSON_FILE_BAK.c_str(), EDM_POLICY_JSON_FILE.c_str());
-    double time3 = clock();
-    EDMLOGI("SavePolicy spend time %{public}f, %{public}f", (time2 - time1) / CLOCKS_PER_SEC,
-        (time3 - time2) / CLOCKS_PER_SEC);
+std::uint64_t PolicyManager::GetPersistedBytes()
+{
+    std::lock_guard<std::mutex> lock(journalMutex_);
+    return store_->GetWrittenBytes();
 }
 
 ErrCode PolicyManager::GetAdminByPolicyName(const std::string &policyName, AdminValueItemsMap &adminValueItems)
 {
-    auto iter = policyAdmins_.find(policyName);
-    if (iter != policyAdmins_.end()) {
-        adminValueItems = iter->second;
+    auto table = LoadDecodedTable();
+    auto iter = table->policyAdmins.find(policyName);
+    if (iter != table->policyAdmins.end()) {
+        for (const auto &item : *iter->second) {
+            adminValueItems[item.first] = *item.second;
+        }
         return ERR_OK;
     }
     return ERR_EDM_POLICY_NOT_FOUND;
 }
 
-ErrCode PolicyManager::GetAllPolicyByAdmin(const std::string &adminName, PolicyItemsMap &allAdminPolicy)
+ErrCode PolicyManager::GetAdminByPolicyName(const std::string &policyName, AdminValueViewMap &adminValueViews)
 {
-    auto iter = adminPolicies_.find(adminName);
-    if (iter != adminPolicies_.end()) {
-        allAdminPolicy = iter->second;
+    auto table = LoadDecodedTable();
+    auto iter = table->policyAdmins.find(policyName);
+    if (iter != table->policyAdmins.end()) {
+        adminValueViews = *iter->second;
         return ERR_OK;
     }
-    return ERR_EDM_POLICY_NOT_FIND;
+    return ERR_EDM_POLICY_NOT_FOUND;
 }
 
-ErrCode PolicyManager::GetAdminPolicy(const std::string &adminName, const std::string &policyName,
-    std::string &policyValue)
+ErrCode PolicyManager::GetAllPolicyByAdmin(const std::string &adminName, PolicyItemsMap &allAdminPolicy)
 {
-    auto iter = adminPolicies_.find(adminName);
-    if (iter != adminPolicies_.end()) {
-        PolicyItemsMap &policyItem = iter->second;
+    auto table = LoadTable();
+    PolicyValueMap lazyItems;
+    const PolicyValueMap *items = nullptr;
+    auto iter = table->adminPolicies.find(adminName);
+    auto lazyIter = table->lazyAdmins.find(adminName);
+    if (iter != table->adminPolicies.end()) {
+        items = iter->second.get();
+    } else if (lazyIter != table->lazyAdmins.end() && table->snapshot->GetAdminPolicies(lazyIter->second, lazyItems)) {
+        /* decoded for this call only, the published table stays lazy */
+        items = &lazyItems;
+    }
+    if (items == nullptr) {
+        return ERR_EDM_POLICY_NOT_FIND;
+    }
+    for (const auto &item : *items) {
+        allAdminPolicy[item.first] = *item.second;
+    }
+    return ERR_OK;
+}
+
+ErrCode PolicyManager::GetAdminPolicy(const PolicyTable &table, const std::string &adminName,
+    const std::string &policyName, std::string &policyValue)
+{
+    auto iter = table.adminPolicies.find(adminName);
+    if (iter != table.adminPolicies.end()) {
+        const PolicyValueMap &policyItem = *iter->second;
         auto it = policyItem.find(policyName);
         if (it != policyItem.end()) {
-            policyValue = it->second;
+            policyValue = *it->second;
             return ERR_OK;
         }
     }
-    return ERR_EDM_POLICY_NOT_FIND;
-}
-
-ErrCode PolicyManager::GetCombinedPolicy(const std::string &policyName, std::string &policyValue)
-{
-    auto it = combinedPolicies_.find(policyName);
-    if (it != combinedPolicies_.end()) {
-        policyValue = it->second;
+    auto lazyIter = table.lazyAdmins.find(adminName);
+    if (lazyIter != table.lazyAdmins.end() && table.snapshot->GetAdminPolicy(lazyIter->second, policyName,
+        policyValue)) {
         return ERR_OK;
     }
     return ERR_EDM_POLICY_NOT_FIND;
 }
 
-bool PolicyManager::GetAdminItemJsonObject(const Json::Value &admin, const std::string &adminName)
+ErrCode PolicyManager::GetCombinedPolicy(const PolicyTable &table, const std::string &policyName,
+    std::string &policyValue)
 {
-    if (admin.isMember("AdminName") && admin["AdminName"].isString()) {
-        std::string adminItemName = admin["AdminName"].asString();
-        if ((adminItemName == adminName) && (admin.isMember("PolicyItems") && admin["PolicyItems"].isObject())) {
-            return true;
-        }
+    auto it = table.combinedPolicies.find(policyName);
+    if (it != table.combinedPolicies.end()) {
+        policyValue = *it->second;
+        return ERR_OK;
     }
-    return false;
+    return ERR_EDM_POLICY_NOT_FIND;
 }
 
 ErrCode PolicyManager::GetPolicy(const std::string &adminName, const std::string &policyName,
     std::string &policyValue)
 {
+    /* readers never take a lock, they keep the table published when the call starts */
+    auto table = LoadTable();
     if (adminName.empty()) {
-        return GetCombinedPolicy(policyName, policyValue);
+        return GetCombinedPolicy(*table, policyName, policyValue);
     } else {
-        return GetAdminPolicy(adminName, policyName, policyValue);
+        return GetAdminPolicy(*table, adminName, policyName, policyValue);
     }
 }
 
-void PolicyManager::SetAdminList(const std::string &adminName, const std::string &policyName,
-    const std::string &policyValue)
+ErrCode PolicyManager::GetPolicy(const std::string &adminName, const std::string &policyName,
+    std::string &policyValue, std::uint64_t &generation)
 {
-    auto iter = policyAdmins_.find(policyName);
-    if (iter == policyAdmins_.end()) {
-        /* policy first added into map */
-        AdminValueItemsMap adminValueItem;
-        adminValueItem.insert(std::pair<std::string, std::string>(adminName, policyValue));
-        policyAdmins_.insert(std::pair<std::string, AdminValueItemsMap>(policyName, adminValueItem));
-        return;
-    }
-
-    AdminValueItemsMap &adminValueRef = iter->second;
-    auto it = adminValueRef.find(adminName);
-    if (it != adminValueRef.end()) {
-        it->second = policyValue;
+    /* the value and the generation are read from the same table */
+    auto table = LoadTable();
+    generation = GetGeneration(*table, adminName, policyName);
+    if (adminName.empty()) {
+        return GetCombinedPolicy(*table, policyName, policyValue);
     } else {
-        adminValueRef.insert(std::pair<std::string, std::string>(adminName, policyValue));
+        return GetAdminPolicy(*table, adminName, policyName, policyValue);
     }
 }
 
-bool PolicyManager::SetAdminPolicyItemJsonValue(Json::Value &admin, const std::string &adminName,
-    const std::string &policyName, const std::string &policyValue)
+std::uint64_t PolicyManager::NewGenerationEpoch(std::uint64_t lastEpoch)
 {
-    if (GetAdminItemJsonObject(admin, adminName)) {
-        Json::Value policyValueRoot;
-        if (ParseJsonString(policyValue, policyValueRoot) != ERR_OK) {
-            return false;
-        }
-        Json::Value &adminObject = admin["PolicyItems"];
-        adminObject[policyName] = policyValueRoot;
-        return true;
+    std::random_device device;
+    std::uint64_t epoch = 0;
+    while (epoch == 0 || epoch == lastEpoch) {
+        epoch = ((static_cast<std::uint64_t>(device()) << 32) | device()) & GENERATION_EPOCH_MASK;
     }
-    return false;
+    return epoch;
 }
 
-ErrCode PolicyManager::ParseJsonString(const std::string &policyValue, Json::Value &policyValueRoot)
+// the caller holds tableMutex_
+std::uint64_t PolicyManager::MakeGeneration(std::uint64_t sequence) const
 {
-    const auto policyValueLength = static_cast<int>(policyValue.length());
-    JSONCPP_STRING err;
-    Json::CharReaderBuilder builder;
-    const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
-    if (!reader->parse(policyValue.c_str(), policyValue.c_str() + policyValueLength, &policyValueRoot, &err)) {
-        policyValueRoot = Json::Value(policyValue);
-    }
-    return ERR_OK;
+    return (generationEpoch_ << GENERATION_EPOCH_SHIFT) | ((sequence + 1) & GENERATION_SEQUENCE_MASK);
 }
 
-ErrCode PolicyManager::SetAdminJsonValue(const std::string &adminName, const std::string &policyName,
-    const std::string &policyValue)
+std::uint64_t PolicyManager::GetGeneration(const PolicyTable &table, const std::string &adminName,
+    const std::string &policyName)
 {
-    if (policyRoot_.isMember("AdminPolicies") && policyRoot_["AdminPolicies"].isArray()) {
-        for (auto &admin : policyRoot_["AdminPolicies"]) {
-            if (admin.isObject() && SetAdminPolicyItemJsonValue(admin, adminName, policyName, policyValue)) {
-                EDMLOGW("SetAdminJsonValue exist:%{public}s %{public}s ", adminName.c_str(), policyName.c_str());
-                return ERR_OK;
-            }
-        }
-        EDMLOGI("SetAdminJsonValue new object:%{public}s %{public}s ", adminName.c_str(), policyName.c_str());
-        Json::Value policyValueRoot;
-        if (ParseJsonString(policyValue, policyValueRoot) != ERR_OK) {
-            return ERR_EDM_POLICY_SET_FAILED;
-        }
-
-        Json::Value adminObject;
-        Json::Value policyItemsObject;
-        adminObject["AdminName"] = adminName;
-        policyItemsObject[policyName] = policyValueRoot;
-        adminObject["PolicyItems"] = policyItemsObject;
-        policyRoot_["AdminPolicies"].append(adminObject);
-        return ERR_OK;
+    if (adminName.empty()) {
+        auto iter = table.combinedGenerations.find(policyName);
+        return (iter == table.combinedGenerations.end()) ? table.baseGeneration : iter->second;
+    }
+    auto adminIter = table.adminGenerations.find(adminName);
+    if (adminIter == table.adminGenerations.end()) {
+        return table.baseGeneration;
     }
-    return ERR_EDM_POLICY_SET_FAILED;
+    auto iter = adminIter->second->find(policyName);
+    return (iter == adminIter->second->end()) ? table.baseGeneration : iter->second;
 }
 
-ErrCode PolicyManager::SetAdminPolicy(const std::string &adminName, const std::string &policyName,
-    const std::string &policyValue)
+void PolicyManager::SetGeneration(PolicyTable &table, const std::string &adminName, const std::string &policyName)
 {
-    SetAdminList(adminName, policyName, policyValue);
-    auto iter = adminPolicies_.find(adminName);
-    if (iter == adminPolicies_.end()) {
-        PolicyItemsMap itemMap;
-        itemMap.insert(std::pair<std::string, std::string>(policyName, policyValue));
-        adminPolicies_.insert(std::pair<std::string, PolicyItemsMap>(adminName, itemMap));
-        return SetAdminJsonValue(adminName, policyName, policyValue);
+    table.combinedGenerations[policyName] = table.generation;
+    if (adminName.empty()) {
+        return;
     }
-
-    PolicyItemsMap &policyItem = iter->second;
-    auto it = policyItem.find(policyName);
-    if (it != policyItem.end()) {
-        it->second = policyValue;
-    } else {
-        policyItem.insert(std::pair<std::string, std::string>(policyName, policyValue));
+    /* the generations of an admin may be shared with a published table, they are replaced by a private copy */
+    auto generations = std::make_shared<PolicyGenerationMap>();
+    auto iter = table.adminGenerations.find(adminName);
+    if (iter != table.adminGenerations.end()) {
+        *generations = *iter->second;
     }
-    return SetAdminJsonValue(adminName, policyName, policyValue);
+    (*generations)[policyName] = table.generation;
+    table.adminGenerations[adminName] = std::move(generations);
 }
 
-ErrCode PolicyManager::SetCombinedJsonValue(const std::string &policyName, const std::string &policyValue)
+PolicyValueMap &PolicyManager::CopyItems(std::unordered_map<std::string, PolicyItemsHandle> &itemsMaps,
+    const std::string &name)
 {
-    if (policyRoot_.isMember("CombinedPolicies") && policyRoot_["CombinedPolicies"].isObject()) {
-        Json::Value policyValueRoot;
-        if (ParseJsonString(policyValue, policyValueRoot) != ERR_OK) {
-            return ERR_EDM_POLICY_SET_FAILED;
-        }
-        policyRoot_["CombinedPolicies"][policyName] = policyValueRoot;
-        return ERR_OK;
+    /* the items map may be shared with a published table, it is replaced by a private copy */
+    auto items = std::make_shared<PolicyValueMap>();
+    auto iter = itemsMaps.find(name);
+    if (iter != itemsMaps.end()) {
+        *items = *iter->second;
     }
-    return ERR_EDM_POLICY_SET_FAILED;
+    itemsMaps[name] = items;
+    return *items;
 }
 
-ErrCode PolicyManager::SetCombinedPolicy(const std::string &policyName, const std::string &policyValue)
+ErrCode PolicyManager::SetAdminPolicy(PolicyTable &table, const std::string &adminName,
+    const std::string &policyName, const std::string &policyValue)
 {
-    auto it = combinedPolicies_.find(policyName);
-    if (it != combinedPolicies_.end()) {
-        it->second = policyValue;
-    } else {
-        combinedPolicies_.insert(std::pair<std::string, std::string>(policyName, policyValue));
-    }
-    return SetCombinedJsonValue(policyName, policyValue);
+    DecodeAdmin(table, adminName);
+    PolicyValue value = MakePolicyValue(policyValue);
+    CopyItems(table.adminPolicies, adminName)[policyName] = value;
+    /* policyAdmins is the index of adminPolicies by policy name, both point at the same value */
+    CopyItems(table.policyAdmins, policyName)[adminName] = std::move(value);
+    return ERR_OK;
 }
 
-void PolicyManager::DeleteAdminList(const std::string &adminName, const std::string &policyName)
+ErrCode PolicyManager::SetCombinedPolicy(PolicyTable &table, const std::string &policyName,
+    const std::string &policyValue)
 {
-    auto iter = policyAdmins_.find(policyName);
-    if (iter == policyAdmins_.end()) {
-        return;
-    }
+    table.combinedPolicies[policyName] = MakePolicyValue(policyValue);
+    return ERR_OK;
+}
 
-    AdminValueItemsMap &adminValueRef = iter->second;
-    auto it = adminValueRef.find(adminName);
-    if (it == adminValueRef.end()) {
+void PolicyManager::DeleteAdminList(PolicyTable &table, const std::string &adminName, const std::string &policyName)
+{
+    auto iter = table.policyAdmins.find(policyName);
+    if (iter == table.policyAdmins.end() || iter->second->find(adminName) == iter->second->end()) {
         return;
     }
 
-    adminValueRef.erase(it);
+    AdminValueViewMap &adminValueRef = CopyItems(table.policyAdmins, policyName);
+    adminValueRef.erase(adminName);
     if (adminValueRef.empty()) {
-        policyAdmins_.erase(iter);
-    }
-}
-
-bool PolicyManager::DeleteAdminPolicyItemJsonValue(Json::Value &admin, const std::string &adminName,
-    const std::string &policyName, unsigned int &policyItemsNum)
-{
-    if (GetAdminItemJsonObject(admin, adminName)) {
-        Json::Value &adminObject = admin["PolicyItems"];
-        if (adminObject.isMember(policyName)) {
-            adminObject.removeMember(policyName);
-            policyItemsNum = adminObject.size();
-            return true;
-        }
+        table.policyAdmins.erase(policyName);
     }
-    return false;
 }
 
-ErrCode PolicyManager::DeleteAdminJsonValue(const std::string &adminName, const std::string &policyName)
+ErrCode PolicyManager::DeleteAdminPolicy(PolicyTable &table, const std::string &adminName,
+    const std::string &policyName)
 {
-    if (!policyRoot_.isMember("AdminPolicies") || !policyRoot_["AdminPolicies"].isArray()) {
-        return ERR_EDM_POLICY_DEL_FAILED;
-    }
-    unsigned int policyItemsNum = 0;
-    unsigned int deleteIndex = INVALID_INDEX;
-    unsigned int policyRootSize = policyRoot_["AdminPolicies"].size();
-    for (Json::ArrayIndex i = 0; i < policyRootSize; i++) {
-        Json::Value &admin = policyRoot_["AdminPolicies"][i];
-        if (admin.isObject() && DeleteAdminPolicyItemJsonValue(admin, adminName, policyName, policyItemsNum)) {
-            if (policyItemsNum == 0) {
-                deleteIndex = i;
-                break;
+    DecodeAdmin(table, adminName);
+    auto iter = table.adminPolicies.find(adminName);
+    if (iter != table.adminPolicies.end()) {
+        if (iter->second->find(policyName) != iter->second->end()) {
+            PolicyValueMap &policyItem = CopyItems(table.adminPolicies, adminName);
+            policyItem.erase(policyName);
+            if (policyItem.empty()) {
+                table.adminPolicies.erase(adminName);
             }
         }
-    }
-    if (deleteIndex != INVALID_INDEX) {
-        policyRoot_["AdminPolicies"].removeIndex(deleteIndex, nullptr);
-    }
-    return ERR_OK;
-}
 
-ErrCode PolicyManager::DeleteAdminPolicy(const std::string &adminName, const std::string &policyName)
-{
-    auto iter = adminPolicies_.find(adminName);
-    if (iter != adminPolicies_.end()) {
-        PolicyItemsMap &policyItem = iter->second;
-        auto it = policyItem.find(policyName);
-        if (it != policyItem.end()) {
-            policyItem.erase(it);
-        }
-
-        if (iter->second.empty()) {
-            adminPolicies_.erase(iter);
-        }
-
-        DeleteAdminList(adminName, policyName);
-        return DeleteAdminJsonValue(adminName, policyName);
+        DeleteAdminList(table, adminName, policyName);
     }
     return ERR_OK;
 }
 
-ErrCode PolicyManager::DeleteCombinedJsonValue(const std::string &policyName)
+ErrCode PolicyManager::DeleteCombinedPolicy(PolicyTable &table, const std::string &policyName)
 {
-    if (policyRoot_.isMember("CombinedPolicies") && policyRoot_["CombinedPolicies"].isObject()) {
-        Json::Value &rootObject = policyRoot_["CombinedPolicies"];
-        if (rootObject.isMember(policyName)) {
-            rootObject.removeMember(policyName);
-            return true;
-        }
-    }
-    return ERR_EDM_POLICY_DEL_FAILED;
-}
-
-ErrCode PolicyManager::DeleteCombinedPolicy(const std::string &policyName)
-{
-    auto it = combinedPolicies_.find(policyName);
-    if (it != combinedPolicies_.end()) {
-        combinedPolicies_.erase(it);
+    auto it = table.combinedPolicies.find(policyName);
+    if (it == table.combinedPolicies.end()) {
+        return ERR_EDM_POLICY_DEL_FAILED;
     }
-    return DeleteCombinedJsonValue(policyName);
+    table.combinedPolicies.erase(it);
+    return ERR_OK;
 }
 
 void PolicyManager::DumpAdminPolicy()
 {
-    std::for_each(adminPolicies_.begin(), adminPolicies_.end(), [](auto iter) {
+    auto table = LoadTable();
+    EDMLOGD("%{public}zu admins are not decoded\n", table->lazyAdmins.size());
+    std::for_each(table->adminPolicies.begin(), table->adminPolicies.end(), [](const auto &iter) {
         EDMLOGD("AdminName: %{public}s\n", iter.first.c_str());
-        std::unordered_map<std::string, std::string> map = iter.second;
-        std::for_each(map.begin(), map.end(),
-            [](auto subIter) { EDMLOGD("%{public}s : %{public}s\n", subIter.first.c_str(), subIter.second.c_str()); });
+        std::for_each(iter.second->begin(), iter.second->end(), [](const auto &subIter) {
+            EDMLOGD("%{public}s : %{public}s\n", subIter.first.c_str(), subIter.second->c_str());
+        });
     });
 }
 
 void PolicyManager::DumpAdminList()
 {
-    std::for_each(policyAdmins_.begin(), policyAdmins_.end(), [](auto iter) {
+    auto table = LoadTable();
+    std::for_each(table->policyAdmins.begin(), table->policyAdmins.end(), [](const auto &iter) {
         EDMLOGD("PolicyName: %{public}s\n", iter.first.c_str());
-        std::unordered_map<std::string, std::string> map = iter.second;
-        std::for_each(map.begin(), map.end(),
-            [](auto subIter) { EDMLOGD("%{public}s : %{public}s\n", subIter.first.c_str(), subIter.second.c_str()); });
+        std::for_each(iter.second->begin(), iter.second->end(), [](const auto &subIter) {
+            EDMLOGD("%{public}s : %{public}s\n", subIter.first.c_str(), subIter.second->c_str());
+        });
     });
 }
 
 void PolicyManager::DumpCombinedPolicy()
 {
-    std::for_each(combinedPolicies_.begin(), combinedPolicies_.end(),
-        [](auto iter) { EDMLOGD("%{public}s : %{public}s\n", iter.first.c_str(), iter.second.c_str()); });
+    auto table = LoadTable();
+    std::for_each(table->combinedPolicies.begin(), table->combinedPolicies.end(),
+        [](const auto &iter) { EDMLOGD("%{public}s : %{public}s\n", iter.first.c_str(), iter.second->c_str()); });
 }
 
 ErrCode PolicyManager::SetPolicy(const std::string &adminName, const std::string &policyName,
@@ -517,11 +742,67 @@ ErrCode PolicyManager::SetPolicy(const std::string &adminName, const std::string
         return ERR_EDM_POLICY_SET_FAILED;
     }
 
+    std::vector<PolicyJournalRecord> records(1);
+    records[0].adminName = adminName;
+    records[0].policyName = policyName;
+    records[0].adminPolicy = adminPolicy;
+    records[0].mergedPolicy = mergedPolicy;
+    return CommitPolicies(records);
+}
+
+ErrCode PolicyManager::CommitPolicies(std::vector<PolicyJournalRecord> &records)
+{
+    WaitQueueRoom();
+    ErrCode err = ERR_OK;
+    std::uint64_t sequence = 0;
+    bool isQueued = false;
+    {
+        std::lock_guard<std::mutex> tableLock(tableMutex_);
+        /* copy the outer maps only, the items maps not touched by the changes stay shared with the old table */
+        auto table = std::make_shared<PolicyTable>(*LoadTable());
+        for (const auto &record : records) {
+            ErrCode ret = ApplyPolicy(*table, record.adminName, record.policyName, record.adminPolicy,
+                record.mergedPolicy);
+            if (FAILED(ret) && !FAILED(err)) {
+                err = ret;
+            }
+            table->generation++;
+            SetGeneration(*table, record.adminName, record.policyName);
+        }
+        PublishTable(std::move(table));
+        /* the records are queued in the order the tables are published, the sequence counts every change */
+        std::lock_guard<std::mutex> lock(journalMutex_);
+        for (auto &record : records) {
+            record.sequence = ++journalSequence_;
+        }
+        sequence = journalSequence_;
+        QueuePolicy(records);
+        isQueued = workerRunning_;
+    }
+    /* the storage is written without tableMutex_, the other writers publish their tables meanwhile */
+    if (!isQueued) {
+        ErrCode ret = PersistInline(durableWrite_);
+        if (durableWrite_ && FAILED(ret)) {
+            return ret;
+        }
+    } else if (durableWrite_) {
+        std::unique_lock<std::mutex> lock(journalMutex_);
+        ErrCode ret = WaitPersisted(lock, sequence);
+        if (FAILED(ret)) {
+            return ret;
+        }
+    }
+    return err;
+}
+
+ErrCode PolicyManager::ApplyPolicy(PolicyTable &table, const std::string &adminName, const std::string &policyName,
+    const std::string &adminPolicy, const std::string &mergedPolicy)
+{
     ErrCode err;
     if (mergedPolicy.empty()) {
-        err = DeleteCombinedPolicy(policyName);
+        err = DeleteCombinedPolicy(table, policyName);
     } else {
-        err = SetCombinedPolicy(policyName, mergedPolicy);
+        err = SetCombinedPolicy(table, policyName, mergedPolicy);
     }
     if (FAILED(err)) {
         EDMLOGW("Set or delete combined policy failed:%{public}d, merged policy:%{public}s\n",
@@ -530,29 +811,18 @@ ErrCode PolicyManager::SetPolicy(const std::string &adminName, const std::string
 
     if (!adminName.empty()) {
         if (adminPolicy.empty()) {
-            err = DeleteAdminPolicy(adminName, policyName);
+            err = DeleteAdminPolicy(table, adminName, policyName);
         } else {
-            err = SetAdminPolicy(adminName, policyName, adminPolicy);
+            err = SetAdminPolicy(table, adminName, policyName, adminPolicy);
         }
     }
     if (FAILED(err)) {
         EDMLOGW("Set or delete admin policy failed:%{public}d, admin policy:%{public}s\n",
             err, adminPolicy.c_str());
     }
-
-    SavePolicy();
     return err;
 }
 
-void PolicyManager::CreateEmptyJsonFile()
-{
-    Json::Value adminObject(Json::arrayValue);
-    Json::Value combinedObject(Json::objectValue);
-    policyRoot_["AdminPolicies"] = adminObject;
-    policyRoot_["CombinedPolicies"] = combinedObject;
-    SavePolicy();
-}
-
 void PolicyManager::Init()
 {
     LoadPolicy();
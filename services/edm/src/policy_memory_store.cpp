@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "policy_memory_store.h"
+#include <algorithm>
+
+namespace OHOS {
+namespace EDM {
+constexpr std::size_t EDM_POLICY_MEMORY_STORE_MAX_DELTA = 1024;
+
+ErrCode PolicyMemoryStore::Load(PolicyTable &table, std::uint64_t &sequence, bool &needFlush)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    sequence = sequence_;
+    needFlush = false;
+    if (table_ != nullptr) {
+        /* the items maps are immutable, the loaded table shares them with the base version */
+        table.adminPolicies = table_->adminPolicies;
+        table.combinedPolicies = table_->combinedPolicies;
+        table.lazyAdmins = table_->lazyAdmins;
+        table.snapshot = table_->snapshot;
+    }
+    return ERR_OK;
+}
+
+std::uint64_t PolicyMemoryStore::ReplayDelta(std::uint64_t sequence, const PolicyDeltaHandler &handler)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::uint64_t lastSequence = sequence;
+    for (const auto &record : records_) {
+        if (record.sequence > sequence) {
+            handler(record);
+            lastSequence = std::max(lastSequence, record.sequence);
+        }
+    }
+    return lastSequence;
+}
+
+ErrCode PolicyMemoryStore::ApplyDelta(const std::vector<PolicyJournalRecord> &records, [[maybe_unused]] bool sync)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    records_.insert(records_.end(), records.begin(), records.end());
+    return ERR_OK;
+}
+
+ErrCode PolicyMemoryStore::Flush(const std::shared_ptr<const PolicyTable> &table, std::uint64_t sequence)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    table_ = table;
+    sequence_ = sequence;
+    records_.clear();
+    return ERR_OK;
+}
+
+void PolicyMemoryStore::Checkpoint(const std::shared_ptr<const PolicyTable> &table, std::uint64_t sequence)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (records_.size() < EDM_POLICY_MEMORY_STORE_MAX_DELTA) {
+            return;
+        }
+    }
+    /* keeping the table is cheap, the checkpoint is done synchronously */
+    Flush(table, sequence);
+}
+
+std::uint64_t PolicyMemoryStore::GetWrittenBytes()
+{
+    return 0;
+}
+} // namespace EDM
+} // namespace OHOS
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "policy_reply_cache.h"
+#include <mutex>
+#include <utility>
+
+namespace OHOS {
+namespace EDM {
+std::uint64_t PolicyReplyCache::Get(std::uint32_t policyCode, PolicyReply &reply, std::uint64_t &policyGeneration)
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto iter = entries_.find(policyCode);
+    if (iter == entries_.end()) {
+        reply = nullptr;
+        policyGeneration = 0;
+        missCount_++;
+        return 0;
+    }
+    reply = iter->second.reply;
+    policyGeneration = iter->second.policyGeneration;
+    if (reply == nullptr) {
+        missCount_++;
+    } else {
+        hitCount_++;
+    }
+    return iter->second.generation;
+}
+
+bool PolicyReplyCache::Put(std::uint32_t policyCode, std::uint64_t generation, std::uint64_t policyGeneration,
+    PolicyReply reply)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    Entry &entry = entries_[policyCode];
+    if (entry.generation != generation) {
+        return false;
+    }
+    entry.policyGeneration = policyGeneration;
+    entry.reply = std::move(reply);
+    return true;
+}
+
+void PolicyReplyCache::Invalidate(std::uint32_t policyCode)
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    Entry &entry = entries_[policyCode];
+    entry.generation++;
+    entry.reply = nullptr;
+}
+
+void PolicyReplyCache::Clear()
+{
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    for (auto &iter : entries_) {
+        iter.second.generation++;
+        iter.second.reply = nullptr;
+    }
+}
+
+std::uint64_t PolicyReplyCache::GetHitCount() const
+{
+    return hitCount_;
+}
+
+std::uint64_t PolicyReplyCache::GetMissCount() const
+{
+    return missCount_;
+}
+} // namespace EDM
+} // namespace OHOS
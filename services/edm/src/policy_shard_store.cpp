@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "policy_shard_store.h"
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <memory>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_set>
+#include "edm_log.h"
+#include "file_utils.h"
+#include "json/json.h"
+#include "policy_snapshot.h"
+
+namespace OHOS {
+namespace EDM {
+const std::string SHARD_MANIFEST_FILE = "manifest";
+const std::string SHARD_COMBINED_FILE = "combined.snapshot";
+const std::string SHARD_ADMIN_PREFIX = "admin_";
+const std::string SHARD_ADMIN_SUFFIX = ".snapshot";
+const std::string SHARD_BAK_SUFFIX = ".bak";
+const std::string SHARD_VERSION = "Version";
+constexpr int SHARD_LAYOUT_VERSION = 1;
+constexpr mode_t SHARD_DIR_MODE = 0700;
+constexpr mode_t SHARD_FILE_MODE = 0600;
+constexpr unsigned int SHARD_HEX_MASK = 0xF;
+constexpr unsigned int SHARD_HEX_SHIFT = 4;
+
+PolicyShardStore::PolicyShardStore(const std::string &dir) : dir_(dir) {}
+
+bool PolicyShardStore::IsCreated() const
+{
+    return access((dir_ + "/" + SHARD_MANIFEST_FILE).c_str(), F_OK) == 0;
+}
+
+std::string PolicyShardStore::GetAdminPath(const std::string &adminName) const
+{
+    /* bundle names are kept as they are, any other character is escaped to keep the name a valid file name */
+    static const char hexDigits[] = "0123456789abcdef";
+    std::string path = dir_ + "/" + SHARD_ADMIN_PREFIX;
+    for (unsigned char c : adminName) {
+        if (isalnum(c) || c == '.' || c == '_' || c == '-') {
+            path.push_back(static_cast<char>(c));
+        } else {
+            path.push_back('%');
+            path.push_back(hexDigits[(c >> SHARD_HEX_SHIFT) & SHARD_HEX_MASK]);
+            path.push_back(hexDigits[c & SHARD_HEX_MASK]);
+        }
+    }
+    return path + SHARD_ADMIN_SUFFIX;
+}
+
+bool PolicyShardStore::IsAdminFile(const std::string &fileName)
+{
+    return fileName.size() > SHARD_ADMIN_PREFIX.size() + SHARD_ADMIN_SUFFIX.size() &&
+        fileName.compare(0, SHARD_ADMIN_PREFIX.size(), SHARD_ADMIN_PREFIX) == 0 &&
+        fileName.compare(fileName.size() - SHARD_ADMIN_SUFFIX.size(), SHARD_ADMIN_SUFFIX.size(),
+            SHARD_ADMIN_SUFFIX) == 0;
+}
+
+ErrCode PolicyShardStore::Load(PolicyTable &table, std::uint64_t &journalSequence)
+{
+    std::ifstream ifs(dir_ + "/" + SHARD_MANIFEST_FILE);
+    Json::Value manifest;
+    Json::String errs;
+    Json::CharReaderBuilder builder;
+    if (!ifs.is_open() || !parseFromStream(builder, ifs, &manifest, &errs) || !manifest.isObject() ||
+        !manifest[SHARD_VERSION].isInt() || manifest[SHARD_VERSION].asInt() != SHARD_LAYOUT_VERSION) {
+        EDMLOGE("PolicyShardStore::Load manifest is damaged\n");
+        return ERR_EDM_POLICY_LOAD_JSON_FAILED;
+    }
+    PolicySnapshot combined;
+    ErrCode ret = combined.Open(dir_ + "/" + SHARD_COMBINED_FILE);
+    if (FAILED(ret) || !combined.GetCombinedPolicies(table.combinedPolicies)) {
+        EDMLOGE("PolicyShardStore::Load combined file is damaged\n");
+        return FAILED(ret) ? ret : ERR_EDM_POLICY_PARSE_JSON_FAILED;
+    }
+    journalSequence = combined.GetJournalSequence();
+
+    DIR *dir = opendir(dir_.c_str());
+    if (dir == nullptr) {
+        return ERR_EDM_POLICY_OPEN_JSON_FAILED;
+    }
+    ret = ERR_OK;
+    struct dirent *entry = nullptr;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string fileName = entry->d_name;
+        if (!IsAdminFile(fileName)) {
+            continue;
+        }
+        PolicySnapshot snapshot;
+        std::string adminName;
+        auto items = std::make_shared<PolicyValueMap>();
+        if (FAILED(snapshot.Open(dir_ + "/" + fileName)) || snapshot.GetAdminCount() != 1 ||
+            !snapshot.GetAdminName(0, adminName) || !snapshot.GetAdminPolicies(0, *items)) {
+            EDMLOGE("PolicyShardStore::Load admin file %{public}s is damaged\n", fileName.c_str());
+            ret = ERR_EDM_POLICY_PARSE_JSON_FAILED;
+            break;
+        }
+        if (!items->empty()) {
+            table.adminPolicies[adminName] = std::move(items);
+        }
+    }
+    closedir(dir);
+    return ret;
+}
+
+ErrCode PolicyShardStore::WriteAdmin(const std::string &adminName, const PolicyItemsHandle &policies,
+    std::uint64_t journalSequence, std::uint64_t &writtenBytes)
+{
+    writtenBytes = 0;
+    std::string path = GetAdminPath(adminName);
+    if (policies == nullptr || policies->empty()) {
+        /* the last policy of the admin is deleted */
+        if (unlink(path.c_str()) != 0 && errno != ENOENT) {
+            EDMLOGE("PolicyShardStore::WriteAdmin remove admin file failed, errno:%{public}d", errno);
+            return ERR_EDM_POLICY_DEL_FAILED;
+        }
+        return ERR_OK;
+    }
+    mkdir(dir_.c_str(), SHARD_DIR_MODE);
+    PolicyTable table;
+    table.adminPolicies[adminName] = policies;
+    return PolicySnapshot::Write(path, journalSequence, table, writtenBytes);
+}
+
+ErrCode PolicyShardStore::WriteCombined(const PolicyValueMap &policies, std::uint64_t journalSequence,
+    std::uint64_t &writtenBytes)
+{
+    mkdir(dir_.c_str(), SHARD_DIR_MODE);
+    PolicyTable table;
+    table.combinedPolicies = policies;
+    return PolicySnapshot::Write(dir_ + "/" + SHARD_COMBINED_FILE, journalSequence, table, writtenBytes);
+}
+
+ErrCode PolicyShardStore::RemoveStaleAdmins(const PolicyTable &table)
+{
+    std::unordered_set<std::string> adminPaths;
+    for (const auto &admin : table.adminPolicies) {
+        adminPaths.insert(GetAdminPath(admin.first));
+    }
+    DIR *dir = opendir(dir_.c_str());
+    if (dir == nullptr) {
+        /* nothing is left if the directory is not created yet */
+        return (errno == ENOENT) ? ERR_OK : ERR_EDM_POLICY_OPEN_JSON_FAILED;
+    }
+    ErrCode ret = ERR_OK;
+    struct dirent *entry = nullptr;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string fileName = entry->d_name;
+        std::string path = dir_ + "/" + fileName;
+        if (IsAdminFile(fileName) && adminPaths.find(path) == adminPaths.end() && unlink(path.c_str()) != 0) {
+            EDMLOGE("PolicyShardStore::RemoveStaleAdmins remove %{public}s failed\n", fileName.c_str());
+            ret = ERR_EDM_POLICY_DEL_FAILED;
+        }
+    }
+    closedir(dir);
+    return ret;
+}
+
+ErrCode PolicyShardStore::WriteManifest()
+{
+    Json::Value manifest(Json::objectValue);
+    manifest[SHARD_VERSION] = SHARD_LAYOUT_VERSION;
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "    ";
+    std::string buffer = Json::writeString(builder, manifest);
+    std::string path = dir_ + "/" + SHARD_MANIFEST_FILE;
+    std::string bakPath = path + SHARD_BAK_SUFFIX;
+    int fd = open(bakPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, SHARD_FILE_MODE);
+    if (fd < 0) {
+        EDMLOGE("PolicyShardStore::WriteManifest open manifest failed, errno:%{public}d", errno);
+        return ERR_EDM_POLICY_OPEN_JSON_FAILED;
+    }
+    /* the other layout is removed once the manifest exists, it must be on the storage device by then */
+    bool isWriteSuccess = FileUtils::WriteAll(fd, buffer) && fdatasync(fd) == 0;
+    close(fd);
+    if (!isWriteSuccess || std::rename(bakPath.c_str(), path.c_str()) != 0 || !FileUtils::SyncDir(path)) {
+        EDMLOGE("PolicyShardStore::WriteManifest write manifest failed, errno:%{public}d", errno);
+        unlink(bakPath.c_str());
+        return ERR_EDM_POLICY_SET_FAILED;
+    }
+    return ERR_OK;
+}
+
+void PolicyShardStore::Remove()
+{
+    unlink((dir_ + "/" + SHARD_MANIFEST_FILE).c_str());
+    DIR *dir = opendir(dir_.c_str());
+    if (dir == nullptr) {
+        return;
+    }
+    struct dirent *entry = nullptr;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string fileName = entry->d_name;
+        if (fileName != "." && fileName != "..") {
+            unlink((dir_ + "/" + fileName).c_str());
+        }
+    }
+    closedir(dir);
+    rmdir(dir_.c_str());
+}
+} // namespace EDM
+} // namespace OHOS
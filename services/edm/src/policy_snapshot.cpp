@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "policy_snapshot.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include "edm_log.h"
+#include "file_utils.h"
+
+namespace OHOS {
+namespace EDM {
+constexpr std::uint32_t SNAPSHOT_MAGIC = 0x534D4445; /* "EDMS" */
+constexpr std::uint32_t SNAPSHOT_VERSION = 1;
+constexpr mode_t SNAPSHOT_FILE_MODE = 0600;
+const std::string SNAPSHOT_BAK_SUFFIX = ".bak";
+
+enum SectionType : std::uint32_t {
+    SECTION_ADMIN = 0,
+    SECTION_POLICY,
+    SECTION_COMBINED,
+    SECTION_DATA,
+    SECTION_NUM,
+};
+
+struct SnapshotHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t journalSequence;
+    std::uint64_t fileSize;
+    std::uint32_t sectionCount;
+    std::uint32_t indexCrc;
+};
+
+struct PolicySnapshot::Section {
+    std::uint32_t type;
+    std::uint32_t reserved;
+    std::uint64_t offset;
+    std::uint64_t size;
+    std::uint64_t count;
+};
+
+struct PolicySnapshot::ItemEntry {
+    std::uint64_t keyOffset;
+    std::uint64_t valueOffset;
+    std::uint32_t keyLength;
+    std::uint32_t valueLength;
+};
+
+struct PolicySnapshot::AdminEntry {
+    std::uint64_t nameOffset;
+    std::uint64_t firstPolicy;
+    std::uint32_t nameLength;
+    std::uint32_t policyCount;
+};
+
+static std::uint64_t AppendData(std::string &data, const std::string &value)
+{
+    std::uint64_t offset = data.size();
+    data.append(value);
+    return offset;
+}
+
+template<typename T>
+static void AppendTable(std::string &buffer, const std::vector<T> &table)
+{
+    if (!table.empty()) {
+        buffer.append(reinterpret_cast<const char *>(table.data()), table.size() * sizeof(T));
+    }
+}
+
+PolicySnapshot::~PolicySnapshot()
+{
+    Close();
+}
+
+ErrCode PolicySnapshot::Open(const std::string &path)
+{
+    Close();
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return ERR_EDM_POLICY_OPEN_JSON_FAILED;
+    }
+    struct stat fileStat = {};
+    if (fstat(fd, &fileStat) != 0 || static_cast<std::uint64_t>(fileStat.st_size) < sizeof(SnapshotHeader)) {
+        close(fd);
+        EDMLOGW("PolicySnapshot::Open snapshot is too small");
+        return ERR_EDM_POLICY_LOAD_JSON_FAILED;
+    }
+    size_ = static_cast<std::uint64_t>(fileStat.st_size);
+    void *addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        EDMLOGE("PolicySnapshot::Open mmap failed, errno:%{public}d", errno);
+        size_ = 0;
+        return ERR_EDM_POLICY_LOAD_JSON_FAILED;
+    }
+    base_ = static_cast<const char *>(addr);
+    if (!CheckIndex()) {
+        EDMLOGW("PolicySnapshot::Open snapshot is damaged");
+        Close();
+        return ERR_EDM_POLICY_PARSE_JSON_FAILED;
+    }
+    return ERR_OK;
+}
+
+bool PolicySnapshot::CheckIndex()
+{
+    const auto *header = reinterpret_cast<const SnapshotHeader *>(base_);
+    if (header->magic != SNAPSHOT_MAGIC || header->version != SNAPSHOT_VERSION || header->fileSize != size_ ||
+        header->sectionCount != SECTION_NUM || size_ - sizeof(SnapshotHeader) < SECTION_NUM * sizeof(Section)) {
+        return false;
+    }
+    const auto *sections = reinterpret_cast<const Section *>(base_ + sizeof(SnapshotHeader));
+    for (std::uint32_t i = 0; i < SECTION_NUM; ++i) {
+        if (sections[i].type != i || sections[i].offset > size_ || sections[i].size > size_ - sections[i].offset) {
+            return false;
+        }
+    }
+    const Section &admin = sections[SECTION_ADMIN];
+    const Section &policy = sections[SECTION_POLICY];
+    const Section &combined = sections[SECTION_COMBINED];
+    const Section &data = sections[SECTION_DATA];
+    if (admin.size != admin.count * sizeof(AdminEntry) || policy.size != policy.count * sizeof(ItemEntry) ||
+        combined.size != combined.count * sizeof(ItemEntry) || data.offset < sizeof(SnapshotHeader)) {
+        return false;
+    }
+    /* the crc covers the section table and the index tables, the string data is checked by bounds only */
+    if (FileUtils::Crc32(base_ + sizeof(SnapshotHeader), data.offset - sizeof(SnapshotHeader)) != header->indexCrc) {
+        return false;
+    }
+    journalSequence_ = header->journalSequence;
+    admins_ = reinterpret_cast<const AdminEntry *>(base_ + admin.offset);
+    adminCount_ = static_cast<std::uint32_t>(admin.count);
+    policies_ = reinterpret_cast<const ItemEntry *>(base_ + policy.offset);
+    policyCount_ = policy.count;
+    combined_ = reinterpret_cast<const ItemEntry *>(base_ + combined.offset);
+    combinedCount_ = combined.count;
+    data_ = base_ + data.offset;
+    dataSize_ = data.size;
+    return true;
+}
+
+void PolicySnapshot::Close()
+{
+    if (base_ != nullptr) {
+        munmap(const_cast<char *>(base_), size_);
+    }
+    base_ = nullptr;
+    size_ = 0;
+    journalSequence_ = 0;
+    admins_ = nullptr;
+    adminCount_ = 0;
+    policies_ = nullptr;
+    policyCount_ = 0;
+    combined_ = nullptr;
+    combinedCount_ = 0;
+    data_ = nullptr;
+    dataSize_ = 0;
+}
+
+std::uint64_t PolicySnapshot::GetJournalSequence() const
+{
+    return journalSequence_;
+}
+
+std::uint32_t PolicySnapshot::GetAdminCount() const
+{
+    return adminCount_;
+}
+
+bool PolicySnapshot::GetString(std::uint64_t offset, std::uint32_t length, std::string &value) const
+{
+    if (offset > dataSize_ || length > dataSize_ - offset) {
+        return false;
+    }
+    value.assign(data_ + offset, length);
+    return true;
+}
+
+bool PolicySnapshot::GetItems(const ItemEntry *entries, std::uint64_t begin, std::uint64_t count,
+    PolicyValueMap &items) const
+{
+    for (std::uint64_t i = begin; i < begin + count; ++i) {
+        std::string key;
+        std::string value;
+        if (!GetString(entries[i].keyOffset, entries[i].keyLength, key) ||
+            !GetString(entries[i].valueOffset, entries[i].valueLength, value)) {
+            return false;
+        }
+        items[key] = MakePolicyValue(std::move(value));
+    }
+    return true;
+}
+
+bool PolicySnapshot::GetAdminName(std::uint32_t index, std::string &adminName) const
+{
+    if (index >= adminCount_) {
+        return false;
+    }
+    return GetString(admins_[index].nameOffset, admins_[index].nameLength, adminName);
+}
+
+bool PolicySnapshot::CheckAdminPolicies(std::uint32_t index) const
+{
+    if (index >= adminCount_) {
+        return false;
+    }
+    const AdminEntry &admin = admins_[index];
+    return admin.firstPolicy <= policyCount_ && admin.policyCount <= policyCount_ - admin.firstPolicy;
+}
+
+bool PolicySnapshot::GetAdminPolicies(std::uint32_t index, PolicyValueMap &policies) const
+{
+    if (!CheckAdminPolicies(index)) {
+        return false;
+    }
+    return GetItems(policies_, admins_[index].firstPolicy, admins_[index].policyCount, policies);
+}
+
+bool PolicySnapshot::GetAdminPolicy(std::uint32_t index, const std::string &policyName,
+    std::string &policyValue) const
+{
+    if (!CheckAdminPolicies(index)) {
+        return false;
+    }
+    const AdminEntry &admin = admins_[index];
+    for (std::uint64_t i = admin.firstPolicy; i < admin.firstPolicy + admin.policyCount; ++i) {
+        /* compare in place, only the value asked for is copied out of the mapping */
+        const ItemEntry &entry = policies_[i];
+        if (entry.keyLength == policyName.size() && entry.keyOffset <= dataSize_ &&
+            entry.keyLength <= dataSize_ - entry.keyOffset &&
+            policyName.compare(0, policyName.size(), data_ + entry.keyOffset, entry.keyLength) == 0) {
+            return GetString(entry.valueOffset, entry.valueLength, policyValue);
+        }
+    }
+    return false;
+}
+
+bool PolicySnapshot::GetCombinedPolicies(PolicyValueMap &policies) const
+{
+    if (base_ == nullptr) {
+        return false;
+    }
+    return GetItems(combined_, 0, combinedCount_, policies);
+}
+
+ErrCode PolicySnapshot::Write(const std::string &path, std::uint64_t journalSequence, const PolicyTable &table,
+    std::uint64_t &writtenBytes)
+{
+    writtenBytes = 0;
+    std::string data;
+    std::vector<AdminEntry> adminTable;
+    std::vector<ItemEntry> policyTable;
+    std::vector<ItemEntry> combinedTable;
+    adminTable.reserve(table.adminPolicies.size());
+    for (const auto &admin : table.adminPolicies) {
+        AdminEntry adminEntry = {AppendData(data, admin.first), policyTable.size(),
+            static_cast<std::uint32_t>(admin.first.size()), static_cast<std::uint32_t>(admin.second->size())};
+        adminTable.push_back(adminEntry);
+        for (const auto &item : *admin.second) {
+            ItemEntry itemEntry = {AppendData(data, item.first), AppendData(data, *item.second),
+                static_cast<std::uint32_t>(item.first.size()), static_cast<std::uint32_t>(item.second->size())};
+            policyTable.push_back(itemEntry);
+        }
+    }
+    for (const auto &item : table.combinedPolicies) {
+        ItemEntry itemEntry = {AppendData(data, item.first), AppendData(data, *item.second),
+            static_cast<std::uint32_t>(item.first.size()), static_cast<std::uint32_t>(item.second->size())};
+        combinedTable.push_back(itemEntry);
+    }
+
+    Section sections[SECTION_NUM] = {};
+    std::uint64_t offset = sizeof(SnapshotHeader) + sizeof(sections);
+    std::uint64_t counts[SECTION_NUM] = {adminTable.size(), policyTable.size(), combinedTable.size(), 0};
+    std::uint64_t sizes[SECTION_NUM] = {adminTable.size() * sizeof(AdminEntry),
+        policyTable.size() * sizeof(ItemEntry), combinedTable.size() * sizeof(ItemEntry), data.size()};
+    for (std::uint32_t i = 0; i < SECTION_NUM; ++i) {
+        sections[i] = {i, 0, offset, sizes[i], counts[i]};
+        offset += sizes[i];
+    }
+
+    std::string index(reinterpret_cast<const char *>(sections), sizeof(sections));
+    AppendTable(index, adminTable);
+    AppendTable(index, policyTable);
+    AppendTable(index, combinedTable);
+    SnapshotHeader header = {SNAPSHOT_MAGIC, SNAPSHOT_VERSION, journalSequence, offset, SECTION_NUM,
+        FileUtils::Crc32(index.data(), index.size())};
+    std::string buffer(reinterpret_cast<const char *>(&header), sizeof(header));
+    buffer.reserve(offset);
+    buffer.append(index);
+    buffer.append(data);
+
+    std::string bakPath = path + SNAPSHOT_BAK_SUFFIX;
+    int fd = open(bakPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, SNAPSHOT_FILE_MODE);
+    if (fd < 0) {
+        EDMLOGE("PolicySnapshot::Write open snapshot failed, errno:%{public}d", errno);
+        return ERR_EDM_POLICY_OPEN_JSON_FAILED;
+    }
+    /* the journal is dropped once the snapshot is written, the snapshot must be on the storage device by then */
+    bool isWriteSuccess = FileUtils::WriteAll(fd, buffer) && fdatasync(fd) == 0;
+    close(fd);
+    if (!isWriteSuccess || std::rename(bakPath.c_str(), path.c_str()) != 0) {
+        EDMLOGE("PolicySnapshot::Write write snapshot failed, errno:%{public}d", errno);
+        unlink(bakPath.c_str());
+        return ERR_EDM_POLICY_SET_FAILED;
+    }
+    if (!FileUtils::SyncDir(path)) {
+        EDMLOGE("PolicySnapshot::Write sync snapshot dir failed, errno:%{public}d", errno);
+        return ERR_EDM_POLICY_SET_FAILED;
+    }
+    writtenBytes = buffer.size();
+    return ERR_OK;
+}
+} // namespace EDM
+} // namespace OHOS
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "policy_transaction.h"
+#include "edm_log.h"
+#include "policy_manager.h"
+
+namespace OHOS {
+namespace EDM {
+PolicyTransaction::PolicyTransaction(std::shared_ptr<PolicyManager> policyMgr) : policyMgr_(std::move(policyMgr)) {}
+
+PolicyTransaction::~PolicyTransaction()
+{
+    if (!records_.empty()) {
+        EDMLOGW("PolicyTransaction: abort %{public}zu changes not committed\n", records_.size());
+    }
+}
+
+ErrCode PolicyTransaction::SetPolicy(const std::string &adminName, const std::string &policyName,
+    const std::string &adminPolicyValue, const std::string &mergedPolicyValue)
+{
+    if (policyName.empty()) {
+        return ERR_EDM_POLICY_SET_FAILED;
+    }
+    PolicyJournalRecord record;
+    record.adminName = adminName;
+    record.policyName = policyName;
+    record.adminPolicy = adminPolicyValue;
+    record.mergedPolicy = mergedPolicyValue;
+    records_.push_back(std::move(record));
+    return ERR_OK;
+}
+
+ErrCode PolicyTransaction::Commit()
+{
+    if (records_.empty()) {
+        return ERR_OK;
+    }
+    std::vector<PolicyJournalRecord> records;
+    records.swap(records_);
+    return policyMgr_->CommitPolicies(records);
+}
+
+void PolicyTransaction::Abort()
+{
+    records_.clear();
+}
+
+std::size_t PolicyTransaction::GetSize() const
+{
+    return records_.size();
+}
+} // namespace EDM
+} // namespace OHOS
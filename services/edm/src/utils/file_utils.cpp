@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "file_utils.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace OHOS {
+namespace EDM {
+constexpr std::uint32_t CRC32_POLY = 0xEDB88320;
+
+std::uint32_t FileUtils::Crc32(const char *data, std::size_t size)
+{
+    std::uint32_t crc = 0xFFFFFFFF;
+    for (std::size_t i = 0; i < size; ++i) {
+        crc ^= static_cast<std::uint8_t>(data[i]);
+        for (int bit = 0; bit < 8; ++bit) { // 8 bits per byte
+            crc = (crc >> 1) ^ (CRC32_POLY & (~(crc & 1) + 1));
+        }
+    }
+    return ~crc;
+}
+
+bool FileUtils::WriteAll(int fd, const std::string &buffer)
+{
+    std::size_t written = 0;
+    while (written < buffer.size()) {
+        ssize_t ret = write(fd, buffer.data() + written, buffer.size() - written);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        written += static_cast<std::size_t>(ret);
+    }
+    return true;
+}
+
+bool FileUtils::SyncDir(const std::string &filePath)
+{
+    std::string::size_type pos = filePath.rfind('/');
+    std::string dirPath = (pos == std::string::npos) ? "." : filePath.substr(0, (pos == 0) ? 1 : pos);
+    int fd = open(dirPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    bool isSynced = (fsync(fd) == 0);
+    close(fd);
+    return isSynced;
+}
+} // namespace EDM
+} // namespace OHOS
@@ -46,6 +46,7 @@ FuncOperateType FuncCodeUtils::ConvertOperateType(std::uint32_t type)
         case static_cast<std::uint32_t>(FuncOperateType::GET):
         case static_cast<std::uint32_t>(FuncOperateType::SET):
         case static_cast<std::uint32_t>(FuncOperateType::REMOVE):
+        case static_cast<std::uint32_t>(FuncOperateType::GET_IF_MODIFIED):
             result = static_cast<FuncOperateType>(type);
             break;
         default:
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "lock_stats.h"
+#include "edm_log.h"
+
+namespace OHOS {
+namespace EDM {
+LockStats::LockStats(const std::string &name) : name_(name) {}
+
+std::uint64_t LockStats::GetAcquireCount() const
+{
+    return acquireCount_;
+}
+
+std::uint64_t LockStats::GetContendedCount() const
+{
+    return contendedCount_;
+}
+
+std::uint64_t LockStats::GetWaitTimeUs() const
+{
+    return waitTimeUs_;
+}
+
+void LockStats::Reset()
+{
+    acquireCount_ = 0;
+    contendedCount_ = 0;
+    waitTimeUs_ = 0;
+}
+
+void LockStats::Dump() const
+{
+    EDMLOGI("LockStats %{public}s: acquire:%{public}llu, contended:%{public}llu, wait:%{public}llu us",
+        name_.c_str(), static_cast<unsigned long long>(GetAcquireCount()),
+        static_cast<unsigned long long>(GetContendedCount()), static_cast<unsigned long long>(GetWaitTimeUs()));
+}
+} // namespace EDM
+} // namespace OHOS
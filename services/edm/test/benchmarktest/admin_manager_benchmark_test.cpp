@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "admin_manager.h"
+#include "permission_manager.h"
+#include "string_ex.h"
+
+namespace OHOS {
+namespace EDM {
+namespace BENCHMARK {
+const std::string BENCHMARK_ADMIN_PACKAGE_PREFIX = "com.edm.benchmark.package";
+constexpr int BENCHMARK_ADMIN_NUM = 500;
+constexpr int BENCHMARK_LOOKUP_INDEX = 0;
+constexpr int BENCHMARK_LOOKUP_LINEAR = 1;
+
+/*
+ * Find the admin the way GetAdminByPkgName did before the index: compare every package name.
+ */
+static std::shared_ptr<Admin> FindAdminLinear(const AdminList &admins, const std::string &packageName)
+{
+    for (auto &item : admins) {
+        if (item->adminInfo_.packageName_ == packageName) {
+            return item;
+        }
+    }
+    return nullptr;
+}
+
+static void PrepareAdmins(std::shared_ptr<AdminManager> adminMgr, int adminNum = BENCHMARK_ADMIN_NUM)
+{
+    AppExecFwk::AbilityInfo abilityInfo;
+    abilityInfo.name = "benchmarkAbility";
+    EntInfo entInfo;
+    std::vector<std::string> permissions;
+    for (int i = 0; i < adminNum; ++i) {
+        abilityInfo.bundleName = BENCHMARK_ADMIN_PACKAGE_PREFIX + std::to_string(i);
+        adminMgr->SetAdminValue(abilityInfo, entInfo, AdminType::NORMAL, permissions);
+    }
+}
+
+static void RemoveAdmins(std::shared_ptr<AdminManager> adminMgr)
+{
+    for (int i = 0; i < BENCHMARK_ADMIN_NUM; ++i) {
+        adminMgr->DeleteAdmin(BENCHMARK_ADMIN_PACKAGE_PREFIX + std::to_string(i));
+    }
+}
+
+/*
+ * Look up every one of BENCHMARK_ADMIN_NUM admins by package name plus one missing package,
+ * range(0) chooses the hash index of AdminManager or the linear scan.
+ */
+static void BM_GetAdminByPkgName(benchmark::State &state)
+{
+    std::shared_ptr<AdminManager> adminMgr = AdminManager::GetInstance();
+    PrepareAdmins(adminMgr);
+    std::vector<std::string> packageNames;
+    for (int i = 0; i <= BENCHMARK_ADMIN_NUM; ++i) {
+        packageNames.push_back(BENCHMARK_ADMIN_PACKAGE_PREFIX + std::to_string(i));
+    }
+    AdminList admins;
+    adminMgr->GetAllAdmin(admins);
+    bool isIndex = state.range(0) == BENCHMARK_LOOKUP_INDEX;
+    std::size_t count = 0;
+    for (auto _ : state) {
+        const std::string &packageName = packageNames[count++ % packageNames.size()];
+        std::shared_ptr<Admin> admin =
+            isIndex ? adminMgr->GetAdminByPkgName(packageName) : FindAdminLinear(admins, packageName);
+        benchmark::DoNotOptimize(admin);
+    }
+    RemoveAdmins(adminMgr);
+}
+
+BENCHMARK(BM_GetAdminByPkgName)
+    ->ArgName("linear")
+    ->Arg(BENCHMARK_LOOKUP_INDEX)
+    ->Arg(BENCHMARK_LOOKUP_LINEAR);
+
+/*
+ * Check for a super admin among BENCHMARK_ADMIN_NUM normal admins, range(0) chooses the counter of
+ * AdminManager or the scan of the list.
+ */
+static void BM_IsSuperAdminExist(benchmark::State &state)
+{
+    std::shared_ptr<AdminManager> adminMgr = AdminManager::GetInstance();
+    PrepareAdmins(adminMgr);
+    AdminList admins;
+    adminMgr->GetAllAdmin(admins);
+    bool isIndex = state.range(0) == BENCHMARK_LOOKUP_INDEX;
+    for (auto _ : state) {
+        bool isExist = isIndex ? adminMgr->IsSuperAdminExist() :
+            std::any_of(admins.begin(), admins.end(), [](const std::shared_ptr<Admin> &admin) {
+                return admin->adminInfo_.adminType_ == AdminType::ENT;
+            });
+        benchmark::DoNotOptimize(isExist);
+    }
+    RemoveAdmins(adminMgr);
+}
+
+BENCHMARK(BM_IsSuperAdminExist)
+    ->ArgName("linear")
+    ->Arg(BENCHMARK_LOOKUP_INDEX)
+    ->Arg(BENCHMARK_LOOKUP_LINEAR);
+
+/*
+ * Check the last permission of an admin granted every known permission, range(0) chooses the bit test
+ * of the permission id or the compare of the permission names.
+ */
+static void BM_CheckPermission(benchmark::State &state)
+{
+    Admin admin;
+    for (const auto &item : ADMIN_PERMISSIONS) {
+        admin.adminInfo_.permission_.push_back(item.permissionName);
+    }
+    PermissionManager::GetInstance()->GetPermissionBits(admin.adminInfo_.permission_,
+        admin.adminInfo_.permissionBits_);
+    const std::string &permission = admin.adminInfo_.permission_.back();
+    std::uint32_t permissionId = PermissionManager::GetInstance()->GetPermissionId(permission);
+    bool isIndex = state.range(0) == BENCHMARK_LOOKUP_INDEX;
+    for (auto _ : state) {
+        bool isGranted = isIndex ? admin.CheckPermissionId(permissionId) :
+            std::any_of(admin.adminInfo_.permission_.begin(), admin.adminInfo_.permission_.end(),
+                [&permission](const std::string &item) { return item == permission; });
+        benchmark::DoNotOptimize(isGranted);
+    }
+}
+
+BENCHMARK(BM_CheckPermission)
+    ->ArgName("linear")
+    ->Arg(BENCHMARK_LOOKUP_INDEX)
+    ->Arg(BENCHMARK_LOOKUP_LINEAR);
+
+/*
+ * Build the GET_ACTIVE_ADMIN reply list of BENCHMARK_ADMIN_NUM normal admins, range(0) chooses the copy
+ * of the cached list or the way it was built before: the names of every admin joined, inserted at the
+ * front of the list and converted to UTF-16.
+ */
+static void BM_GetActiveAdmin(benchmark::State &state)
+{
+    std::shared_ptr<AdminManager> adminMgr = AdminManager::GetInstance();
+    PrepareAdmins(adminMgr);
+    bool isIndex = state.range(0) == BENCHMARK_LOOKUP_INDEX;
+    for (auto _ : state) {
+        std::vector<std::u16string> activeAdminList;
+        if (isIndex) {
+            activeAdminList = *adminMgr->GetActiveAdminList(AdminType::NORMAL);
+        } else {
+            AdminList admins;
+            adminMgr->GetAllAdmin(admins);
+            std::vector<std::string> normalList;
+            for (const auto &item : admins) {
+                normalList.push_back(item->adminInfo_.packageName_ + "/" + item->adminInfo_.className_);
+            }
+            std::vector<std::string> nameList;
+            nameList.insert(nameList.begin(), normalList.begin(), normalList.end());
+            for (const auto &name : nameList) {
+                activeAdminList.push_back(Str8ToStr16(name));
+            }
+        }
+        benchmark::DoNotOptimize(activeAdminList);
+    }
+    RemoveAdmins(adminMgr);
+}
+
+BENCHMARK(BM_GetActiveAdmin)
+    ->ArgName("linear")
+    ->Arg(BENCHMARK_LOOKUP_INDEX)
+    ->Arg(BENCHMARK_LOOKUP_LINEAR);
+
+/*
+ * Change the enterprise info of one of range(0) admins, every change appends one record to the
+ * admin record file whatever the count of the admins.
+ */
+static void BM_SetEntInfo(benchmark::State &state)
+{
+    std::shared_ptr<AdminManager> adminMgr = AdminManager::GetInstance();
+    int adminNum = static_cast<int>(state.range(0));
+    PrepareAdmins(adminMgr, adminNum);
+    EntInfo entInfo;
+    entInfo.description = "benchmark enterprise";
+    std::uint64_t beginBytes = adminMgr->GetPersistedBytes();
+    std::int64_t count = 0;
+    for (auto _ : state) {
+        entInfo.enterpriseName = "company" + std::to_string(count);
+        adminMgr->SetEntInfo(BENCHMARK_ADMIN_PACKAGE_PREFIX + std::to_string(count % adminNum), entInfo);
+        count++;
+    }
+    std::uint64_t persistedBytes = adminMgr->GetPersistedBytes() - beginBytes;
+    state.counters["bytes/SetEntInfo"] = count > 0 ? static_cast<double>(persistedBytes) / count : 0;
+    RemoveAdmins(adminMgr);
+}
+
+BENCHMARK(BM_SetEntInfo)
+    ->ArgName("admins")
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(BENCHMARK_ADMIN_NUM)
+    ->Unit(benchmark::kMicrosecond);
+} // namespace BENCHMARK
+} // namespace EDM
+} // namespace OHOS
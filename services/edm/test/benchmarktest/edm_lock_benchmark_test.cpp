@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include "lock_stats.h"
+#include "policy_manager.h"
+
+namespace OHOS {
+namespace EDM {
+namespace BENCHMARK {
+const std::string BENCHMARK_LOCK_ADMIN_PREFIX = "com.edm.benchmark.lock.admin";
+const std::string BENCHMARK_LOCK_POLICY_PREFIX = "benchmarkLockPolicy";
+constexpr int BENCHMARK_LOCK_MODE_GLOBAL = 0;
+constexpr size_t BENCHMARK_POLICY_LOCK_NUM = 32;
+constexpr auto BENCHMARK_SLOW_PLUGIN_TIME = std::chrono::milliseconds(1);
+constexpr int BENCHMARK_QUERY_PER_WRITE = 4;
+
+/*
+ * The lock layout of EnterpriseDeviceMgrAbility before and after the lock domains were split.
+ */
+struct AbilityLocks {
+    std::mutex globalLock;
+    std::shared_mutex adminLock;
+    std::array<std::mutex, BENCHMARK_POLICY_LOCK_NUM> policyLocks;
+    LockStats stats {"benchmark"};
+};
+
+static void HandlePolicy(AbilityLocks &locks, bool isGlobal, uint32_t code, const std::string &adminName)
+{
+    std::unique_lock<std::mutex> globalLock(locks.globalLock, std::defer_lock);
+    std::shared_lock<std::shared_mutex> adminLock(locks.adminLock, std::defer_lock);
+    std::unique_lock<std::mutex> policyLock(locks.policyLocks[code % BENCHMARK_POLICY_LOCK_NUM], std::defer_lock);
+    if (isGlobal) {
+        locks.stats.Acquire(globalLock);
+    } else {
+        locks.stats.Acquire(adminLock);
+        locks.stats.Acquire(policyLock);
+    }
+    std::string policyName = BENCHMARK_LOCK_POLICY_PREFIX + std::to_string(code);
+    std::string policyValue;
+    PolicyManager::GetInstance()->GetPolicy(adminName, policyName, policyValue);
+    if (code == 0) {
+        /* a plugin calling a slow system service, such as SetDateTime */
+        std::this_thread::sleep_for(BENCHMARK_SLOW_PLUGIN_TIME);
+    }
+    PolicyManager::GetInstance()->SetPolicy(adminName, policyName, "true", "true");
+}
+
+static bool IsAdminActive(AbilityLocks &locks, bool isGlobal, const std::string &adminName)
+{
+    std::unique_lock<std::mutex> globalLock(locks.globalLock, std::defer_lock);
+    if (isGlobal) {
+        locks.stats.Acquire(globalLock);
+    }
+    std::unordered_map<std::string, std::string> policies;
+    return PolicyManager::GetInstance()->GetAllPolicyByAdmin(adminName, policies) == ERR_OK;
+}
+
+/*
+ * A background thread keeps handling a slow policy while the benchmark threads handle their own
+ * policy and query their admin state. range(0) chooses the single ability mutex or the split lock domains.
+ */
+static void BM_MixedLoadContention(benchmark::State &state)
+{
+    static AbilityLocks locks;
+    static std::thread slowPlugin;
+    static std::atomic<bool> slowPluginStopping {false};
+    bool isGlobal = state.range(0) == BENCHMARK_LOCK_MODE_GLOBAL;
+    if (state.thread_index() == 0) {
+        PolicyManager::GetInstance()->Init();
+        PolicyManager::GetInstance()->SetJournalEnabled(true);
+        locks.stats.Reset();
+        slowPluginStopping = false;
+        slowPlugin = std::thread([isGlobal]() {
+            while (!slowPluginStopping) {
+                HandlePolicy(locks, isGlobal, 0, BENCHMARK_LOCK_ADMIN_PREFIX);
+            }
+        });
+    }
+    uint32_t code = static_cast<uint32_t>(state.thread_index()) + 1;
+    std::string adminName = BENCHMARK_LOCK_ADMIN_PREFIX + std::to_string(code);
+    for (auto _ : state) {
+        HandlePolicy(locks, isGlobal, code, adminName);
+        for (int i = 0; i < BENCHMARK_QUERY_PER_WRITE; ++i) {
+            benchmark::DoNotOptimize(IsAdminActive(locks, isGlobal, adminName));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (BENCHMARK_QUERY_PER_WRITE + 1));
+    if (state.thread_index() == 0) {
+        slowPluginStopping = true;
+        slowPlugin.join();
+        state.counters["contended_ratio"] = locks.stats.GetAcquireCount() == 0 ? 0 :
+            static_cast<double>(locks.stats.GetContendedCount()) / locks.stats.GetAcquireCount();
+        state.counters["wait_us"] = static_cast<double>(locks.stats.GetWaitTimeUs());
+    }
+}
+
+BENCHMARK(BM_MixedLoadContention)
+    ->ArgNames({"split"})
+    ->Arg(0)
+    ->Arg(1)
+    ->Threads(1)
+    ->Threads(4)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+} // namespace BENCHMARK
+} // namespace EDM
+} // namespace OHOS
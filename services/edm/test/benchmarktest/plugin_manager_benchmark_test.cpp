@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <map>
+#include <memory>
+#include <string>
+#include "func_code_utils.h"
+#include "iplugin.h"
+#include "plugin_manager.h"
+
+namespace OHOS {
+namespace EDM {
+namespace BENCHMARK {
+constexpr int BENCHMARK_LOOKUP_MODE_MAP = 0;
+constexpr std::uint32_t BENCHMARK_PLUGIN_NUM = 64;
+
+class BenchmarkPlugin : public IPlugin {
+public:
+    explicit BenchmarkPlugin(std::uint32_t code)
+    {
+        policyCode_ = code;
+        policyName_ = "BenchmarkPlugin" + std::to_string(code);
+        permission_ = "ohos.permission.EDM_TEST_PERMISSION";
+    }
+
+    ErrCode OnHandlePolicy(std::uint32_t funcCode, MessageParcel &data, std::string &policyData,
+        bool &isChanged) override
+    {
+        return ERR_OK;
+    }
+
+    void OnHandlePolicyDone(std::uint32_t funcCode, const std::string &adminName, bool isGlobalChanged) override {}
+
+    ErrCode OnAdminRemove(const std::string &adminName, const std::string &policyData) override
+    {
+        return ERR_OK;
+    }
+
+    void OnAdminRemoveDone(const std::string &adminName, const std::string &policyData) override {}
+};
+
+/*
+ * Measure the plugin lookup of every policy request, range(0) chooses the former lookup (bitset
+ * formatting, map find and a shared_ptr copy) or PluginManager::GetPluginByFuncCode.
+ */
+static void BM_GetPluginByFuncCode(benchmark::State &state)
+{
+    bool isMap = (state.range(0) == BENCHMARK_LOOKUP_MODE_MAP);
+    std::map<std::uint32_t, std::shared_ptr<IPlugin>> pluginsCode;
+    for (std::uint32_t code = 0; code < BENCHMARK_PLUGIN_NUM; ++code) {
+        auto plugin = std::make_shared<BenchmarkPlugin>(code);
+        PluginManager::GetInstance()->AddPlugin(plugin);
+        pluginsCode.insert(std::make_pair(code, plugin));
+    }
+    std::uint32_t code = 0;
+    for (auto _ : state) {
+        std::uint32_t funcCode = POLICY_FUNC_CODE(static_cast<std::uint32_t>(FuncOperateType::GET), code);
+        if (isMap) {
+            FuncCodeUtils::PrintFuncCode(funcCode);
+            std::shared_ptr<IPlugin> plugin = pluginsCode.find(FuncCodeUtils::GetPolicyCode(funcCode))->second;
+            benchmark::DoNotOptimize(plugin);
+        } else {
+            const std::shared_ptr<IPlugin> &plugin = PluginManager::GetInstance()->GetPluginByFuncCode(funcCode);
+            benchmark::DoNotOptimize(plugin);
+        }
+        code = (code + 1) % BENCHMARK_PLUGIN_NUM;
+    }
+}
+BENCHMARK(BM_GetPluginByFuncCode)->Arg(0)->Arg(1)->Unit(benchmark::kNanosecond);
+} // namespace BENCHMARK
+} // namespace EDM
+} // namespace OHOS
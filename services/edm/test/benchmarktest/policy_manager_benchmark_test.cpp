@@ -0,0 +1,524 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <malloc.h>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "json/json.h"
+#include "policy_file_store.h"
+#include "policy_manager.h"
+#include "policy_snapshot.h"
+#include "policy_transaction.h"
+
+namespace OHOS {
+namespace EDM {
+namespace BENCHMARK {
+const std::string BENCHMARK_ADMIN_PREFIX = "com.edm.benchmark.admin";
+const std::string BENCHMARK_POLICY_PREFIX = "benchmarkPolicy";
+constexpr int BENCHMARK_POLICY_NUM = 8;
+constexpr int BENCHMARK_MODE_LEGACY = 0;
+constexpr int BENCHMARK_MODE_JOURNAL = 1;
+constexpr double PERCENTILE_50 = 0.5;
+constexpr double PERCENTILE_99 = 0.99;
+constexpr int BENCHMARK_VALUE_SIZE = 16;
+constexpr int BENCHMARK_BURST_SIZE = 32;
+constexpr std::uint32_t BENCHMARK_QUIET_WINDOW_MS = 60000;
+constexpr int BENCHMARK_LIST_POLICY_SIZE = 1000;
+constexpr int BENCHMARK_CONCURRENT_ADMIN_NUM = 16;
+constexpr int BENCHMARK_MAX_READER_NUM = 8;
+constexpr int BENCHMARK_REMOVE_ADMIN_POLICY_NUM = 30;
+const std::string BENCHMARK_JSON_FILE = "/data/system/benchmark_device_policies.json";
+const std::string BENCHMARK_SNAPSHOT_FILE = "/data/system/benchmark_device_policies.snapshot";
+const std::string EDM_POLICY_SNAPSHOT_FILE = "/data/system/device_policies.snapshot";
+const std::string EDM_POLICY_JOURNAL_FILE = "/data/system/device_policies.journal";
+
+static void PreparePolicies(int adminNum)
+{
+    std::shared_ptr<PolicyManager> policyMgr = PolicyManager::GetInstance();
+    policyMgr->SetJournalEnabled(true);
+    for (int i = 0; i < adminNum; ++i) {
+        std::string adminName = BENCHMARK_ADMIN_PREFIX + std::to_string(i);
+        for (int j = 0; j < BENCHMARK_POLICY_NUM; ++j) {
+            std::string policyName = BENCHMARK_POLICY_PREFIX + std::to_string(j);
+            policyMgr->SetPolicy(adminName, policyName, "[\"" + adminName + "\"]", "[\"" + adminName + "\"]");
+        }
+    }
+}
+
+static double Percentile(std::vector<double> &latencies, double percentile)
+{
+    if (latencies.empty()) {
+        return 0;
+    }
+    std::size_t index = static_cast<std::size_t>(percentile * (latencies.size() - 1));
+    std::nth_element(latencies.begin(), latencies.begin() + index, latencies.end());
+    return latencies[index];
+}
+
+/*
+ * Measure SetPolicy with range(0) admins holding policies, range(1) chooses the
+ * whole snapshot rewrite or the journal append.
+ */
+static void BM_SetPolicy(benchmark::State &state)
+{
+    std::shared_ptr<PolicyManager> policyMgr = PolicyManager::GetInstance();
+    policyMgr->Init();
+    PreparePolicies(static_cast<int>(state.range(0)));
+    policyMgr->SetJournalEnabled(state.range(1) == BENCHMARK_MODE_JOURNAL);
+
+    std::string adminName = BENCHMARK_ADMIN_PREFIX + "0";
+    std::string policyName = BENCHMARK_POLICY_PREFIX + "0";
+    std::vector<double> latencies;
+    std::uint64_t beginBytes = policyMgr->GetPersistedBytes();
+    std::int64_t count = 0;
+    for (auto _ : state) {
+        std::string policyValue = "[\"" + std::to_string(count++) + "\"]";
+        auto begin = std::chrono::steady_clock::now();
+        policyMgr->SetPolicy(adminName, policyName, policyValue, policyValue);
+        auto end = std::chrono::steady_clock::now();
+        latencies.push_back(std::chrono::duration<double, std::micro>(end - begin).count());
+    }
+    std::uint64_t persistedBytes = policyMgr->GetPersistedBytes() - beginBytes;
+    state.counters["bytes/SetPolicy"] = count > 0 ? static_cast<double>(persistedBytes) / count : 0;
+    state.counters["p50_us"] = Percentile(latencies, PERCENTILE_50);
+    state.counters["p99_us"] = Percentile(latencies, PERCENTILE_99);
+    policyMgr->SetJournalEnabled(true);
+}
+
+BENCHMARK(BM_SetPolicy)
+    ->ArgNames({"admins", "journal"})
+    ->Args({10, BENCHMARK_MODE_LEGACY})
+    ->Args({10, BENCHMARK_MODE_JOURNAL})
+    ->Args({100, BENCHMARK_MODE_LEGACY})
+    ->Args({100, BENCHMARK_MODE_JOURNAL})
+    ->Args({1000, BENCHMARK_MODE_LEGACY})
+    ->Args({1000, BENCHMARK_MODE_JOURNAL})
+    ->Unit(benchmark::kMicrosecond);
+
+/*
+ * Measure SetPolicy rewriting the policy files without the journal, range(0) admins holding policies,
+ * range(1) chooses the snapshot file or the sharded layout.
+ */
+static void BM_SetPolicyShards(benchmark::State &state)
+{
+    std::shared_ptr<PolicyManager> policyMgr = PolicyManager::GetInstance();
+    policyMgr->Init();
+    PreparePolicies(static_cast<int>(state.range(0)));
+    auto policyStore = std::make_shared<PolicyFileStore>();
+    policyStore->SetShardedLayout(state.range(1) != 0);
+    policyMgr->SetPolicyStore(policyStore);
+    policyMgr->Init();
+    policyMgr->SetJournalEnabled(false);
+
+    std::string adminName = BENCHMARK_ADMIN_PREFIX + "0";
+    std::string policyName = BENCHMARK_POLICY_PREFIX + "0";
+    std::uint64_t beginBytes = policyMgr->GetPersistedBytes();
+    std::int64_t count = 0;
+    for (auto _ : state) {
+        std::string policyValue = "[\"" + std::to_string(count++) + "\"]";
+        policyMgr->SetPolicy(adminName, policyName, policyValue, policyValue);
+    }
+    std::uint64_t persistedBytes = policyMgr->GetPersistedBytes() - beginBytes;
+    state.counters["bytes/SetPolicy"] = count > 0 ? static_cast<double>(persistedBytes) / count : 0;
+    policyMgr->SetJournalEnabled(true);
+    /* move the policies back to the snapshot file for the other benchmarks */
+    policyMgr->SetPolicyStore(std::make_shared<PolicyFileStore>());
+    policyMgr->Init();
+}
+
+BENCHMARK(BM_SetPolicyShards)
+    ->ArgNames({"admins", "sharded"})
+    ->Args({10, 0})
+    ->Args({10, 1})
+    ->Args({100, 0})
+    ->Args({100, 1})
+    ->Args({1000, 0})
+    ->Args({1000, 1})
+    ->Unit(benchmark::kMicrosecond);
+
+/*
+ * Measure removing all policies of an admin holding BENCHMARK_REMOVE_ADMIN_POLICY_NUM policies while
+ * range(0) admins hold policies, range(1) chooses the snapshot rewrite or the journal append and
+ * range(2) chooses one SetPolicy per policy or one PolicyTransaction.
+ */
+static void BM_RemoveAdminPolicies(benchmark::State &state)
+{
+    std::shared_ptr<PolicyManager> policyMgr = PolicyManager::GetInstance();
+    policyMgr->Init();
+    PreparePolicies(static_cast<int>(state.range(0)));
+    policyMgr->SetJournalEnabled(state.range(1) == BENCHMARK_MODE_JOURNAL);
+    bool isTransaction = state.range(2) != 0;
+
+    std::string adminName = BENCHMARK_ADMIN_PREFIX + "removed";
+    std::uint64_t persistedBytes = 0;
+    std::int64_t count = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        PolicyTransaction addTransaction(policyMgr);
+        for (int i = 0; i < BENCHMARK_REMOVE_ADMIN_POLICY_NUM; ++i) {
+            std::string policyName = BENCHMARK_POLICY_PREFIX + std::to_string(i);
+            addTransaction.SetPolicy(adminName, policyName, "[\"" + adminName + "\"]", "[\"" + adminName + "\"]");
+        }
+        addTransaction.Commit();
+        std::uint64_t beginBytes = policyMgr->GetPersistedBytes();
+        state.ResumeTiming();
+
+        PolicyTransaction transaction(policyMgr);
+        for (int i = 0; i < BENCHMARK_REMOVE_ADMIN_POLICY_NUM; ++i) {
+            std::string policyName = BENCHMARK_POLICY_PREFIX + std::to_string(i);
+            if (isTransaction) {
+                transaction.SetPolicy(adminName, policyName, "", "");
+            } else {
+                policyMgr->SetPolicy(adminName, policyName, "", "");
+            }
+        }
+        transaction.Commit();
+
+        state.PauseTiming();
+        persistedBytes += policyMgr->GetPersistedBytes() - beginBytes;
+        count++;
+        state.ResumeTiming();
+    }
+    state.counters["bytes/RemoveAdmin"] = count > 0 ? static_cast<double>(persistedBytes) / count : 0;
+    policyMgr->SetJournalEnabled(true);
+}
+
+BENCHMARK(BM_RemoveAdminPolicies)
+    ->ArgNames({"admins", "journal", "transaction"})
+    ->Args({100, BENCHMARK_MODE_LEGACY, 0})
+    ->Args({100, BENCHMARK_MODE_LEGACY, 1})
+    ->Args({100, BENCHMARK_MODE_JOURNAL, 0})
+    ->Args({100, BENCHMARK_MODE_JOURNAL, 1})
+    ->Unit(benchmark::kMicrosecond);
+
+/*
+ * Measure a provisioning burst of SetPolicy followed by a Flush, range(0) chooses one journal
+ * write per SetPolicy or one coalesced write per burst.
+ */
+static void BM_SetPolicyBurst(benchmark::State &state)
+{
+    std::shared_ptr<PolicyManager> policyMgr = PolicyManager::GetInstance();
+    policyMgr->Init();
+    bool isCoalescing = state.range(0) != 0;
+    policyMgr->SetCoalescing(isCoalescing ? BENCHMARK_QUIET_WINDOW_MS : 0, BENCHMARK_QUIET_WINDOW_MS);
+    std::string adminName = BENCHMARK_ADMIN_PREFIX + "0";
+    std::int64_t count = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < BENCHMARK_BURST_SIZE; ++i) {
+            std::string policyName = BENCHMARK_POLICY_PREFIX + std::to_string(i);
+            std::string policyValue = "[\"" + std::to_string(count++) + "\"]";
+            policyMgr->SetPolicy(adminName, policyName, policyValue, policyValue);
+        }
+        policyMgr->Flush();
+    }
+    policyMgr->SetCoalescing(0, 0);
+}
+
+/*
+ * GetPolicy from threads() readers while one writer keeps calling SetPolicy on the same policies,
+ * the read throughput should grow with the readers because readers never wait for the writer.
+ */
+static void BM_ConcurrentGetPolicy(benchmark::State &state)
+{
+    static std::thread writer;
+    static std::atomic<bool> writerStopping {false};
+    std::shared_ptr<PolicyManager> policyMgr = PolicyManager::GetInstance();
+    if (state.thread_index() == 0) {
+        PreparePolicies(BENCHMARK_CONCURRENT_ADMIN_NUM);
+        writerStopping = false;
+        writer = std::thread([policyMgr]() {
+            for (int i = 0; !writerStopping; ++i) {
+                std::string adminName = BENCHMARK_ADMIN_PREFIX + std::to_string(i % BENCHMARK_CONCURRENT_ADMIN_NUM);
+                std::string value = "[\"" + std::to_string(i) + "\"]";
+                policyMgr->SetPolicy(adminName, BENCHMARK_POLICY_PREFIX + "0", value, value);
+            }
+        });
+    }
+    std::string adminName = BENCHMARK_ADMIN_PREFIX + std::to_string(state.thread_index());
+    std::string policyValue;
+    for (auto _ : state) {
+        policyMgr->GetPolicy(adminName, BENCHMARK_POLICY_PREFIX + "0", policyValue);
+        policyMgr->GetPolicy("", BENCHMARK_POLICY_PREFIX + "1", policyValue);
+        benchmark::DoNotOptimize(policyValue);
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        writerStopping = true;
+        writer.join();
+        policyMgr->Flush();
+    }
+}
+
+BENCHMARK(BM_ConcurrentGetPolicy)->ThreadRange(1, BENCHMARK_MAX_READER_NUM)->UseRealTime();
+
+BENCHMARK(BM_SetPolicyBurst)->ArgNames({"coalescing"})->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+static void WriteLoadFiles(int adminNum)
+{
+    PolicyTable table;
+    Json::Value policyRoot;
+    Json::Value adminArray(Json::arrayValue);
+    Json::Value combinedObject(Json::objectValue);
+    for (int i = 0; i < adminNum; ++i) {
+        std::string adminName = BENCHMARK_ADMIN_PREFIX + std::to_string(i);
+        Json::Value adminObject;
+        Json::Value policyItemsObject(Json::objectValue);
+        auto itemsMap = std::make_shared<PolicyValueMap>();
+        for (int j = 0; j < BENCHMARK_POLICY_NUM; ++j) {
+            std::string policyName = BENCHMARK_POLICY_PREFIX + std::to_string(j);
+            Json::Value policyArray(Json::arrayValue);
+            for (int k = 0; k < BENCHMARK_VALUE_SIZE; ++k) {
+                policyArray.append(adminName + "." + std::to_string(k));
+            }
+            policyItemsObject[policyName] = policyArray;
+            combinedObject[policyName] = policyArray;
+            (*itemsMap)[policyName] = MakePolicyValue(Json::writeString(Json::StreamWriterBuilder(), policyArray));
+            table.combinedPolicies[policyName] = (*itemsMap)[policyName];
+        }
+        table.adminPolicies[adminName] = std::move(itemsMap);
+        adminObject["AdminName"] = adminName;
+        adminObject["PolicyItems"] = policyItemsObject;
+        adminArray.append(adminObject);
+    }
+    policyRoot["AdminPolicies"] = adminArray;
+    policyRoot["CombinedPolicies"] = combinedObject;
+    std::ofstream ofs(BENCHMARK_JSON_FILE, std::ofstream::binary);
+    ofs << policyRoot;
+    ofs.close();
+    std::uint64_t writtenBytes = 0;
+    PolicySnapshot::Write(BENCHMARK_SNAPSHOT_FILE, 0, table, writtenBytes);
+}
+
+static long GetStatusKb(const std::string &key)
+{
+    std::ifstream ifs("/proc/self/status");
+    std::string line;
+    while (std::getline(ifs, line)) {
+        if (line.compare(0, key.size(), key) == 0) {
+            return std::stol(line.substr(key.size()));
+        }
+    }
+    return 0;
+}
+
+/*
+ * The loader used before the snapshot: parse the whole json file and serialize every policy
+ * value back to an indented string.
+ */
+static void LoadJson(std::unordered_map<std::string, PolicyItemsMap> &adminPolicies, PolicyItemsMap &combined)
+{
+    std::ifstream ifs(BENCHMARK_JSON_FILE);
+    Json::Value policyRoot;
+    Json::CharReaderBuilder reader;
+    Json::String errs;
+    Json::parseFromStream(reader, ifs, &policyRoot, &errs);
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "    ";
+    for (const auto &admin : policyRoot["AdminPolicies"]) {
+        PolicyItemsMap &items = adminPolicies[admin["AdminName"].asString()];
+        const Json::Value &policyItems = admin["PolicyItems"];
+        for (const auto &name : policyItems.getMemberNames()) {
+            items[name] = Json::writeString(writer, policyItems[name]);
+        }
+    }
+    const Json::Value &combinedObject = policyRoot["CombinedPolicies"];
+    for (const auto &name : combinedObject.getMemberNames()) {
+        combined[name] = Json::writeString(writer, combinedObject[name]);
+    }
+}
+
+static void LoadSnapshot(std::unordered_map<std::string, PolicyValueMap> &adminPolicies, PolicyValueMap &combined,
+    PolicySnapshot &snapshot)
+{
+    snapshot.Open(BENCHMARK_SNAPSHOT_FILE);
+    for (std::uint32_t i = 0; i < snapshot.GetAdminCount(); ++i) {
+        std::string adminName;
+        snapshot.GetAdminName(i, adminName);
+        snapshot.GetAdminPolicies(i, adminPolicies[adminName]);
+    }
+    snapshot.GetCombinedPolicies(combined);
+}
+
+static void Load(bool isSnapshot)
+{
+    PolicySnapshot snapshot;
+    if (isSnapshot) {
+        std::unordered_map<std::string, PolicyValueMap> adminPolicies;
+        PolicyValueMap combined;
+        LoadSnapshot(adminPolicies, combined, snapshot);
+        benchmark::DoNotOptimize(adminPolicies);
+    } else {
+        std::unordered_map<std::string, PolicyItemsMap> adminPolicies;
+        PolicyItemsMap combined;
+        LoadJson(adminPolicies, combined);
+        benchmark::DoNotOptimize(adminPolicies);
+    }
+}
+
+/*
+ * The resident memory grown by one load, measured in a child process so that the heap of former
+ * loads is not reused. The peak of all memory is measured when key is VmHWM, otherwise the growth
+ * of the status field key.
+ */
+static long MeasureLoadRssKb(const std::function<void()> &load, const std::string &key = "VmHWM:")
+{
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return 0;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+#ifdef __GLIBC__
+        /* give the heap freed by the former loads back, so that it is not reused by this load */
+        malloc_trim(0);
+#endif
+        long beginRss = GetStatusKb(key == "VmHWM:" ? "VmRSS:" : key);
+        load();
+        long rssKb = GetStatusKb(key) - beginRss;
+        write(fds[1], &rssKb, sizeof(rssKb));
+        _exit(0);
+    }
+    close(fds[1]);
+    long rssKb = 0;
+    if (pid < 0 || read(fds[0], &rssKb, sizeof(rssKb)) != sizeof(rssKb)) {
+        rssKb = 0;
+    }
+    close(fds[0]);
+    if (pid > 0) {
+        waitpid(pid, nullptr, 0);
+    }
+    return rssKb;
+}
+
+/*
+ * Measure the startup load of range(0) admins, range(1) chooses the legacy json loader or
+ * the mapped snapshot.
+ */
+static void BM_LoadPolicy(benchmark::State &state)
+{
+    WriteLoadFiles(static_cast<int>(state.range(0)));
+    bool isSnapshot = state.range(1) == BENCHMARK_MODE_JOURNAL;
+    for (auto _ : state) {
+        Load(isSnapshot);
+    }
+    state.counters["peak_rss_kb"] = MeasureLoadRssKb([isSnapshot]() { Load(isSnapshot); });
+    unlink(BENCHMARK_JSON_FILE.c_str());
+    unlink(BENCHMARK_SNAPSHOT_FILE.c_str());
+}
+
+BENCHMARK(BM_LoadPolicy)
+    ->ArgNames({"admins", "snapshot"})
+    ->Args({10, 0})
+    ->Args({10, 1})
+    ->Args({100, 0})
+    ->Args({100, 1})
+    ->Args({1000, 0})
+    ->Args({1000, 1})
+    ->Unit(benchmark::kMicrosecond);
+
+/*
+ * Measure PolicyManager::Init of range(0) admins from the snapshot file, range(1) chooses to decode
+ * every admin or only the combined policies.
+ */
+static void BM_InitPolicy(benchmark::State &state)
+{
+    WriteLoadFiles(static_cast<int>(state.range(0)));
+    std::rename(BENCHMARK_SNAPSHOT_FILE.c_str(), EDM_POLICY_SNAPSHOT_FILE.c_str());
+    unlink(EDM_POLICY_JOURNAL_FILE.c_str());
+    std::shared_ptr<PolicyManager> policyMgr = PolicyManager::GetInstance();
+    auto policyStore = std::make_shared<PolicyFileStore>();
+    policyStore->SetLazyLoad(state.range(1) == BENCHMARK_MODE_JOURNAL);
+    policyMgr->SetPolicyStore(policyStore);
+    for (auto _ : state) {
+        policyMgr->Init();
+    }
+    /* the mapped snapshot is page cache, only the heap holding the decoded policies is counted */
+    state.counters["anon_rss_kb"] = MeasureLoadRssKb([policyMgr]() { policyMgr->Init(); }, "RssAnon:");
+    policyMgr->SetPolicyStore(std::make_shared<PolicyFileStore>());
+    unlink(BENCHMARK_JSON_FILE.c_str());
+    unlink(EDM_POLICY_SNAPSHOT_FILE.c_str());
+    policyMgr->Init();
+}
+
+BENCHMARK(BM_InitPolicy)
+    ->ArgNames({"admins", "lazy"})
+    ->Args({100, 0})
+    ->Args({100, 1})
+    ->Args({1000, 0})
+    ->Args({1000, 1})
+    ->Unit(benchmark::kMicrosecond);
+
+/*
+ * The resident memory per admin holding a list policy of BENCHMARK_LIST_POLICY_SIZE package
+ * names, measured in a child process so that the heap of the parent is not reused.
+ */
+static void BM_PolicyMemory(benchmark::State &state)
+{
+    int adminNum = static_cast<int>(state.range(0));
+    std::string listPolicy = "[";
+    for (int i = 0; i < BENCHMARK_LIST_POLICY_SIZE; ++i) {
+        listPolicy += (i == 0 ? "\"" : ",\"") + BENCHMARK_ADMIN_PREFIX + ".package" + std::to_string(i) + "\"";
+    }
+    listPolicy += "]";
+    long rssKb = 0;
+    for (auto _ : state) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            break;
+        }
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            std::shared_ptr<PolicyManager> policyMgr = PolicyManager::GetInstance();
+            policyMgr->SetJournalEnabled(false);
+            long beginRss = GetStatusKb("VmRSS:");
+            for (int i = 0; i < adminNum; ++i) {
+                std::string adminName = BENCHMARK_ADMIN_PREFIX + std::to_string(i);
+                policyMgr->SetPolicy(adminName, BENCHMARK_POLICY_PREFIX, listPolicy, "");
+            }
+            long grownKb = GetStatusKb("VmRSS:") - beginRss;
+            write(fds[1], &grownKb, sizeof(grownKb));
+            _exit(0);
+        }
+        close(fds[1]);
+        if (pid < 0 || read(fds[0], &rssKb, sizeof(rssKb)) != sizeof(rssKb)) {
+            rssKb = 0;
+        }
+        close(fds[0]);
+        if (pid > 0) {
+            waitpid(pid, nullptr, 0);
+        }
+    }
+    state.counters["rss_kb_per_admin"] = static_cast<double>(rssKb) / adminNum;
+}
+
+BENCHMARK(BM_PolicyMemory)->ArgNames({"admins"})->Arg(100)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+} // namespace BENCHMARK
+} // namespace EDM
+} // namespace OHOS
+
+BENCHMARK_MAIN();
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "array_string_serializer.h"
+#include "edm_errors.h"
+#include "message_parcel.h"
+#include "policy_reply_cache.h"
+
+namespace OHOS {
+namespace EDM {
+namespace BENCHMARK {
+const std::string BENCHMARK_REPLY_ITEM_PREFIX = "com.edm.benchmark.bundle";
+constexpr int BENCHMARK_REPLY_MODE_ENCODE = 0;
+constexpr int BENCHMARK_REPLY_ITEM_NUM = 5000;
+constexpr std::uint32_t BENCHMARK_REPLY_POLICY_CODE = 1;
+
+/*
+ * Encode the policy the way GetDevicePolicy did before the cache: deserialize the stored policy
+ * and write every item to the parcel as UTF-16.
+ */
+static void EncodeArrayPolicy(const std::string &policyValue, MessageParcel &reply)
+{
+    std::vector<std::string> policyData;
+    ArrayStringSerializer::GetInstance()->Deserialize(policyValue, policyData);
+    ArrayStringSerializer::GetInstance()->WritePolicy(reply, policyData);
+}
+
+/*
+ * Measure GetDevicePolicy of an array policy with 5000 items, range(0) chooses encoding every
+ * reply or copying the cached reply.
+ */
+static void BM_GetArrayPolicyReply(benchmark::State &state)
+{
+    bool isEncode = (state.range(0) == BENCHMARK_REPLY_MODE_ENCODE);
+    std::vector<std::string> items;
+    for (int i = 0; i < BENCHMARK_REPLY_ITEM_NUM; ++i) {
+        items.push_back(BENCHMARK_REPLY_ITEM_PREFIX + std::to_string(i));
+    }
+    std::string policyValue;
+    ArrayStringSerializer::GetInstance()->Serialize(items, policyValue);
+    PolicyReplyCache cache;
+    std::size_t replySize = 0;
+    for (auto _ : state) {
+        MessageParcel reply;
+        reply.WriteInt32(ERR_OK);
+        if (isEncode) {
+            EncodeArrayPolicy(policyValue, reply);
+        } else {
+            PolicyReply cachedReply;
+            std::uint64_t policyGeneration = 0;
+            std::uint64_t generation = cache.Get(BENCHMARK_REPLY_POLICY_CODE, cachedReply, policyGeneration);
+            if (cachedReply == nullptr) {
+                MessageParcel encodedReply;
+                EncodeArrayPolicy(policyValue, encodedReply);
+                const std::uint8_t *data = reinterpret_cast<const std::uint8_t *>(encodedReply.GetData());
+                cachedReply = std::make_shared<const std::vector<std::uint8_t>>(data,
+                    data + encodedReply.GetDataSize());
+                cache.Put(BENCHMARK_REPLY_POLICY_CODE, generation, policyGeneration, cachedReply);
+            }
+            reply.WriteBuffer(cachedReply->data(), cachedReply->size());
+        }
+        replySize = reply.GetDataSize();
+        benchmark::DoNotOptimize(replySize);
+    }
+    state.counters["reply_bytes"] = static_cast<double>(replySize);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * replySize));
+}
+BENCHMARK(BM_GetArrayPolicyReply)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+} // namespace BENCHMARK
+} // namespace EDM
+} // namespace OHOS
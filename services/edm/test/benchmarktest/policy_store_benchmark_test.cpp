@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include "policy_file_store.h"
+#include "policy_manager.h"
+#include "policy_memory_store.h"
+#include "policy_shard_store.h"
+
+namespace OHOS {
+namespace EDM {
+namespace BENCHMARK {
+const std::string BENCHMARK_STORE_DIR = "/data/system/benchmark_policy_store";
+const std::string BENCHMARK_STORE_ADMIN_PREFIX = "com.edm.benchmark.store.admin";
+const std::string BENCHMARK_STORE_POLICY_PREFIX = "benchmarkStorePolicy";
+constexpr int BENCHMARK_STORE_POLICY_NUM = 8;
+constexpr int BENCHMARK_STORE_PERCENT = 100;
+constexpr mode_t BENCHMARK_STORE_DIR_MODE = 0700;
+
+/*
+ * A storage backend driven by the benchmarks, every backend runs the same workloads.
+ */
+struct PolicyStoreBackend {
+    std::string name;
+    std::function<std::shared_ptr<IPolicyStore>()> create;
+};
+
+static const std::vector<PolicyStoreBackend> &GetBackends()
+{
+    static const std::vector<PolicyStoreBackend> backends = {
+        {"file", []() { return std::make_shared<PolicyFileStore>(BENCHMARK_STORE_DIR); }},
+        {"sharded", []() {
+            auto store = std::make_shared<PolicyFileStore>(BENCHMARK_STORE_DIR);
+            store->SetShardedLayout(true);
+            return store;
+        }},
+        {"memory", []() { return std::make_shared<PolicyMemoryStore>(); }},
+    };
+    return backends;
+}
+
+static void RemoveStoreFiles()
+{
+    PolicyShardStore(BENCHMARK_STORE_DIR + "/device_policies").Remove();
+    unlink((BENCHMARK_STORE_DIR + "/device_policies.snapshot").c_str());
+    unlink((BENCHMARK_STORE_DIR + "/device_policies.journal").c_str());
+    unlink((BENCHMARK_STORE_DIR + "/device_policies.journal.old").c_str());
+}
+
+/*
+ * Run range(2) percent GetPolicy and the rest SetPolicy over range(1) admins holding
+ * BENCHMARK_STORE_POLICY_NUM policies each, with the backend at index range(0).
+ */
+static void BM_PolicyStoreWorkload(benchmark::State &state)
+{
+    const PolicyStoreBackend &backend = GetBackends()[state.range(0)];
+    int adminNum = static_cast<int>(state.range(1));
+    int readPercent = static_cast<int>(state.range(2));
+    mkdir(BENCHMARK_STORE_DIR.c_str(), BENCHMARK_STORE_DIR_MODE);
+    RemoveStoreFiles();
+    std::shared_ptr<PolicyManager> policyMgr = PolicyManager::GetInstance();
+    policyMgr->SetPolicyStore(backend.create());
+    policyMgr->Init();
+    for (int i = 0; i < adminNum; ++i) {
+        std::string adminName = BENCHMARK_STORE_ADMIN_PREFIX + std::to_string(i);
+        for (int j = 0; j < BENCHMARK_STORE_POLICY_NUM; ++j) {
+            std::string policyName = BENCHMARK_STORE_POLICY_PREFIX + std::to_string(j);
+            policyMgr->SetPolicy(adminName, policyName, "[\"" + adminName + "\"]", "[\"" + adminName + "\"]");
+        }
+    }
+    policyMgr->Flush();
+
+    std::uint64_t beginBytes = policyMgr->GetPersistedBytes();
+    std::int64_t count = 0;
+    for (auto _ : state) {
+        std::string adminName = BENCHMARK_STORE_ADMIN_PREFIX + std::to_string(count % adminNum);
+        std::string policyName = BENCHMARK_STORE_POLICY_PREFIX +
+            std::to_string((count / adminNum) % BENCHMARK_STORE_POLICY_NUM);
+        if (count % BENCHMARK_STORE_PERCENT < readPercent) {
+            std::string policyValue;
+            policyMgr->GetPolicy(adminName, policyName, policyValue);
+            benchmark::DoNotOptimize(policyValue);
+        } else {
+            std::string policyValue = "[\"" + std::to_string(count) + "\"]";
+            policyMgr->SetPolicy(adminName, policyName, policyValue, policyValue);
+        }
+        count++;
+    }
+    policyMgr->Flush();
+    std::uint64_t persistedBytes = policyMgr->GetPersistedBytes() - beginBytes;
+    state.counters["bytes/op"] = count > 0 ? static_cast<double>(persistedBytes) / count : 0;
+    state.SetLabel(backend.name);
+
+    policyMgr->SetPolicyStore(std::make_shared<PolicyFileStore>());
+    policyMgr->Init();
+    RemoveStoreFiles();
+    rmdir(BENCHMARK_STORE_DIR.c_str());
+}
+
+static void PolicyStoreWorkloadArgs(benchmark::internal::Benchmark *benchmark)
+{
+    for (std::size_t backend = 0; backend < GetBackends().size(); ++backend) {
+        for (int adminNum : {10, 100, 1000}) {
+            for (int readPercent : {0, 90}) {
+                benchmark->Args({static_cast<std::int64_t>(backend), adminNum, readPercent});
+            }
+        }
+    }
+}
+
+BENCHMARK(BM_PolicyStoreWorkload)
+    ->ArgNames({"backend", "admins", "read%"})
+    ->Apply(PolicyStoreWorkloadArgs)
+    ->Unit(benchmark::kMicrosecond);
+} // namespace BENCHMARK
+} // namespace EDM
+} // namespace OHOS
@@ -26,10 +26,10 @@ namespace EDM {
 namespace TEST {
 class TestPlugin : public IPlugin {
 public:
-    TestPlugin()
+    explicit TestPlugin(std::uint32_t policyCode = 0, const std::string &policyName = "TestPlugin")
     {
-        policyCode_ = 0;
-        policyName_ = "TestPlugin";
+        policyCode_ = policyCode;
+        policyName_ = policyName;
         permission_ = "ohos.permission.EDM_TEST_PERMISSION";
         EDMLOGD("TestPlugin constructor");
     }
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "admin_change_callback_stub.h"
+#include "admin_change_notifier.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace EDM {
+namespace TEST {
+constexpr int32_t TEST_USER_ID = 100;
+constexpr int32_t TEST_OTHER_USER_ID = 101;
+constexpr uint32_t TEST_QUIET_WINDOW_MS = 20;
+constexpr uint32_t TEST_MAX_DELAY_MS = 200;
+constexpr std::chrono::milliseconds TEST_WAIT_TIME(1000);
+constexpr std::chrono::milliseconds TEST_NO_EVENT_WAIT_TIME(100);
+
+class FakeAdminChangeCallback : public AdminChangeCallbackStub {
+public:
+    void OnAdminChanged(const std::vector<AdminChangeEvent> &events) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        batches_.push_back(events);
+        cond_.notify_all();
+    }
+
+    bool WaitBatches(size_t count, std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cond_.wait_for(lock, timeout, [this, count] { return batches_.size() >= count; });
+    }
+
+    std::vector<std::vector<AdminChangeEvent>> GetBatches()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return batches_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::vector<std::vector<AdminChangeEvent>> batches_;
+};
+
+class AdminChangeNotifierTest : public testing::Test {
+protected:
+    static AdminChangeEvent MakeEvent(AdminChangeType changeType, const std::string &bundleName,
+        AdminType adminType, int32_t userId)
+    {
+        AdminChangeEvent event;
+        event.changeType = changeType;
+        event.bundleName = bundleName;
+        event.abilityName = bundleName + ".MainAbility";
+        event.adminType = adminType;
+        event.userId = userId;
+        return event;
+    }
+};
+
+/**
+ * @tc.name: TestSubscribe
+ * @tc.desc: Test AdminChangeNotifier subscribe and unsubscribe.
+ * @tc.type: FUNC
+ */
+HWTEST_F(AdminChangeNotifierTest, TestSubscribe, TestSize.Level1)
+{
+    AdminChangeNotifier notifier;
+    sptr<FakeAdminChangeCallback> callback = new FakeAdminChangeCallback();
+    ASSERT_TRUE(notifier.Subscribe(nullptr, TEST_USER_ID) == ERR_EDM_PARAM_ERROR);
+    ASSERT_TRUE(notifier.Subscribe(callback->AsObject(), TEST_USER_ID) == ERR_OK);
+    ASSERT_TRUE(notifier.Subscribe(callback->AsObject(), TEST_OTHER_USER_ID) == ERR_OK);
+    ASSERT_TRUE(notifier.GetSubscriberCount() == 1);
+    ASSERT_TRUE(notifier.Unsubscribe(callback->AsObject()) == ERR_OK);
+    ASSERT_TRUE(notifier.GetSubscriberCount() == 0);
+    ASSERT_TRUE(notifier.Unsubscribe(callback->AsObject()) == ERR_EDM_PARAM_ERROR);
+
+    notifier.Notify(MakeEvent(AdminChangeType::ADMIN_ACTIVATED, "com.edm.test.demo", AdminType::NORMAL,
+        TEST_USER_ID));
+    ASSERT_FALSE(callback->WaitBatches(1, TEST_NO_EVENT_WAIT_TIME));
+}
+
+/**
+ * @tc.name: TestCoalesceEvents
+ * @tc.desc: Test AdminChangeNotifier sends a burst of changes in one batch and merges the changes of an admin.
+ * @tc.type: FUNC
+ */
+HWTEST_F(AdminChangeNotifierTest, TestCoalesceEvents, TestSize.Level1)
+{
+    AdminChangeNotifier notifier;
+    notifier.SetCoalescing(TEST_QUIET_WINDOW_MS, TEST_MAX_DELAY_MS);
+    sptr<FakeAdminChangeCallback> callback = new FakeAdminChangeCallback();
+    ASSERT_TRUE(notifier.Subscribe(callback->AsObject(), TEST_USER_ID) == ERR_OK);
+
+    notifier.Notify(MakeEvent(AdminChangeType::ADMIN_ACTIVATED, "com.edm.test.demo", AdminType::NORMAL,
+        TEST_USER_ID));
+    notifier.Notify(MakeEvent(AdminChangeType::ADMIN_ENT_INFO_CHANGED, "com.edm.test.demo", AdminType::NORMAL,
+        TEST_USER_ID));
+    notifier.Notify(MakeEvent(AdminChangeType::ADMIN_ACTIVATED, "com.edm.test.other", AdminType::NORMAL,
+        TEST_USER_ID));
+    notifier.Notify(MakeEvent(AdminChangeType::ADMIN_DEACTIVATED, "com.edm.test.other", AdminType::NORMAL,
+        TEST_USER_ID));
+    notifier.Notify(MakeEvent(AdminChangeType::ADMIN_DEACTIVATED, "com.edm.test.old", AdminType::NORMAL,
+        TEST_USER_ID));
+    ASSERT_TRUE(callback->WaitBatches(1, TEST_WAIT_TIME));
+    ASSERT_FALSE(callback->WaitBatches(2, TEST_NO_EVENT_WAIT_TIME));
+
+    /* an admin activated and deactivated in the same batch is not reported */
+    std::vector<AdminChangeEvent> events = callback->GetBatches()[0];
+    ASSERT_TRUE(events.size() == 2);
+    ASSERT_TRUE(events[0].bundleName == "com.edm.test.demo");
+    ASSERT_TRUE(events[0].changeType == AdminChangeType::ADMIN_ACTIVATED);
+    ASSERT_TRUE(events[1].bundleName == "com.edm.test.old");
+    ASSERT_TRUE(events[1].changeType == AdminChangeType::ADMIN_DEACTIVATED);
+}
+
+/**
+ * @tc.name: TestFilterByUser
+ * @tc.desc: Test AdminChangeNotifier sends the changes of the subscriber's user and of the super admins.
+ * @tc.type: FUNC
+ */
+HWTEST_F(AdminChangeNotifierTest, TestFilterByUser, TestSize.Level1)
+{
+    AdminChangeNotifier notifier;
+    notifier.SetCoalescing(TEST_QUIET_WINDOW_MS, TEST_MAX_DELAY_MS);
+    sptr<FakeAdminChangeCallback> callback = new FakeAdminChangeCallback();
+    sptr<FakeAdminChangeCallback> otherCallback = new FakeAdminChangeCallback();
+    ASSERT_TRUE(notifier.Subscribe(callback->AsObject(), TEST_USER_ID) == ERR_OK);
+    ASSERT_TRUE(notifier.Subscribe(otherCallback->AsObject(), TEST_OTHER_USER_ID) == ERR_OK);
+
+    notifier.Notify(MakeEvent(AdminChangeType::ADMIN_ACTIVATED, "com.edm.test.demo", AdminType::NORMAL,
+        TEST_OTHER_USER_ID));
+    notifier.Notify(MakeEvent(AdminChangeType::ADMIN_ACTIVATED, "com.edm.test.ent", AdminType::ENT,
+        TEST_USER_ID));
+    ASSERT_TRUE(callback->WaitBatches(1, TEST_WAIT_TIME));
+    ASSERT_TRUE(otherCallback->WaitBatches(1, TEST_WAIT_TIME));
+
+    std::vector<AdminChangeEvent> events = callback->GetBatches()[0];
+    ASSERT_TRUE(events.size() == 1);
+    ASSERT_TRUE(events[0].bundleName == "com.edm.test.ent");
+    ASSERT_TRUE(otherCallback->GetBatches()[0].size() == 2);
+}
+} // namespace TEST
+} // namespace EDM
+} // namespace OHOS
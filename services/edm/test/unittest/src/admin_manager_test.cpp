@@ -14,6 +14,8 @@
  */
 
 #include "admin_manager_test.h"
+#include <fstream>
+#include <unistd.h>
 #include <vector>
 #include "admin_manager.h"
 #include "cmd_utils.h"
@@ -24,7 +26,12 @@ namespace OHOS {
 namespace EDM {
 namespace TEST {
 constexpr int HUGE_ADMIN_SIZE = 100;
-const std::string TEAR_DOWN_CMD = "rm /data/system/admin_policies.json";
+constexpr int32_t TEST_USER_ID = 101;
+const std::string TEAR_DOWN_CMD = "rm /data/system/admin_policies.json /data/system/admin_policies.records "
+    "/data/system/admin_policies_101.records";
+const std::string TEST_ADMIN_JSON_FILE = "/data/system/admin_policies.json";
+const std::string TEST_ADMIN_RECORD_FILE = "/data/system/admin_policies.records";
+const std::string TEST_USER_ADMIN_RECORD_FILE = "/data/system/admin_policies_101.records";
 
 void AdminManagerTest::SetUp()
 {
@@ -385,6 +392,335 @@ HWTEST_F(AdminManagerTest, TestIsSuperAdminExist, TestSize.Level1)
     adminMgr_->SetAdminValue(abilityInfo, entInfo, AdminType::NORMAL, permissions);
     ASSERT_TRUE(!adminMgr_->IsSuperAdminExist());
 }
+
+/**
+ * @tc.name: TestSetEntInfoKeepsPublishedAdmin
+ * @tc.desc: Test AdminManager::SetEntInfo function does not change the admin held by a reader.
+ * @tc.type: FUNC
+ */
+HWTEST_F(AdminManagerTest, TestSetEntInfoKeepsPublishedAdmin, TestSize.Level1)
+{
+    AppExecFwk::AbilityInfo abilityInfo;
+    abilityInfo.bundleName = "com.edm.test.demo";
+    abilityInfo.className = "testDemo";
+    EntInfo entInfo;
+    entInfo.enterpriseName = "company";
+    entInfo.description = "technology company in wuhan";
+    std::vector<std::string> permissions = { "ohos.permission.EDM_TEST_PERMISSION" };
+    ErrCode res = adminMgr_->SetAdminValue(abilityInfo, entInfo, AdminType::NORMAL, permissions);
+    ASSERT_TRUE(res == ERR_OK);
+    std::shared_ptr<Admin> oldAdmin = adminMgr_->GetAdminByPkgName(abilityInfo.bundleName);
+    ASSERT_TRUE(oldAdmin != nullptr);
+
+    EntInfo newEntInfo;
+    newEntInfo.enterpriseName = "new company";
+    res = adminMgr_->SetEntInfo(abilityInfo.bundleName, newEntInfo);
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(oldAdmin->adminInfo_.entInfo_.enterpriseName == "company");
+    EntInfo currentEntInfo;
+    res = adminMgr_->GetEntInfo(abilityInfo.bundleName, currentEntInfo);
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(currentEntInfo.enterpriseName == "new company");
+}
+/**
+ * @tc.name: TestAdminIndex
+ * @tc.desc: Test AdminManager keeps the lookup, the super admin flag and the activation order consistent.
+ * @tc.type: FUNC
+ */
+HWTEST_F(AdminManagerTest, TestAdminIndex, TestSize.Level1)
+{
+    AppExecFwk::AbilityInfo abilityInfo;
+    abilityInfo.name = "testDemo";
+    EntInfo entInfo;
+    entInfo.enterpriseName = "company";
+    std::vector<std::string> permissions = { "ohos.permission.EDM_TEST_ENT_PERMISSION" };
+    abilityInfo.bundleName = "com.edm.test.demo";
+    ASSERT_TRUE(adminMgr_->SetAdminValue(abilityInfo, entInfo, AdminType::ENT, permissions) == ERR_OK);
+    permissions = { "ohos.permission.EDM_TEST_PERMISSION" };
+    abilityInfo.bundleName = "com.edm.test.demo1";
+    ASSERT_TRUE(adminMgr_->SetAdminValue(abilityInfo, entInfo, AdminType::NORMAL, permissions) == ERR_OK);
+    abilityInfo.bundleName = "com.edm.test.demo2";
+    ASSERT_TRUE(adminMgr_->SetAdminValue(abilityInfo, entInfo, AdminType::NORMAL, permissions) == ERR_OK);
+    ASSERT_TRUE(adminMgr_->IsSuperAdminExist());
+
+    /* an admin activated again keeps its position */
+    abilityInfo.bundleName = "com.edm.test.demo1";
+    ASSERT_TRUE(adminMgr_->SetAdminValue(abilityInfo, entInfo, AdminType::NORMAL, permissions) == ERR_OK);
+    ASSERT_TRUE(adminMgr_->DeleteAdmin("com.edm.test.demo") == ERR_OK);
+    ASSERT_TRUE(!adminMgr_->IsSuperAdminExist());
+    ASSERT_TRUE(adminMgr_->GetAdminByPkgName("com.edm.test.demo") == nullptr);
+    std::shared_ptr<Admin> admin = adminMgr_->GetAdminByPkgName("com.edm.test.demo2");
+    ASSERT_TRUE(admin != nullptr);
+    ASSERT_TRUE(admin->adminInfo_.packageName_ == "com.edm.test.demo2");
+
+    std::vector<std::string> activeAdmins;
+    adminMgr_->GetActiveAdmin(AdminType::NORMAL, activeAdmins);
+    ASSERT_TRUE(activeAdmins.size() == 2);
+    ASSERT_TRUE(activeAdmins[0] == "com.edm.test.demo1/testDemo");
+    ASSERT_TRUE(activeAdmins[1] == "com.edm.test.demo2/testDemo");
+
+    /* the order survives a reload from the file */
+    adminMgr_->Init();
+    adminMgr_->GetActiveAdmin(AdminType::NORMAL, activeAdmins);
+    ASSERT_TRUE(activeAdmins.size() == 2);
+    ASSERT_TRUE(activeAdmins[0] == "com.edm.test.demo1/testDemo");
+    admin = adminMgr_->GetAdminByPkgName("com.edm.test.demo2");
+    ASSERT_TRUE(admin != nullptr);
+    /* the permission bits are restored from the names saved in the file */
+    ASSERT_TRUE(admin->CheckPermission("ohos.permission.EDM_TEST_PERMISSION"));
+    ASSERT_TRUE(!admin->CheckPermission("ohos.permission.EDM_TEST_ENT_PERMISSION"));
+    ASSERT_TRUE(admin->CheckPermissionId(
+        PermissionManager::GetInstance()->GetPermissionId("ohos.permission.EDM_TEST_PERMISSION")));
+    ASSERT_TRUE(!admin->CheckPermissionId(EDM_INVALID_PERMISSION_ID));
+}
+
+/**
+ * @tc.name: TestAdminRecordFile
+ * @tc.desc: Test AdminManager appends one record per change and loads the admins after a torn append.
+ * @tc.type: FUNC
+ */
+HWTEST_F(AdminManagerTest, TestAdminRecordFile, TestSize.Level1)
+{
+    AppExecFwk::AbilityInfo abilityInfo;
+    abilityInfo.name = "testDemo";
+    EntInfo entInfo;
+    entInfo.enterpriseName = "company";
+    std::vector<std::string> permissions = { "ohos.permission.EDM_TEST_PERMISSION" };
+    for (int i = 0; i < HUGE_ADMIN_SIZE; ++i) {
+        abilityInfo.bundleName = "com.edm.test.demo" + std::to_string(i);
+        ASSERT_TRUE(adminMgr_->SetAdminValue(abilityInfo, entInfo, AdminType::NORMAL, permissions) == ERR_OK);
+    }
+    /* changing one admin only writes the record of the admin */
+    std::uint64_t persistedBytes = adminMgr_->GetPersistedBytes();
+    entInfo.enterpriseName = "new company";
+    ASSERT_TRUE(adminMgr_->SetEntInfo("com.edm.test.demo0", entInfo) == ERR_OK);
+    std::uint64_t recordBytes = adminMgr_->GetPersistedBytes() - persistedBytes;
+    ASSERT_TRUE(recordBytes > 0);
+    ASSERT_TRUE(recordBytes * HUGE_ADMIN_SIZE / 2 < static_cast<std::uint64_t>(
+        std::ifstream(TEST_ADMIN_RECORD_FILE, std::ifstream::binary | std::ifstream::ate).tellg()));
+    ASSERT_TRUE(adminMgr_->DeleteAdmin("com.edm.test.demo1") == ERR_OK);
+
+    /* an interrupted append is dropped, the admins before it are loaded */
+    {
+        std::ofstream ofs(TEST_ADMIN_RECORD_FILE, std::ofstream::binary | std::ofstream::app);
+        ofs << "torn";
+    }
+    adminMgr_->Init();
+    std::vector<std::shared_ptr<Admin>> allAdmin;
+    adminMgr_->GetAllAdmin(allAdmin);
+    ASSERT_TRUE(allAdmin.size() == HUGE_ADMIN_SIZE - 1);
+    ASSERT_TRUE(allAdmin[0]->adminInfo_.packageName_ == "com.edm.test.demo0");
+    ASSERT_TRUE(allAdmin[0]->adminInfo_.entInfo_.enterpriseName == "new company");
+    ASSERT_TRUE(adminMgr_->GetAdminByPkgName("com.edm.test.demo1") == nullptr);
+    /* the file accepts appends again after the torn record is dropped */
+    ASSERT_TRUE(adminMgr_->DeleteAdmin("com.edm.test.demo2") == ERR_OK);
+    adminMgr_->Init();
+    ASSERT_TRUE(adminMgr_->GetAdminByPkgName("com.edm.test.demo2") == nullptr);
+    ASSERT_TRUE(adminMgr_->GetAdminByPkgName("com.edm.test.demo3") != nullptr);
+}
+
+/**
+ * @tc.name: TestMigrateAdminJson
+ * @tc.desc: Test AdminManager migrates the admins of the json file to the record file.
+ * @tc.type: FUNC
+ */
+HWTEST_F(AdminManagerTest, TestMigrateAdminJson, TestSize.Level1)
+{
+    unlink(TEST_ADMIN_RECORD_FILE.c_str());
+    {
+        std::ofstream ofs(TEST_ADMIN_JSON_FILE);
+        ofs << "{\"admin\": [{\"name\": \"com.edm.test.demo/testDemo\", \"adminType\": 0, "
+            "\"enterpriseInfo\": {\"enterpriseName\": \"company\", \"declaration\": \"\"}, "
+            "\"permission\": [\"ohos.permission.EDM_TEST_PERMISSION\"]}]}";
+    }
+    adminMgr_->Init();
+    std::shared_ptr<Admin> admin = adminMgr_->GetAdminByPkgName("com.edm.test.demo");
+    ASSERT_TRUE(admin != nullptr);
+    ASSERT_TRUE(admin->adminInfo_.className_ == "testDemo");
+    ASSERT_TRUE(admin->CheckPermission("ohos.permission.EDM_TEST_PERMISSION"));
+    ASSERT_TRUE(access(TEST_ADMIN_JSON_FILE.c_str(), F_OK) != 0);
+    ASSERT_TRUE(access(TEST_ADMIN_RECORD_FILE.c_str(), F_OK) == 0);
+    /* the json file has no user, the migrated admin is an admin of every user */
+    ASSERT_TRUE(adminMgr_->GetAdminByPkgName("com.edm.test.demo", TEST_USER_ID) != nullptr);
+
+    adminMgr_->Init();
+    ASSERT_TRUE(adminMgr_->GetAdminByPkgName("com.edm.test.demo") != nullptr);
+}
+
+/**
+ * @tc.name: TestAdminUserPartition
+ * @tc.desc: Test AdminManager keeps the admins of every user apart and loads a user on its first use.
+ * @tc.type: FUNC
+ */
+HWTEST_F(AdminManagerTest, TestAdminUserPartition, TestSize.Level1)
+{
+    AppExecFwk::AbilityInfo abilityInfo;
+    abilityInfo.name = "testDemo";
+    EntInfo entInfo;
+    std::vector<std::string> permissions = { "ohos.permission.EDM_TEST_PERMISSION" };
+    abilityInfo.bundleName = "com.edm.test.demo";
+    ASSERT_TRUE(adminMgr_->SetAdminValue(abilityInfo, entInfo, AdminType::NORMAL, permissions, TEST_USER_ID) ==
+        ERR_OK);
+    ASSERT_TRUE(adminMgr_->GetAdminByPkgName("com.edm.test.demo", TEST_USER_ID) != nullptr);
+    ASSERT_TRUE(adminMgr_->GetAdminByPkgName("com.edm.test.demo") == nullptr);
+    ASSERT_TRUE(access(TEST_USER_ADMIN_RECORD_FILE.c_str(), F_OK) == 0);
+
+    /* the super admin is saved with the default user and is an admin of every user */
+    abilityInfo.bundleName = "com.edm.test.demo1";
+    ASSERT_TRUE(adminMgr_->SetAdminValue(abilityInfo, entInfo, AdminType::ENT, permissions, TEST_USER_ID) ==
+        ERR_OK);
+    ASSERT_TRUE(adminMgr_->IsSuperAdminExist());
+    ASSERT_TRUE(adminMgr_->GetAdminByPkgName("com.edm.test.demo1") != nullptr);
+    ASSERT_TRUE(adminMgr_->GetAdminByPkgName("com.edm.test.demo1", TEST_USER_ID) != nullptr);
+    entInfo.enterpriseName = "company";
+    ASSERT_TRUE(adminMgr_->SetEntInfo("com.edm.test.demo1", entInfo, TEST_USER_ID) == ERR_OK);
+    std::vector<std::string> activeAdmins;
+    adminMgr_->GetActiveAdmin(AdminType::NORMAL, activeAdmins, TEST_USER_ID);
+    ASSERT_TRUE(activeAdmins.size() == 1);
+    adminMgr_->GetActiveAdmin(AdminType::ENT, activeAdmins, TEST_USER_ID);
+    ASSERT_TRUE(activeAdmins.size() == 1);
+
+    /* a stopped user is released and loaded again on its next use */
+    std::vector<int32_t> userIds;
+    adminMgr_->UnloadUser(TEST_USER_ID);
+    adminMgr_->UnloadUser(DEFAULT_USER_ID);
+    adminMgr_->GetLoadedUsers(userIds);
+    ASSERT_TRUE(userIds.size() == 1 && userIds[0] == DEFAULT_USER_ID);
+    ASSERT_TRUE(adminMgr_->GetAdminByPkgName("com.edm.test.demo", TEST_USER_ID) != nullptr);
+    adminMgr_->GetLoadedUsers(userIds);
+    ASSERT_TRUE(userIds.size() == 2);
+    ASSERT_TRUE(adminMgr_->DeleteAdmin("com.edm.test.demo", TEST_USER_ID) == ERR_OK);
+    adminMgr_->UnloadUser(TEST_USER_ID);
+    ASSERT_TRUE(adminMgr_->GetAdminByPkgName("com.edm.test.demo", TEST_USER_ID) == nullptr);
+    std::shared_ptr<Admin> admin = adminMgr_->GetAdminByPkgName("com.edm.test.demo1", TEST_USER_ID);
+    ASSERT_TRUE(admin != nullptr);
+    ASSERT_TRUE(admin->adminInfo_.entInfo_.enterpriseName == "company");
+}
+
+/**
+ * @tc.name: TestAdminOfOtherUser
+ * @tc.desc: Test AdminManager finds the package activated as an admin of another user, loaded or not.
+ * @tc.type: FUNC
+ */
+HWTEST_F(AdminManagerTest, TestAdminOfOtherUser, TestSize.Level1)
+{
+    AppExecFwk::AbilityInfo abilityInfo;
+    abilityInfo.name = "testDemo";
+    EntInfo entInfo;
+    std::vector<std::string> permissions = { "ohos.permission.EDM_TEST_PERMISSION" };
+    abilityInfo.bundleName = "com.edm.test.demo";
+    ASSERT_TRUE(adminMgr_->SetAdminValue(abilityInfo, entInfo, AdminType::NORMAL, permissions) == ERR_OK);
+    ASSERT_FALSE(adminMgr_->IsAdminOfOtherUser("com.edm.test.demo", AdminType::NORMAL, DEFAULT_USER_ID));
+    ASSERT_TRUE(adminMgr_->IsAdminOfOtherUser("com.edm.test.demo", AdminType::NORMAL, TEST_USER_ID));
+    /* the admin of the default user can be activated as the super admin from any user */
+    ASSERT_FALSE(adminMgr_->IsAdminOfOtherUser("com.edm.test.demo", AdminType::ENT, TEST_USER_ID));
+    ASSERT_TRUE(adminMgr_->DeleteAdmin("com.edm.test.demo") == ERR_OK);
+
+    /* a user without a record file is not loaded by a lookup */
+    std::vector<int32_t> userIds;
+    ASSERT_TRUE(adminMgr_->GetAdminByPkgName("com.edm.test.demo", TEST_USER_ID) == nullptr);
+    ASSERT_TRUE(adminMgr_->DeleteAdmin("com.edm.test.demo", TEST_USER_ID) == ERR_EDM_UNKNOWN_ADMIN);
+    adminMgr_->GetLoadedUsers(userIds);
+    ASSERT_TRUE(userIds.size() == 1 && userIds[0] == DEFAULT_USER_ID);
+
+    /* the record file of a stopped user is read without loading the user */
+    ASSERT_TRUE(adminMgr_->SetAdminValue(abilityInfo, entInfo, AdminType::NORMAL, permissions, TEST_USER_ID) ==
+        ERR_OK);
+    adminMgr_->UnloadUser(TEST_USER_ID);
+    ASSERT_TRUE(adminMgr_->IsAdminOfOtherUser("com.edm.test.demo", AdminType::NORMAL, DEFAULT_USER_ID));
+    ASSERT_TRUE(adminMgr_->IsAdminOfOtherUser("com.edm.test.demo", AdminType::ENT, DEFAULT_USER_ID));
+    ASSERT_FALSE(adminMgr_->IsAdminOfOtherUser("com.edm.test.demo", AdminType::NORMAL, TEST_USER_ID));
+    adminMgr_->GetLoadedUsers(userIds);
+    ASSERT_TRUE(userIds.size() == 1 && userIds[0] == DEFAULT_USER_ID);
+    ASSERT_TRUE(adminMgr_->DeleteAdmin("com.edm.test.demo", TEST_USER_ID) == ERR_OK);
+    ASSERT_FALSE(adminMgr_->IsAdminOfOtherUser("com.edm.test.demo", AdminType::NORMAL, DEFAULT_USER_ID));
+
+    /* the super admin is an admin of every user */
+    abilityInfo.bundleName = "com.edm.test.demo1";
+    ASSERT_TRUE(adminMgr_->SetAdminValue(abilityInfo, entInfo, AdminType::ENT, permissions) == ERR_OK);
+    ASSERT_FALSE(adminMgr_->IsAdminOfOtherUser("com.edm.test.demo1", AdminType::NORMAL, TEST_USER_ID));
+}
+
+/**
+ * @tc.name: TestDefaultUserAdminOfEveryUser
+ * @tc.desc: Test the admin activated by the kit, which passes the default user, serves the requests of another user.
+ * @tc.type: FUNC
+ */
+HWTEST_F(AdminManagerTest, TestDefaultUserAdminOfEveryUser, TestSize.Level1)
+{
+    AppExecFwk::AbilityInfo abilityInfo;
+    abilityInfo.name = "testDemo";
+    EntInfo entInfo;
+    std::vector<std::string> permissions = { "ohos.permission.EDM_TEST_PERMISSION" };
+    abilityInfo.bundleName = "com.edm.test.demo";
+    ASSERT_TRUE(adminMgr_->SetAdminValue(abilityInfo, entInfo, AdminType::NORMAL, permissions, DEFAULT_USER_ID) ==
+        ERR_OK);
+    abilityInfo.bundleName = "com.edm.test.demo1";
+    ASSERT_TRUE(adminMgr_->SetAdminValue(abilityInfo, entInfo, AdminType::NORMAL, permissions, TEST_USER_ID) ==
+        ERR_OK);
+
+    /* a policy request of the other user finds the admin and its permission */
+    std::shared_ptr<Admin> admin = adminMgr_->GetAdminByPkgName("com.edm.test.demo", TEST_USER_ID);
+    ASSERT_TRUE(admin != nullptr);
+    ASSERT_TRUE(admin->CheckPermission("ohos.permission.EDM_TEST_PERMISSION"));
+    entInfo.enterpriseName = "company";
+    ASSERT_TRUE(adminMgr_->SetEntInfo("com.edm.test.demo", entInfo, TEST_USER_ID) == ERR_OK);
+    EntInfo savedEntInfo;
+    ASSERT_TRUE(adminMgr_->GetEntInfo("com.edm.test.demo", savedEntInfo) == ERR_OK);
+    ASSERT_TRUE(savedEntInfo.enterpriseName == "company");
+    std::vector<std::string> activeAdmins;
+    adminMgr_->GetActiveAdmin(AdminType::NORMAL, activeAdmins, TEST_USER_ID);
+    ASSERT_TRUE(activeAdmins.size() == 2);
+    ASSERT_TRUE(activeAdmins[0] == "com.edm.test.demo/testDemo");
+    adminMgr_->GetActiveAdmin(AdminType::NORMAL, activeAdmins);
+    ASSERT_TRUE(activeAdmins.size() == 1);
+
+    /* the admin of another user stays in its own user */
+    ASSERT_TRUE(adminMgr_->GetAdminByPkgName("com.edm.test.demo1") == nullptr);
+    ASSERT_TRUE(adminMgr_->DeleteAdmin("com.edm.test.demo", TEST_USER_ID) == ERR_OK);
+    ASSERT_TRUE(adminMgr_->GetAdminByPkgName("com.edm.test.demo", TEST_USER_ID) == nullptr);
+    ASSERT_TRUE(adminMgr_->DeleteAdmin("com.edm.test.demo1", TEST_USER_ID) == ERR_OK);
+}
+
+/**
+ * @tc.name: TestActiveAdminList
+ * @tc.desc: Test AdminManager rebuilds the cached active admin lists only when the admin set changes.
+ * @tc.type: FUNC
+ */
+HWTEST_F(AdminManagerTest, TestActiveAdminList, TestSize.Level1)
+{
+    AppExecFwk::AbilityInfo abilityInfo;
+    abilityInfo.name = "testDemo";
+    EntInfo entInfo;
+    std::vector<std::string> permissions = { "ohos.permission.EDM_TEST_PERMISSION" };
+    abilityInfo.bundleName = "com.edm.test.demo";
+    ASSERT_TRUE(adminMgr_->SetAdminValue(abilityInfo, entInfo, AdminType::ENT, permissions) == ERR_OK);
+    abilityInfo.bundleName = "com.edm.test.demo1";
+    ASSERT_TRUE(adminMgr_->SetAdminValue(abilityInfo, entInfo, AdminType::NORMAL, permissions) == ERR_OK);
+    abilityInfo.bundleName = "com.edm.test.demo2";
+    ASSERT_TRUE(adminMgr_->SetAdminValue(abilityInfo, entInfo, AdminType::NORMAL, permissions) == ERR_OK);
+
+    std::shared_ptr<const ActiveAdminList> normalList = adminMgr_->GetActiveAdminList(AdminType::NORMAL);
+    ASSERT_TRUE(normalList->size() == 2);
+    ASSERT_TRUE((*normalList)[0] == u"com.edm.test.demo1/testDemo");
+    ASSERT_TRUE((*normalList)[1] == u"com.edm.test.demo2/testDemo");
+    std::shared_ptr<const ActiveAdminList> superList = adminMgr_->GetActiveAdminList(AdminType::ENT);
+    ASSERT_TRUE(superList->size() == 1);
+    ASSERT_TRUE((*superList)[0] == u"com.edm.test.demo/testDemo");
+    ASSERT_TRUE(adminMgr_->GetActiveAdminList(AdminType::UNKNOWN)->empty());
+
+    /* the enterprise info is not in the list, the cached list is kept */
+    entInfo.enterpriseName = "company";
+    ASSERT_TRUE(adminMgr_->SetEntInfo("com.edm.test.demo1", entInfo) == ERR_OK);
+    ASSERT_TRUE(adminMgr_->GetActiveAdminList(AdminType::NORMAL) == normalList);
+
+    ASSERT_TRUE(adminMgr_->DeleteAdmin("com.edm.test.demo1") == ERR_OK);
+    std::shared_ptr<const ActiveAdminList> newNormalList = adminMgr_->GetActiveAdminList(AdminType::NORMAL);
+    ASSERT_TRUE(newNormalList->size() == 1);
+    ASSERT_TRUE((*newNormalList)[0] == u"com.edm.test.demo2/testDemo");
+    /* a returned list is never changed */
+    ASSERT_TRUE(normalList->size() == 2);
+}
 } // namespace TEST
 } // namespace EDM
 } // namespace OHOS
\ No newline at end of file
@@ -87,6 +87,34 @@ HWTEST_F(PermissionManagerTest, GetReqPermission02, TestSize.Level1)
     PermissionManager::GetInstance()->GetReqPermission(permission, reqPermission);
     ASSERT_TRUE(reqPermission.size() == 1);
 }
+/**
+ * @tc.name: TestGetPermissionId
+ * @tc.desc: Test PermissionManager GetPermissionId and GetPermissionBits func.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PermissionManagerTest, TestGetPermissionId, TestSize.Level1)
+{
+    std::uint32_t permissionId = PermissionManager::GetInstance()->GetPermissionId(
+        "ohos.permission.EDM_TEST_PERMISSION");
+    std::uint32_t entPermissionId = PermissionManager::GetInstance()->GetPermissionId(
+        "ohos.permission.EDM_TEST_ENT_PERMISSION");
+    ASSERT_TRUE(permissionId < EDM_MAX_PERMISSION_NUM);
+    ASSERT_TRUE(entPermissionId < EDM_MAX_PERMISSION_NUM);
+    ASSERT_TRUE(permissionId != entPermissionId);
+    ASSERT_EQ(PermissionManager::GetInstance()->GetPermissionId("ohos.permission.EMD_TEST_PERMISSION_FAIL"),
+        EDM_INVALID_PERMISSION_ID);
+    /* the id doesn't depend on the order the permissions are added */
+    PermissionManager::GetInstance()->AddPermission("ohos.permission.EDM_TEST_ENT_PERMISSION");
+    ASSERT_EQ(PermissionManager::GetInstance()->GetPermissionId("ohos.permission.EDM_TEST_PERMISSION"),
+        permissionId);
+
+    PermissionBits permissionBits;
+    std::vector<std::string> permission = {
+        "ohos.permission.EDM_TEST_PERMISSION", "ohos.permission.EMD_TEST_PERMISSION_FAIL" };
+    PermissionManager::GetInstance()->GetPermissionBits(permission, permissionBits);
+    ASSERT_TRUE(permissionBits.count() == 1);
+    ASSERT_TRUE(permissionBits.test(permissionId));
+}
 } // namespace TEST
 } // namespace EDM
 } // namespace OHOS
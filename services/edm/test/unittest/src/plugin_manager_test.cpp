@@ -14,11 +14,14 @@
  */
 
 #include "plugin_manager_test.h"
+#include <fstream>
+#include <thread>
 #include <ipc_skeleton.h>
 #include <iservice_registry.h>
 #include "enterprise_device_mgr_proxy.h"
 #include "enterprise_device_mgr_ability.h"
 #include "func_code_utils.h"
+#include "cmd_utils.h"
 #include "plugin_manager.h"
 #include "string_ex.h"
 #include "system_ability_definition.h"
@@ -30,6 +33,15 @@ using namespace OHOS::EDM;
 namespace OHOS {
 namespace EDM {
 namespace TEST {
+const std::string TEST_INDEX_DIR = "/data/test_edm_plugin/";
+const std::string TEST_INDEX_FILE = TEST_INDEX_DIR + "plugin_index.json";
+const std::string TEST_INDEX_CMD = "mkdir -p " + TEST_INDEX_DIR;
+const std::string TEST_INDEX_TEAR_DOWN_CMD = "rm -rf " + TEST_INDEX_DIR;
+constexpr std::uint32_t TEST_LAZY_POLICY_CODE = 0xF001;
+constexpr std::uint32_t TEST_CONCURRENT_POLICY_CODE = 0x2000;
+constexpr std::uint32_t TEST_THREAD_COUNT = 4;
+constexpr std::uint32_t TEST_PLUGIN_COUNT_PER_THREAD = 300;
+
 void PluginManagerTest::SetUp()
 {
     PluginManager::GetInstance()->AddPlugin(std::make_shared<TestPlugin>());
@@ -64,6 +76,10 @@ HWTEST_F(PluginManagerTest, TestGetPluginByFuncCode, TestSize.Level1)
     ASSERT_TRUE(plugin->GetPolicyName() == "TestPlugin");
     ASSERT_TRUE(PluginManager::GetInstance()->GetPluginByFuncCode(
         POLICY_FUNC_CODE((uint32_t)FuncOperateType::SET, 100000)) == nullptr);
+    ASSERT_TRUE(PluginManager::GetInstance()->GetPluginByFuncCode(
+        POLICY_FUNC_CODE((uint32_t)FuncOperateType::SET, 1)) == nullptr);
+    ASSERT_TRUE(PluginManager::GetInstance()->GetPluginByFuncCode(
+        CREATE_FUNC_CODE(0, (uint32_t)FuncOperateType::SET, 0)) == nullptr);
 }
 
 /**
@@ -78,6 +94,90 @@ HWTEST_F(PluginManagerTest, TestGetPluginByPolicyName, TestSize.Level1)
     ASSERT_TRUE(plugin->GetCode() == 0);
     ASSERT_TRUE(PluginManager::GetInstance()->GetPluginByPolicyName("XXXXExamplePlugin") == nullptr);
 }
+
+/**
+ * @tc.name: TestLoadIndex
+ * @tc.desc: Test PluginManager registers the plugins of the plugin index without opening their libraries.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginManagerTest, TestLoadIndex, TestSize.Level1)
+{
+    std::size_t pluginCount = 0;
+    ASSERT_FALSE(PluginManager::GetInstance()->LoadIndex(TEST_INDEX_FILE, TEST_INDEX_DIR, pluginCount));
+    CmdUtils::ExecCmdSync(TEST_INDEX_CMD);
+    {
+        std::ofstream ofs(TEST_INDEX_FILE);
+        ofs << "{\"plugins\": [{\"library\": \"libtest_lazy_plugin.z.so\", \"policies\": ["
+            << "{\"code\": " << TEST_LAZY_POLICY_CODE << ", \"name\": \"test_lazy_plugin\", "
+            << "\"permission\": \"ohos.permission.EDM_TEST_PERMISSION\", \"need_save\": true, \"global\": true}, "
+            << "{\"code\": 0, \"name\": \"test_duplicate_plugin\", "
+            << "\"permission\": \"ohos.permission.EDM_TEST_PERMISSION\", \"need_save\": true, \"global\": true}, "
+            << "{\"code\": 1, \"name\": \"test_invalid_plugin\", "
+            << "\"permission\": \"ohos.permission.EDM_TEST_PERMISSION\"}]}]}";
+    }
+    std::size_t libraryCount = 0;
+    std::size_t openedCount = 0;
+    PluginManager::GetInstance()->GetLibraryCount(libraryCount, openedCount);
+    ASSERT_TRUE(PluginManager::GetInstance()->LoadIndex(TEST_INDEX_FILE, TEST_INDEX_DIR, pluginCount));
+    ASSERT_TRUE(pluginCount == 1);
+
+    std::size_t newLibraryCount = 0;
+    PluginManager::GetInstance()->GetLibraryCount(newLibraryCount, openedCount);
+    ASSERT_TRUE(newLibraryCount == libraryCount + 1);
+    ASSERT_TRUE(openedCount == 0);
+    /* a plugin differing from its descriptor in the index is not installed */
+    PluginManager::GetInstance()->AddPlugin(std::make_shared<TestPlugin>(TEST_LAZY_POLICY_CODE, "test_renamed_plugin"));
+    ASSERT_TRUE(PluginManager::GetInstance()->GetPluginByPolicyName("test_renamed_plugin") == nullptr);
+    /* the library doesn't exist, the lookup fails once it is opened */
+    ASSERT_TRUE(PluginManager::GetInstance()->GetPluginByFuncCode(
+        POLICY_FUNC_CODE((uint32_t)FuncOperateType::SET, TEST_LAZY_POLICY_CODE)) == nullptr);
+    ASSERT_TRUE(PluginManager::GetInstance()->GetPluginByPolicyName("test_lazy_plugin") == nullptr);
+    /* a code registered already keeps its plugin, a policy without need_save and global is skipped */
+    ASSERT_TRUE(PluginManager::GetInstance()->GetPluginByPolicyName("test_duplicate_plugin") == nullptr);
+    ASSERT_TRUE(PluginManager::GetInstance()->GetPluginByPolicyName("test_invalid_plugin") == nullptr);
+    ASSERT_TRUE(PluginManager::GetInstance()->GetPluginByPolicyName("TestPlugin") != nullptr);
+
+    /* the failed open is timed too, no plugin registered */
+    PluginManager::GetInstance()->SetLoadBudget(0);
+    std::vector<PluginLoadTime> loadTimes;
+    ASSERT_TRUE(PluginManager::GetInstance()->GetLoadTimes(loadTimes) == 0);
+    ASSERT_TRUE(loadTimes.size() == newLibraryCount);
+    ASSERT_TRUE(loadTimes.back().library == TEST_INDEX_DIR + "libtest_lazy_plugin.z.so");
+    ASSERT_TRUE(loadTimes.back().loadUs >= 0);
+    ASSERT_TRUE(loadTimes.back().initTimes.empty());
+    CmdUtils::ExecCmdSync(TEST_INDEX_TEAR_DOWN_CMD);
+}
+
+/**
+ * @tc.name: TestAddPluginConcurrently
+ * @tc.desc: Test PluginManager AddPlugin func from several threads, as the plugin libraries opened in parallel.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PluginManagerTest, TestAddPluginConcurrently, TestSize.Level1)
+{
+    std::vector<std::thread> threads;
+    for (std::uint32_t i = 0; i < TEST_THREAD_COUNT; i++) {
+        threads.emplace_back([i]() {
+            for (std::uint32_t j = 0; j < TEST_PLUGIN_COUNT_PER_THREAD; j++) {
+                std::uint32_t code = TEST_CONCURRENT_POLICY_CODE + i * TEST_PLUGIN_COUNT_PER_THREAD + j;
+                PluginManager::GetInstance()->AddPlugin(
+                    std::make_shared<TestPlugin>(code, "TestPlugin" + std::to_string(code)));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (std::uint32_t code = TEST_CONCURRENT_POLICY_CODE;
+        code < TEST_CONCURRENT_POLICY_CODE + TEST_THREAD_COUNT * TEST_PLUGIN_COUNT_PER_THREAD; code++) {
+        const std::shared_ptr<IPlugin> &plugin = PluginManager::GetInstance()->GetPluginByFuncCode(
+            POLICY_FUNC_CODE((uint32_t)FuncOperateType::SET, code));
+        ASSERT_TRUE(plugin != nullptr);
+        ASSERT_TRUE(plugin->GetCode() == code);
+        ASSERT_TRUE(PluginManager::GetInstance()->GetPluginByPolicyName("TestPlugin" + std::to_string(code)) ==
+            plugin);
+    }
+}
 } // namespace TEST
 } // namespace EDM
 } // namespace OHOS
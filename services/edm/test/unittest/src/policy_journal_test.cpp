@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "cmd_utils.h"
+#include "policy_journal.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace EDM {
+namespace TEST {
+const std::string TEST_JOURNAL_FILE = "/data/system/test_device_policies.journal";
+const std::string TEAR_DOWN_CMD = "rm -f /data/system/test_device_policies.journal*";
+constexpr std::uint64_t TEST_RECORD_NUM = 3;
+
+class PolicyJournalTest : public testing::Test {
+protected:
+    virtual void TearDown() override
+    {
+        CmdUtils::ExecCmdSync(TEAR_DOWN_CMD);
+    }
+
+    void AppendRecords(PolicyJournal &journal, std::uint64_t begin, std::uint64_t end)
+    {
+        for (std::uint64_t i = begin; i <= end; ++i) {
+            PolicyJournalRecord record;
+            record.sequence = i;
+            record.adminName = "com.edm.test.demo";
+            record.policyName = "testPolicy";
+            record.adminPolicy = std::to_string(i);
+            record.mergedPolicy = std::to_string(i);
+            std::uint64_t writtenBytes = 0;
+            ASSERT_TRUE(journal.Append(record, writtenBytes) == ERR_OK);
+            ASSERT_TRUE(writtenBytes > 0);
+        }
+    }
+
+    std::vector<PolicyJournalRecord> ReplayRecords(std::uint64_t minSequence, std::uint64_t &lastSequence)
+    {
+        std::vector<PolicyJournalRecord> records;
+        PolicyJournal journal(TEST_JOURNAL_FILE);
+        lastSequence = journal.Replay(minSequence, [&records](const PolicyJournalRecord &record) {
+            records.push_back(record);
+        });
+        return records;
+    }
+};
+
+/**
+ * @tc.name: TestReplay
+ * @tc.desc: Test PolicyJournal Append and Replay func.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PolicyJournalTest, TestReplay, TestSize.Level1)
+{
+    PolicyJournal journal(TEST_JOURNAL_FILE);
+    ASSERT_TRUE(journal.Open() == ERR_OK);
+    AppendRecords(journal, 1, TEST_RECORD_NUM);
+
+    std::uint64_t lastSequence = 0;
+    std::vector<PolicyJournalRecord> records = ReplayRecords(0, lastSequence);
+    ASSERT_TRUE(records.size() == TEST_RECORD_NUM);
+    ASSERT_TRUE(lastSequence == TEST_RECORD_NUM);
+    ASSERT_TRUE(records[0].adminPolicy == "1");
+
+    records = ReplayRecords(1, lastSequence);
+    ASSERT_TRUE(records.size() == TEST_RECORD_NUM - 1);
+    ASSERT_TRUE(records[0].sequence == 2);
+}
+
+/**
+ * @tc.name: TestReplayTornTail
+ * @tc.desc: Test PolicyJournal Replay func drops the torn tail of the journal.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PolicyJournalTest, TestReplayTornTail, TestSize.Level1)
+{
+    {
+        PolicyJournal journal(TEST_JOURNAL_FILE);
+        ASSERT_TRUE(journal.Open() == ERR_OK);
+        AppendRecords(journal, 1, TEST_RECORD_NUM);
+    }
+    std::ofstream ofs(TEST_JOURNAL_FILE, std::ofstream::binary | std::ofstream::app);
+    ofs << "torn";
+    ofs.close();
+
+    std::uint64_t lastSequence = 0;
+    std::vector<PolicyJournalRecord> records = ReplayRecords(0, lastSequence);
+    ASSERT_TRUE(records.size() == TEST_RECORD_NUM);
+
+    PolicyJournal journal(TEST_JOURNAL_FILE);
+    ASSERT_TRUE(journal.Open() == ERR_OK);
+    AppendRecords(journal, TEST_RECORD_NUM + 1, TEST_RECORD_NUM + 1);
+    records = ReplayRecords(0, lastSequence);
+    ASSERT_TRUE(records.size() == TEST_RECORD_NUM + 1);
+    ASSERT_TRUE(lastSequence == TEST_RECORD_NUM + 1);
+}
+
+/**
+ * @tc.name: TestRotate
+ * @tc.desc: Test PolicyJournal Rotate and Reset func.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PolicyJournalTest, TestRotate, TestSize.Level1)
+{
+    PolicyJournal journal(TEST_JOURNAL_FILE);
+    ASSERT_TRUE(journal.Open() == ERR_OK);
+    AppendRecords(journal, 1, TEST_RECORD_NUM);
+    ASSERT_TRUE(journal.Rotate() == ERR_OK);
+    ASSERT_TRUE(journal.HasRotated());
+    AppendRecords(journal, TEST_RECORD_NUM + 1, TEST_RECORD_NUM + 1);
+
+    std::uint64_t lastSequence = 0;
+    std::vector<PolicyJournalRecord> records = ReplayRecords(0, lastSequence);
+    ASSERT_TRUE(records.size() == TEST_RECORD_NUM + 1);
+
+    ASSERT_TRUE(journal.Reset() == ERR_OK);
+    ASSERT_FALSE(journal.HasRotated());
+    records = ReplayRecords(0, lastSequence);
+    ASSERT_TRUE(records.empty());
+}
+
+/**
+ * @tc.name: TestAppendBatch
+ * @tc.desc: Test PolicyJournal Append func with a batch of records.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PolicyJournalTest, TestAppendBatch, TestSize.Level1)
+{
+    PolicyJournal journal(TEST_JOURNAL_FILE);
+    ASSERT_TRUE(journal.Open() == ERR_OK);
+    std::vector<PolicyJournalRecord> batch(TEST_RECORD_NUM);
+    for (std::uint64_t i = 0; i < TEST_RECORD_NUM; ++i) {
+        batch[i].sequence = i + 1;
+        batch[i].policyName = "testPolicy";
+    }
+    std::uint64_t writtenBytes = 0;
+    ASSERT_TRUE(journal.Append(batch, writtenBytes) == ERR_OK);
+    ASSERT_TRUE(journal.Sync() == ERR_OK);
+
+    std::uint64_t lastSequence = 0;
+    std::vector<PolicyJournalRecord> records = ReplayRecords(0, lastSequence);
+    ASSERT_TRUE(records.size() == TEST_RECORD_NUM);
+    ASSERT_TRUE(lastSequence == TEST_RECORD_NUM);
+}
+} // namespace TEST
+} // namespace EDM
+} // namespace OHOS
@@ -13,11 +13,19 @@
  * limitations under the License.
  */
 
+#include <atomic>
+#include <chrono>
 #include <gtest/gtest.h>
 #include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
 #include <vector>
 #include "cmd_utils.h"
+#include "policy_file_store.h"
 #include "policy_manager.h"
+#include "policy_memory_store.h"
+#include "policy_transaction.h"
 #include "array_string_serializer.h"
 
 using namespace testing::ext;
@@ -31,6 +39,75 @@ const std::string TEST_BOOL_POLICY_NAME = "testBoolPolicy";
 const std::string TEST_STRING_POLICY_NAME = "testStringPolicy";
 constexpr int HUGE_POLICY_SIZE = 65537;
 const std::string TEAR_DOWN_CMD = "rm /data/system/device_policies.json";
+const std::string TEST_EXPORT_JSON_FILE = "/data/system/test_device_policies.json";
+const std::string TEST_JOURNAL_FILE = "/data/system/device_policies.journal";
+constexpr std::uint32_t TEST_QUIET_WINDOW_MS = 60000;
+constexpr int TEST_CONCURRENT_SET_NUM = 1000;
+constexpr int TEST_PERSIST_QUEUE_OVERFLOW_NUM = 600;
+constexpr int TEST_SLOW_STORE_DELAY_MS = 50;
+const std::string TEST_SNAPSHOT_FILE = "/data/system/device_policies.snapshot";
+const std::string TEST_SHARD_MANIFEST_FILE = "/data/system/device_policies/manifest";
+const std::string TEST_SHARD_ADMIN_FILE = "/data/system/device_policies/admin_com.edm.test.demo1.snapshot";
+
+/*
+ * A memory store writing the deltas slowly, the writers fill the queue while the worker is writing.
+ */
+class SlowPolicyStore : public PolicyMemoryStore {
+public:
+    ErrCode ApplyDelta(const std::vector<PolicyJournalRecord> &records, bool sync) override
+    {
+        if (!records.empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(TEST_SLOW_STORE_DELAY_MS));
+        }
+        deltaCount_ += records.size();
+        return PolicyMemoryStore::ApplyDelta(records, sync);
+    }
+
+    std::size_t GetDeltaCount() const
+    {
+        return deltaCount_;
+    }
+
+private:
+    std::atomic<std::size_t> deltaCount_ {0};
+};
+
+/*
+ * A memory store dropping the deltas while it is lossy, the changes made meanwhile are lost on the next load.
+ */
+class LossyPolicyStore : public PolicyMemoryStore {
+public:
+    ErrCode ApplyDelta(const std::vector<PolicyJournalRecord> &records, bool sync) override
+    {
+        if (isLossy_) {
+            return ERR_OK;
+        }
+        return PolicyMemoryStore::ApplyDelta(records, sync);
+    }
+
+    ErrCode Flush(const std::shared_ptr<const PolicyTable> &table, std::uint64_t sequence) override
+    {
+        if (isLossy_) {
+            return ERR_OK;
+        }
+        return PolicyMemoryStore::Flush(table, sequence);
+    }
+
+    void Checkpoint(const std::shared_ptr<const PolicyTable> &table, std::uint64_t sequence) override
+    {
+        if (!isLossy_) {
+            PolicyMemoryStore::Checkpoint(table, sequence);
+        }
+    }
+
+    void SetLossy(bool isLossy)
+    {
+        isLossy_ = isLossy;
+    }
+
+private:
+    std::atomic<bool> isLossy_ {false};
+};
 
 class PolicyManagerTest : public testing::Test {
 public:
@@ -192,6 +269,416 @@ HWTEST_F(PolicyManagerTest, TestSetPolicyHuge, TestSize.Level1)
         policyValue, policyValue);
     ASSERT_TRUE(res == ERR_OK);
 }
+
+/**
+ * @tc.name: TestExportImportPolicyJson
+ * @tc.desc: Test PolicyManager ExportPolicyJson and ImportPolicyJson func.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PolicyManagerTest, TestExportImportPolicyJson, TestSize.Level1)
+{
+    ErrCode res;
+    res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, "false", "true");
+    ASSERT_TRUE(res == ERR_OK);
+    res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME1, TEST_STRING_POLICY_NAME, "[\"a\"]", "[\"a\"]");
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(PolicyManager::GetInstance()->ExportPolicyJson(TEST_EXPORT_JSON_FILE) == ERR_OK);
+
+    res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, "", "");
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(PolicyManager::GetInstance()->ImportPolicyJson(TEST_EXPORT_JSON_FILE) == ERR_OK);
+    CmdUtils::ExecCmdSync("rm " + TEST_EXPORT_JSON_FILE);
+
+    PolicyManager::GetInstance()->Init();
+    std::string policyValue;
+    res = PolicyManager::GetInstance()->GetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, policyValue);
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(policyValue == "false");
+    res = PolicyManager::GetInstance()->GetPolicy("", TEST_BOOL_POLICY_NAME, policyValue);
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(policyValue == "true");
+
+    AdminValueItemsMap adminValueItems;
+    res = PolicyManager::GetInstance()->GetAdminByPolicyName(TEST_STRING_POLICY_NAME, adminValueItems);
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(adminValueItems.size() == 1);
+}
+
+static off_t GetFileSize(const std::string &path)
+{
+    struct stat fileStat = {};
+    if (stat(path.c_str(), &fileStat) != 0) {
+        return 0;
+    }
+    return fileStat.st_size;
+}
+
+/**
+ * @tc.name: TestSetPolicyCoalescing
+ * @tc.desc: Test PolicyManager SetCoalescing and Flush func.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PolicyManagerTest, TestSetPolicyCoalescing, TestSize.Level1)
+{
+    PolicyManager::GetInstance()->SetCoalescing(TEST_QUIET_WINDOW_MS, TEST_QUIET_WINDOW_MS);
+    off_t journalSize = GetFileSize(TEST_JOURNAL_FILE);
+    ErrCode res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, "false", "true");
+    ASSERT_TRUE(res == ERR_OK);
+    res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME1, TEST_BOOL_POLICY_NAME, "true", "true");
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(GetFileSize(TEST_JOURNAL_FILE) == journalSize);
+
+    std::string policyValue;
+    res = PolicyManager::GetInstance()->GetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, policyValue);
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(policyValue == "false");
+
+    ASSERT_TRUE(PolicyManager::GetInstance()->Flush() == ERR_OK);
+    ASSERT_TRUE(GetFileSize(TEST_JOURNAL_FILE) > journalSize);
+    PolicyManager::GetInstance()->SetCoalescing(0, 0);
+}
+
+/**
+ * @tc.name: TestGetAdminByPolicyNameView
+ * @tc.desc: Test PolicyManager GetAdminByPolicyName func returning shared values.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PolicyManagerTest, TestGetAdminByPolicyNameView, TestSize.Level1)
+{
+    ErrCode res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, "false", "true");
+    ASSERT_TRUE(res == ERR_OK);
+    AdminValueViewMap adminValueViews;
+    res = PolicyManager::GetInstance()->GetAdminByPolicyName(TEST_BOOL_POLICY_NAME, adminValueViews);
+    ASSERT_TRUE(res == ERR_OK);
+    auto entry = adminValueViews.find(TEST_ADMIN_NAME);
+    ASSERT_TRUE(entry != adminValueViews.end() && *entry->second == "false");
+
+    res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, "true", "true");
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(*entry->second == "false");
+    AdminValueViewMap newAdminValueViews;
+    res = PolicyManager::GetInstance()->GetAdminByPolicyName(TEST_BOOL_POLICY_NAME, newAdminValueViews);
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(*newAdminValueViews[TEST_ADMIN_NAME] == "true");
+}
+
+/**
+ * @tc.name: TestGetPolicyConcurrentSet
+ * @tc.desc: Test PolicyManager GetPolicy func never sees a half applied SetPolicy.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PolicyManagerTest, TestGetPolicyConcurrentSet, TestSize.Level1)
+{
+    ErrCode res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME, TEST_STRING_POLICY_NAME, "0", "0");
+    ASSERT_TRUE(res == ERR_OK);
+    std::thread writer([]() {
+        for (int i = 1; i <= TEST_CONCURRENT_SET_NUM; ++i) {
+            PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME, TEST_STRING_POLICY_NAME, std::to_string(i),
+                std::to_string(i));
+        }
+    });
+    int lastValue = 0;
+    bool ordered = true;
+    while (lastValue < TEST_CONCURRENT_SET_NUM && ordered) {
+        std::string adminValue;
+        std::string mergedValue;
+        PolicyManager::GetInstance()->GetPolicy("", TEST_STRING_POLICY_NAME, mergedValue);
+        PolicyManager::GetInstance()->GetPolicy(TEST_ADMIN_NAME, TEST_STRING_POLICY_NAME, adminValue);
+        /* the merged value is read first, the admin value can only be the same or newer */
+        ordered = std::stoi(mergedValue) >= lastValue && std::stoi(adminValue) >= std::stoi(mergedValue);
+        lastValue = std::stoi(mergedValue);
+    }
+    writer.join();
+    ASSERT_TRUE(ordered);
+}
+
+/**
+ * @tc.name: TestLazyLoadPolicy
+ * @tc.desc: Test PolicyManager with the lazy load of PolicyFileStore.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PolicyManagerTest, TestLazyLoadPolicy, TestSize.Level1)
+{
+    ErrCode res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, "false", "true");
+    ASSERT_TRUE(res == ERR_OK);
+    res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME1, TEST_BOOL_POLICY_NAME, "true", "true");
+    ASSERT_TRUE(res == ERR_OK);
+    /* import writes the policies to the snapshot file, so the admins are not decoded by the next Init */
+    ASSERT_TRUE(PolicyManager::GetInstance()->ExportPolicyJson(TEST_EXPORT_JSON_FILE) == ERR_OK);
+    ASSERT_TRUE(PolicyManager::GetInstance()->ImportPolicyJson(TEST_EXPORT_JSON_FILE) == ERR_OK);
+    CmdUtils::ExecCmdSync("rm " + TEST_EXPORT_JSON_FILE);
+    auto policyStore = std::make_shared<PolicyFileStore>();
+    policyStore->SetLazyLoad(true);
+    PolicyManager::GetInstance()->SetPolicyStore(policyStore);
+    PolicyManager::GetInstance()->Init();
+
+    std::string policyValue;
+    res = PolicyManager::GetInstance()->GetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, policyValue);
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(policyValue == "false");
+    PolicyItemsMap policyItems;
+    res = PolicyManager::GetInstance()->GetAllPolicyByAdmin(TEST_ADMIN_NAME1, policyItems);
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(policyItems[TEST_BOOL_POLICY_NAME] == "true");
+
+    res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME, TEST_STRING_POLICY_NAME, "[\"a\"]", "[\"a\"]");
+    ASSERT_TRUE(res == ERR_OK);
+    res = PolicyManager::GetInstance()->GetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, policyValue);
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(policyValue == "false");
+
+    AdminValueItemsMap adminValueItems;
+    res = PolicyManager::GetInstance()->GetAdminByPolicyName(TEST_BOOL_POLICY_NAME, adminValueItems);
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(adminValueItems.size() == 2);
+    PolicyManager::GetInstance()->SetPolicyStore(std::make_shared<PolicyFileStore>());
+    PolicyManager::GetInstance()->Init();
+}
+
+/**
+ * @tc.name: TestPolicyGeneration
+ * @tc.desc: Test PolicyManager GetPolicy func with the generation.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PolicyManagerTest, TestPolicyGeneration, TestSize.Level1)
+{
+    std::string policyValue;
+    std::uint64_t combinedGeneration = 0;
+    PolicyManager::GetInstance()->GetPolicy("", TEST_BOOL_POLICY_NAME, policyValue, combinedGeneration);
+    ASSERT_TRUE(combinedGeneration != 0);
+    std::uint64_t adminGeneration = 0;
+    PolicyManager::GetInstance()->GetPolicy(TEST_ADMIN_NAME1, TEST_BOOL_POLICY_NAME, policyValue, adminGeneration);
+
+    ErrCode res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, "false", "true");
+    ASSERT_TRUE(res == ERR_OK);
+    std::uint64_t generation = 0;
+    res = PolicyManager::GetInstance()->GetPolicy("", TEST_BOOL_POLICY_NAME, policyValue, generation);
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(policyValue == "true");
+    ASSERT_TRUE(generation > combinedGeneration);
+    combinedGeneration = generation;
+    res = PolicyManager::GetInstance()->GetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, policyValue, generation);
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(generation == combinedGeneration);
+    /* the policies of the other admins keep their generation */
+    PolicyManager::GetInstance()->GetPolicy(TEST_ADMIN_NAME1, TEST_BOOL_POLICY_NAME, policyValue, generation);
+    ASSERT_TRUE(generation == adminGeneration);
+
+    /* the value survives a restart, the generation of a new start differs */
+    PolicyManager::GetInstance()->Init();
+    res = PolicyManager::GetInstance()->GetPolicy("", TEST_BOOL_POLICY_NAME, policyValue, generation);
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(policyValue == "true");
+    ASSERT_TRUE(generation != combinedGeneration);
+    combinedGeneration = generation;
+
+    res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, "", "");
+    ASSERT_TRUE(res == ERR_OK);
+    res = PolicyManager::GetInstance()->GetPolicy("", TEST_BOOL_POLICY_NAME, policyValue, generation);
+    ASSERT_TRUE(res != ERR_OK);
+    ASSERT_TRUE(generation > combinedGeneration);
+}
+
+/**
+ * @tc.name: TestPolicyGenerationLostWrites
+ * @tc.desc: Test PolicyManager doesn't hand out a generation again after the changes not written are lost.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PolicyManagerTest, TestPolicyGenerationLostWrites, TestSize.Level1)
+{
+    auto store = std::make_shared<LossyPolicyStore>();
+    PolicyManager::GetInstance()->SetPolicyStore(store);
+    PolicyManager::GetInstance()->Init();
+    ErrCode res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, "false", "false");
+    ASSERT_TRUE(res == ERR_OK);
+
+    /* the change is published but never reaches the storage, as if the device lost power */
+    store->SetLossy(true);
+    res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, "true", "true");
+    ASSERT_TRUE(res == ERR_OK);
+    std::string policyValue;
+    std::uint64_t lostGeneration = 0;
+    PolicyManager::GetInstance()->GetPolicy("", TEST_BOOL_POLICY_NAME, policyValue, lostGeneration);
+    ASSERT_TRUE(policyValue == "true");
+
+    /* the lost change takes the sequence of the next one after the restart, not its generation */
+    PolicyManager::GetInstance()->Init();
+    store->SetLossy(false);
+    std::uint64_t generation = 0;
+    PolicyManager::GetInstance()->GetPolicy("", TEST_BOOL_POLICY_NAME, policyValue, generation);
+    ASSERT_TRUE(policyValue == "false");
+    ASSERT_TRUE(generation != lostGeneration);
+    res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, "", "");
+    ASSERT_TRUE(res == ERR_OK);
+    res = PolicyManager::GetInstance()->GetPolicy("", TEST_BOOL_POLICY_NAME, policyValue, generation);
+    ASSERT_TRUE(res != ERR_OK);
+    ASSERT_TRUE(generation != lostGeneration);
+
+    PolicyManager::GetInstance()->SetPolicyStore(std::make_shared<PolicyFileStore>());
+    PolicyManager::GetInstance()->Init();
+}
+
+/**
+ * @tc.name: TestPersistWorker
+ * @tc.desc: Test PolicyManager persistence worker, SetDurableWrite and GetPersistStats func.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PolicyManagerTest, TestPersistWorker, TestSize.Level1)
+{
+    auto policyStore = std::make_shared<SlowPolicyStore>();
+    PolicyManager::GetInstance()->SetPolicyStore(policyStore);
+    PolicyManager::GetInstance()->Init();
+    PolicyManager::GetInstance()->SetCoalescing(TEST_QUIET_WINDOW_MS, TEST_QUIET_WINDOW_MS);
+    PolicyPersistStats stats;
+    PolicyManager::GetInstance()->GetPersistStats(stats);
+    std::uint64_t flushCount = stats.flushCount;
+    /* more changes than the queue holds twice, the writer fills the queue again while the worker writes */
+    for (int i = 0; i < TEST_PERSIST_QUEUE_OVERFLOW_NUM; ++i) {
+        ErrCode res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME, TEST_STRING_POLICY_NAME,
+            std::to_string(i), std::to_string(i));
+        ASSERT_TRUE(res == ERR_OK);
+    }
+    ASSERT_TRUE(PolicyManager::GetInstance()->Flush() == ERR_OK);
+    PolicyManager::GetInstance()->GetPersistStats(stats);
+    ASSERT_TRUE(stats.queueDepth == 0);
+    ASSERT_TRUE(stats.backpressureCount > 0);
+    ASSERT_TRUE(stats.flushCount >= flushCount + 2);
+    ASSERT_TRUE(policyStore->GetDeltaCount() == TEST_PERSIST_QUEUE_OVERFLOW_NUM);
+
+    PolicyManager::GetInstance()->SetDurableWrite(true);
+    ErrCode res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, "false", "true");
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(policyStore->GetDeltaCount() == TEST_PERSIST_QUEUE_OVERFLOW_NUM + 1);
+    PolicyManager::GetInstance()->SetDurableWrite(false);
+    PolicyManager::GetInstance()->SetCoalescing(0, 0);
+    PolicyManager::GetInstance()->SetPolicyStore(std::make_shared<PolicyFileStore>());
+    PolicyManager::GetInstance()->Init();
+}
+
+/**
+ * @tc.name: TestShardedLayout
+ * @tc.desc: Test PolicyManager with the sharded layout of PolicyFileStore and the migration between the layouts.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PolicyManagerTest, TestShardedLayout, TestSize.Level1)
+{
+    ErrCode res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, "false", "true");
+    ASSERT_TRUE(res == ERR_OK);
+    auto policyStore = std::make_shared<PolicyFileStore>();
+    policyStore->SetShardedLayout(true);
+    PolicyManager::GetInstance()->SetPolicyStore(policyStore);
+    PolicyManager::GetInstance()->Init();
+    ASSERT_TRUE(access(TEST_SHARD_MANIFEST_FILE.c_str(), F_OK) == 0);
+    ASSERT_TRUE(access(TEST_SNAPSHOT_FILE.c_str(), F_OK) != 0);
+
+    /* without the journal a change of one admin only rewrites the file of the admin and the combined file */
+    PolicyManager::GetInstance()->SetJournalEnabled(false);
+    res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME1, TEST_BOOL_POLICY_NAME, "true", "true");
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(access(TEST_SHARD_ADMIN_FILE.c_str(), F_OK) == 0);
+    PolicyManager::GetInstance()->Init();
+    std::string policyValue;
+    res = PolicyManager::GetInstance()->GetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, policyValue);
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(policyValue == "false");
+    res = PolicyManager::GetInstance()->GetPolicy(TEST_ADMIN_NAME1, TEST_BOOL_POLICY_NAME, policyValue);
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(policyValue == "true");
+
+    /* deleting the last policy of an admin removes its file */
+    res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME1, TEST_BOOL_POLICY_NAME, "", "true");
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(access(TEST_SHARD_ADMIN_FILE.c_str(), F_OK) != 0);
+    PolicyManager::GetInstance()->SetJournalEnabled(true);
+
+    PolicyManager::GetInstance()->SetPolicyStore(std::make_shared<PolicyFileStore>());
+    PolicyManager::GetInstance()->Init();
+    ASSERT_TRUE(access(TEST_SNAPSHOT_FILE.c_str(), F_OK) == 0);
+    ASSERT_TRUE(access(TEST_SHARD_MANIFEST_FILE.c_str(), F_OK) != 0);
+    res = PolicyManager::GetInstance()->GetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, policyValue);
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(policyValue == "false");
+    res = PolicyManager::GetInstance()->GetPolicy(TEST_ADMIN_NAME1, TEST_BOOL_POLICY_NAME, policyValue);
+    ASSERT_TRUE(res != ERR_OK);
+}
+
+/**
+ * @tc.name: TestMemoryStore
+ * @tc.desc: Test PolicyManager SetPolicyStore func with PolicyMemoryStore.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PolicyManagerTest, TestMemoryStore, TestSize.Level1)
+{
+    PolicyManager::GetInstance()->SetPolicyStore(std::make_shared<PolicyMemoryStore>());
+    PolicyManager::GetInstance()->Init();
+    off_t journalSize = GetFileSize(TEST_JOURNAL_FILE);
+    ErrCode res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, "false", "true");
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(PolicyManager::GetInstance()->Flush() == ERR_OK);
+    ASSERT_TRUE(PolicyManager::GetInstance()->GetPersistedBytes() == 0);
+    ASSERT_TRUE(GetFileSize(TEST_JOURNAL_FILE) == journalSize);
+
+    /* the policies are loaded again from the memory store */
+    PolicyManager::GetInstance()->Init();
+    std::string policyValue;
+    res = PolicyManager::GetInstance()->GetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, policyValue);
+    ASSERT_TRUE(res == ERR_OK);
+    ASSERT_TRUE(policyValue == "false");
+    res = PolicyManager::GetInstance()->SetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, "", "");
+    ASSERT_TRUE(res == ERR_OK);
+
+    PolicyManager::GetInstance()->SetPolicyStore(std::make_shared<PolicyFileStore>());
+    PolicyManager::GetInstance()->Init();
+}
+
+/**
+ * @tc.name: TestPolicyTransaction
+ * @tc.desc: Test PolicyTransaction SetPolicy, Commit and Abort func.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PolicyManagerTest, TestPolicyTransaction, TestSize.Level1)
+{
+    std::shared_ptr<PolicyManager> policyMgr = PolicyManager::GetInstance();
+    std::string policyValue;
+    {
+        PolicyTransaction transaction(policyMgr);
+        ASSERT_TRUE(transaction.SetPolicy(TEST_ADMIN_NAME, "", "false", "true") != ERR_OK);
+        ASSERT_TRUE(transaction.SetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, "false", "true") == ERR_OK);
+        ASSERT_TRUE(transaction.GetSize() == 1);
+        /* the transaction is aborted when it is destroyed */
+    }
+    ASSERT_TRUE(policyMgr->GetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, policyValue) != ERR_OK);
+
+    PolicyTransaction transaction(policyMgr);
+    ASSERT_TRUE(transaction.SetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, "false", "true") == ERR_OK);
+    ASSERT_TRUE(transaction.SetPolicy(TEST_ADMIN_NAME, TEST_STRING_POLICY_NAME, "\"edm\"", "\"edm\"") == ERR_OK);
+    /* the staged changes are not visible before the commit */
+    ASSERT_TRUE(policyMgr->GetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, policyValue) != ERR_OK);
+    std::uint64_t persistedBytes = policyMgr->GetPersistedBytes();
+    ASSERT_TRUE(transaction.Commit() == ERR_OK);
+    ASSERT_TRUE(transaction.GetSize() == 0);
+    ASSERT_TRUE(policyMgr->GetPersistedBytes() > persistedBytes);
+    std::uint64_t boolGeneration = 0;
+    std::uint64_t stringGeneration = 0;
+    ASSERT_TRUE(policyMgr->GetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, policyValue, boolGeneration) == ERR_OK);
+    ASSERT_TRUE(policyValue == "false");
+    ASSERT_TRUE(policyMgr->GetPolicy("", TEST_STRING_POLICY_NAME, policyValue, stringGeneration) == ERR_OK);
+    ASSERT_TRUE(policyValue == "\"edm\"");
+    ASSERT_TRUE(stringGeneration == boolGeneration + 1);
+
+    /* the committed changes survive a restart */
+    policyMgr->Init();
+    ASSERT_TRUE(policyMgr->GetPolicy(TEST_ADMIN_NAME, TEST_STRING_POLICY_NAME, policyValue) == ERR_OK);
+    ASSERT_TRUE(policyValue == "\"edm\"");
+
+    ASSERT_TRUE(transaction.SetPolicy(TEST_ADMIN_NAME, TEST_BOOL_POLICY_NAME, "", "") == ERR_OK);
+    ASSERT_TRUE(transaction.SetPolicy(TEST_ADMIN_NAME, TEST_STRING_POLICY_NAME, "", "") == ERR_OK);
+    ASSERT_TRUE(transaction.Commit() == ERR_OK);
+    PolicyItemsMap allAdminPolicy;
+    policyMgr->GetAllPolicyByAdmin(TEST_ADMIN_NAME, allAdminPolicy);
+    ASSERT_TRUE(allAdminPolicy.find(TEST_BOOL_POLICY_NAME) == allAdminPolicy.end());
+    ASSERT_TRUE(allAdminPolicy.find(TEST_STRING_POLICY_NAME) == allAdminPolicy.end());
+}
 } // namespace TEST
 } // namespace EDM
 } // namespace OHOS
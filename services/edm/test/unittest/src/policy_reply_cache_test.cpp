@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "policy_reply_cache.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+namespace EDM {
+namespace TEST {
+constexpr std::uint32_t TEST_POLICY_CODE = 1;
+constexpr std::uint32_t TEST_OTHER_POLICY_CODE = 2;
+constexpr std::size_t TEST_REPLY_SIZE = 4;
+constexpr std::uint64_t TEST_POLICY_GENERATION = 7;
+
+class PolicyReplyCacheTest : public testing::Test {
+protected:
+    PolicyReply MakeReply(std::uint8_t value)
+    {
+        return std::make_shared<std::vector<std::uint8_t>>(TEST_REPLY_SIZE, value);
+    }
+};
+
+/**
+ * @tc.name: TestPutAndGet
+ * @tc.desc: Test PolicyReplyCache returns the reply put with the current generation.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PolicyReplyCacheTest, TestPutAndGet, TestSize.Level1)
+{
+    PolicyReplyCache cache;
+    PolicyReply reply;
+    std::uint64_t policyGeneration = 0;
+    std::uint64_t generation = cache.Get(TEST_POLICY_CODE, reply, policyGeneration);
+    ASSERT_TRUE(reply == nullptr);
+    ASSERT_TRUE(cache.Put(TEST_POLICY_CODE, generation, TEST_POLICY_GENERATION, MakeReply(1)));
+
+    ASSERT_TRUE(cache.Get(TEST_POLICY_CODE, reply, policyGeneration) == generation);
+    ASSERT_TRUE(reply != nullptr);
+    ASSERT_TRUE(reply->size() == TEST_REPLY_SIZE);
+    /* the generation of the encoded policy is kept with the reply for the conditional requests */
+    ASSERT_TRUE(policyGeneration == TEST_POLICY_GENERATION);
+    ASSERT_TRUE(cache.GetHitCount() == 1);
+    ASSERT_TRUE(cache.GetMissCount() == 1);
+
+    cache.Get(TEST_OTHER_POLICY_CODE, reply, policyGeneration);
+    ASSERT_TRUE(reply == nullptr);
+}
+
+/**
+ * @tc.name: TestInvalidate
+ * @tc.desc: Test PolicyReplyCache drops the reply encoded before the policy was invalidated.
+ * @tc.type: FUNC
+ */
+HWTEST_F(PolicyReplyCacheTest, TestInvalidate, TestSize.Level1)
+{
+    PolicyReplyCache cache;
+    PolicyReply reply;
+    std::uint64_t policyGeneration = 0;
+    std::uint64_t generation = cache.Get(TEST_POLICY_CODE, reply, policyGeneration);
+    ASSERT_TRUE(cache.Put(TEST_POLICY_CODE, generation, TEST_POLICY_GENERATION, MakeReply(1)));
+    cache.Invalidate(TEST_POLICY_CODE);
+    cache.Get(TEST_POLICY_CODE, reply, policyGeneration);
+    ASSERT_TRUE(reply == nullptr);
+
+    /* the policy is changed while the reply of the old value is encoded */
+    generation = cache.Get(TEST_POLICY_CODE, reply, policyGeneration);
+    cache.Invalidate(TEST_POLICY_CODE);
+    ASSERT_FALSE(cache.Put(TEST_POLICY_CODE, generation, TEST_POLICY_GENERATION, MakeReply(2)));
+    cache.Get(TEST_POLICY_CODE, reply, policyGeneration);
+    ASSERT_TRUE(reply == nullptr);
+
+    generation = cache.Get(TEST_POLICY_CODE, reply, policyGeneration);
+    ASSERT_TRUE(cache.Put(TEST_POLICY_CODE, generation, TEST_POLICY_GENERATION, MakeReply(3)));
+    cache.Clear();
+    cache.Get(TEST_POLICY_CODE, reply, policyGeneration);
+    ASSERT_TRUE(reply == nullptr);
+}
+} // namespace TEST
+} // namespace EDM
+} // namespace OHOS
@@ -13,10 +13,14 @@
  * limitations under the License.
  */
 
+#include <chrono>
 #include <gtest/gtest.h>
 #include <ipc_skeleton.h>
+#include <mutex>
+#include <thread>
 #include "edm_log.h"
 #include "func_code_utils.h"
+#include "lock_stats.h"
 
 using namespace testing::ext;
 using namespace OHOS::EDM;
@@ -146,6 +150,38 @@ HWTEST_F(UtilsTest, Test_ArrayPolicyUtils_RemovePolicy_002, TestSize.Level1)
     ArrayPolicyUtils::RemovePolicy(removeData, data);
     ASSERT_TRUE(data.size() == 2);
 }
+
+/**
+ * @tc.name: Test_LockStats_Acquire
+ * @tc.desc: Test LockStats::Acquire counts the contended acquisitions.
+ * @tc.type: FUNC
+ */
+HWTEST_F(UtilsTest, Test_LockStats_Acquire, TestSize.Level1)
+{
+    LockStats stats("test");
+    std::mutex mutex;
+    {
+        std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+        stats.Acquire(lock);
+        ASSERT_TRUE(lock.owns_lock());
+    }
+    ASSERT_EQ(stats.GetAcquireCount(), 1);
+    ASSERT_EQ(stats.GetContendedCount(), 0);
+
+    std::unique_lock<std::mutex> holder(mutex);
+    std::thread waiter([&stats, &mutex]() {
+        std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+        stats.Acquire(lock);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    holder.unlock();
+    waiter.join();
+    ASSERT_EQ(stats.GetAcquireCount(), 2);
+    ASSERT_EQ(stats.GetContendedCount(), 1);
+
+    stats.Reset();
+    ASSERT_EQ(stats.GetAcquireCount(), 0);
+}
 } // namespace TEST
 } // namespace EDM
 } // namespace OHOS
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# Copyright (c) 2022 Huawei Device Co., Ltd.
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Merges the descriptors of the edm plugin libraries into the plugin index read by the PluginManager."""
+
+import argparse
+import json
+import sys
+
+MAX_POLICY_CODE = 0xFFFF
+
+
+def load_descriptor(path, codes, names):
+    with open(path, 'r', encoding='utf-8') as descriptor_file:
+        descriptor = json.load(descriptor_file)
+    library = descriptor['library']
+    for policy in descriptor['policies']:
+        code = policy['code']
+        name = policy['name']
+        if not isinstance(code, int) or code < 0 or code > MAX_POLICY_CODE:
+            raise ValueError('invalid policy code {} of {}'.format(code, library))
+        if code in codes:
+            raise ValueError('policy code {} of {} is registered by {}'.format(code, library, codes[code]))
+        if name in names:
+            raise ValueError('policy name {} of {} is registered by {}'.format(name, library, names[name]))
+        codes[code] = library
+        names[name] = library
+    return descriptor
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--output', required=True)
+    parser.add_argument('--descriptors', nargs='*', default=[])
+    args = parser.parse_args()
+
+    codes = {}
+    names = {}
+    try:
+        plugins = [load_descriptor(path, codes, names) for path in args.descriptors]
+    except (OSError, KeyError, ValueError) as error:
+        print('gen_plugin_index: {}'.format(error), file=sys.stderr)
+        return 1
+    with open(args.output, 'w', encoding='utf-8') as index_file:
+        json.dump({'plugins': plugins}, index_file, indent=4)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -14,6 +14,7 @@
  */
 
 #include "set_datetime_plugin.h"
+#include "device_settings_plugin_descriptor.h"
 #include "long_serializer.h"
 #include "plugin_manager.h"
 #include "policy_info.h"
@@ -26,9 +27,11 @@ const bool REGISTER_RESULT = PluginManager::GetInstance()->AddPlugin(SetDateTime
 void SetDateTimePlugin::InitPlugin(std::shared_ptr<IPluginTemplate<SetDateTimePlugin, int64_t>> ptr)
 {
     EDMLOGD("SetDateTimePlugin InitPlugin...");
-    std::string policyName;
-    POLICY_CODE_TO_NAME(SET_DATETIME, policyName);
-    ptr->InitAttribute(SET_DATETIME, policyName, "ohos.permission.EDM_MANAGE_DATETIME", false);
+    /* the attributes are generated from edm_policies in BUILD.gn, the same source as the plugin index */
+    static_assert(PluginDescriptor::set_datetime::CODE == SET_DATETIME, "code differs from policy_info.h");
+    ptr->InitAttribute(PluginDescriptor::set_datetime::CODE, PluginDescriptor::set_datetime::NAME,
+        PluginDescriptor::set_datetime::PERMISSION, PluginDescriptor::set_datetime::NEED_SAVE,
+        PluginDescriptor::set_datetime::GLOBAL);
     ptr->SetSerializer(LongSerializer::GetInstance());
     ptr->SetOnHandlePolicyListener(&SetDateTimePlugin::OnSetPolicy, FuncOperateType::SET);
 }